@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace logixpr {
@@ -23,6 +25,29 @@ public:
     virtual std::string toString() const = 0;
     virtual std::unique_ptr<ASTNode> clone() const = 0;
     virtual bool equals(const ASTNode& other) const = 0;
+
+    // Subtree metadata, filled in by each constructor from the children's
+    // cached values. Nodes are immutable once built, so a rewrite that
+    // rebuilds the path to a replaced subtree recomputes only that path.
+    // (The take* members leave the donor node's metadata stale; they exist
+    // only to dismantle nodes that are about to be destroyed.)
+    std::size_t getSize() const;
+    // Edges on the longest path to a leaf; 0 for variables and constants
+    std::size_t getHeight() const;
+    // Equal for trees that differ only in the operand order of AND/OR
+    std::size_t getHash() const;
+    // One bit per variable name (names hash onto 64 bits, so two variables
+    // can share one); a bit set on one side only proves the sets differ
+    std::uint64_t getVariableMask() const;
+    // Bit 1 << NodeType for every node type occurring in the subtree
+    std::uint32_t getTypeMask() const;
+
+protected:
+    std::uint32_t size = 1;
+    std::uint32_t height = 0;
+    std::uint32_t type_mask = 0;
+    std::uint64_t variable_mask = 0;
+    std::size_t hash = 0;
 };
 
 class VariableNode : public ASTNode {
@@ -58,6 +83,7 @@ private:
 
 public:
     UnaryOpNode(NodeType op_type, std::unique_ptr<ASTNode> operand);
+    ~UnaryOpNode() override;
     NodeType getType() const override;
     std::string toString() const override;
     std::unique_ptr<ASTNode> clone() const override;
@@ -74,6 +100,7 @@ private:
 
 public:
     BinaryOpNode(NodeType op_type, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right);
+    ~BinaryOpNode() override;
     NodeType getType() const override;
     std::string toString() const override;
     std::unique_ptr<ASTNode> clone() const override;
@@ -84,4 +111,46 @@ public:
     std::unique_ptr<ASTNode> takeRight();
 };
 
+// Postorder fold with an explicit stack: leaf(node), unary(node, operand)
+// and binary(node, left, right) combine results bottom-up, so the depth of
+// the tree never shows up on the call stack
+template <typename Result, typename Leaf, typename Unary, typename Binary>
+Result foldTree(const ASTNode& root, Leaf leaf, Unary unary, Binary binary) {
+    struct Frame {
+        const ASTNode* node;
+        bool expanded;
+    };
+
+    std::vector<Frame> stack{{&root, false}};
+    std::vector<Result> results;
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        const ASTNode& node = *frame.node;
+        NodeType type = node.getType();
+
+        if (type == NodeType::VARIABLE || type == NodeType::CONSTANT) {
+            results.push_back(leaf(node));
+            stack.pop_back();
+        } else if (!frame.expanded) {
+            frame.expanded = true;
+            if (type == NodeType::NOT) {
+                stack.push_back({&static_cast<const UnaryOpNode&>(node).getOperand(), false});
+            } else {
+                const auto& binary_node = static_cast<const BinaryOpNode&>(node);
+                stack.push_back({&binary_node.getRight(), false});
+                stack.push_back({&binary_node.getLeft(), false});
+            }
+        } else if (type == NodeType::NOT) {
+            results.back() = unary(static_cast<const UnaryOpNode&>(node), std::move(results.back()));
+            stack.pop_back();
+        } else {
+            Result right = std::move(results.back());
+            results.pop_back();
+            results.back() = binary(static_cast<const BinaryOpNode&>(node), std::move(results.back()), std::move(right));
+            stack.pop_back();
+        }
+    }
+    return std::move(results.back());
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace logixpr {
+
+class BddManager;
+
+struct BddNode {
+    std::uint32_t level;
+    BddNode* low;
+    BddNode* high;
+    std::uint32_t ref_count;
+};
+
+// Reference-counted handle to a node owned by a BddManager. Two handles from
+// the same manager denote equivalent functions iff they point at the same node.
+class Bdd {
+private:
+    BddManager* manager;
+    BddNode* node;
+
+public:
+    Bdd();
+    Bdd(BddManager* manager, BddNode* node);
+    Bdd(const Bdd& other);
+    Bdd(Bdd&& other) noexcept;
+    Bdd& operator=(const Bdd& other);
+    Bdd& operator=(Bdd&& other) noexcept;
+    ~Bdd();
+
+    bool operator==(const Bdd& other) const;
+    bool operator!=(const Bdd& other) const;
+
+    bool isTrue() const;
+    bool isFalse() const;
+    bool isConstant() const;
+    const BddNode* getNode() const;
+
+private:
+    friend class BddManager;
+
+    void release();
+};
+
+struct BddHasher {
+    std::size_t operator()(const Bdd& bdd) const;
+};
+
+class BddManager {
+private:
+    struct NodeKey {
+        std::uint32_t level;
+        BddNode* low;
+        BddNode* high;
+        bool operator==(const NodeKey& other) const;
+    };
+
+    struct NodeKeyHasher {
+        std::size_t operator()(const NodeKey& key) const;
+    };
+
+    struct IteKey {
+        BddNode* f;
+        BddNode* g;
+        BddNode* h;
+        bool operator==(const IteKey& other) const;
+    };
+
+    struct IteKeyHasher {
+        std::size_t operator()(const IteKey& key) const;
+    };
+
+    std::deque<BddNode> storage;
+    std::vector<BddNode*> free_nodes;
+    std::unordered_map<NodeKey, BddNode*, NodeKeyHasher> unique_table;
+    std::unordered_map<IteKey, BddNode*, IteKeyHasher> computed_cache;
+    std::vector<std::string> variable_order;
+    std::unordered_map<std::string, std::uint32_t> variable_levels;
+    BddNode* false_node;
+    BddNode* true_node;
+    std::size_t gc_threshold;
+
+public:
+    static constexpr std::uint32_t TERMINAL_LEVEL = 0xFFFFFFFFu;
+
+    BddManager();
+    explicit BddManager(const std::vector<std::string>& variable_order);
+    BddManager(const BddManager&) = delete;
+    BddManager& operator=(const BddManager&) = delete;
+
+    static std::vector<std::string> orderVariables(const std::vector<const ASTNode*>& expressions);
+
+    Bdd constant(bool value);
+    Bdd variable(const std::string& name);
+    Bdd build(const ASTNode& expression);
+
+    Bdd ite(const Bdd& f, const Bdd& g, const Bdd& h);
+    Bdd negate(const Bdd& f);
+    Bdd conjunction(const Bdd& f, const Bdd& g);
+    Bdd disjunction(const Bdd& f, const Bdd& g);
+    Bdd implication(const Bdd& f, const Bdd& g);
+    Bdd biconditional(const Bdd& f, const Bdd& g);
+    // Cofactor by the variable at level, which must not lie below f's top
+    // variable; functions independent of it are returned unchanged
+    Bdd cofactor(const Bdd& f, std::uint32_t level, bool value);
+
+    bool evaluate(const Bdd& f, const std::vector<bool>& assignment) const;
+
+    const std::vector<std::string>& getVariableOrder() const;
+    std::uint32_t levelOf(const std::string& name);
+
+    std::size_t nodeCount() const;
+    std::size_t collectGarbage();
+
+private:
+    friend class Bdd;
+
+    BddNode* makeNode(std::uint32_t level, BddNode* low, BddNode* high);
+    BddNode* iteNode(BddNode* f, BddNode* g, BddNode* h);
+    BddNode* cofactor(BddNode* node, std::uint32_t level, bool value) const;
+    void maybeCollectGarbage();
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ast.h"
+#include "flat_expr.h"
+#include "proof_search.h"
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace logixpr {
+
+// Layout (all integers are unsigned LEB128 varints unless noted):
+//
+//   header      "LXPB" version:u8
+//   record      tag:u8 payload
+//     VARIABLE    name_length name_bytes        -- defines the next variable id
+//     EXPRESSION  expression
+//     PROOF       flags:u8 step_count {law step_number description expression}
+//                 counterexample_count {variable_id value:u8}
+//   expression  node_count {type:u8 [value]}    -- FlatExpression postorder
+//
+// Proof flags are 1 for a found target and 2 for a refutation.
+// A node value is the variable id, the constant, or for binary nodes the
+// distance back to the left child, so a record can be walked in place;
+// negations carry no value.
+// Variables are defined once, just before the first record that uses them,
+// which lets both sides stream without a global symbol table up front.
+class FormatError : public std::exception {
+private:
+    std::string message;
+    std::size_t offset;
+
+public:
+    FormatError(const std::string& msg, std::size_t offset);
+    const char* what() const noexcept override;
+    std::size_t getOffset() const;
+};
+
+enum class RecordType {
+    EXPRESSION,
+    PROOF,
+    END
+};
+
+class BinaryWriter {
+private:
+    std::ostream& out;
+    VariableTable variables;
+    std::string buffer;
+
+public:
+    static const std::uint8_t VERSION = 1;
+
+    // Writes the header immediately
+    explicit BinaryWriter(std::ostream& out);
+
+    void writeExpression(const ASTNode& expression);
+    void writeExpression(const FlatExpression& expression, const VariableTable& expression_variables);
+    void writeProof(const Proof& proof);
+
+private:
+    void defineNewVariables(std::size_t first_new);
+    void encodeExpression(const FlatExpression& expression);
+    void flush();
+};
+
+// Reads from a caller-owned byte range (for example an mmap'd file, which is
+// never copied) or pulls bytes from a stream one record at a time.
+class BinaryReader {
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::istream* in;
+    std::size_t offset;
+    VariableTable variables;
+    int pending_tag;
+
+public:
+    BinaryReader(const std::uint8_t* data, std::size_t size);
+    explicit BinaryReader(std::istream& in);
+
+    // Consumes variable definitions and reports what the next record is
+    RecordType next();
+
+    std::unique_ptr<ASTNode> readExpression();
+    // Variable ids refer to getVariables()
+    FlatExpression readFlatExpression();
+    Proof readProof();
+
+    const VariableTable& getVariables() const;
+    std::size_t getOffset() const;
+
+private:
+    void readHeader();
+    bool atEnd();
+    std::uint8_t readByte();
+    std::uint64_t readVarint();
+    std::string readString();
+    void expectRecord(RecordType type);
+    FlatExpression decodeExpression();
+};
+
+}
\ No newline at end of file
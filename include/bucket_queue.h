@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace logixpr {
+
+// Priority queue for small non-negative integer keys: one FIFO bucket per
+// key, so push and pop are O(1) and equal keys pop in insertion order.
+// Keys are meant to be mostly monotone (depth plus heuristic, cumulative
+// cost); a key below the current minimum is allowed and simply moves the
+// cursor back. Pop scans upward past empty buckets, which costs at most the
+// key range in total between two such moves.
+template <typename T>
+class BucketQueue {
+private:
+    struct Bucket {
+        std::vector<T> items;
+        std::size_t head = 0;
+
+        bool empty() const {
+            return head == items.size();
+        }
+    };
+
+    std::vector<Bucket> buckets;
+    std::size_t lowest = 0;
+    std::size_t count = 0;
+
+public:
+    void push(std::size_t key, T value) {
+        if (key >= buckets.size()) {
+            buckets.resize(key + 1);
+        }
+        buckets[key].items.push_back(std::move(value));
+        if (count == 0 || key < lowest) {
+            lowest = key;
+        }
+        ++count;
+    }
+
+    // Removes and returns the earliest pushed value with the smallest key
+    T pop() {
+        if (count == 0) {
+            throw std::out_of_range("pop from empty BucketQueue");
+        }
+        Bucket& bucket = buckets[lowest];
+        T value = std::move(bucket.items[bucket.head++]);
+        if (bucket.empty()) {
+            // Reuse the bucket's storage rather than letting a drained prefix grow
+            bucket.items.clear();
+            bucket.head = 0;
+        }
+        if (--count > 0) {
+            while (buckets[lowest].empty()) {
+                ++lowest;
+            }
+        }
+        return value;
+    }
+
+    const T& top() const {
+        if (count == 0) {
+            throw std::out_of_range("top of empty BucketQueue");
+        }
+        const Bucket& bucket = buckets[lowest];
+        return bucket.items[bucket.head];
+    }
+
+    std::size_t topKey() const {
+        return lowest;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    void clear() {
+        buckets.clear();
+        lowest = 0;
+        count = 0;
+    }
+};
+
+}
\ No newline at end of file
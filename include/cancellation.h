@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace logixpr {
+
+// Copies share one flag, so a caller can keep a token and cancel work that
+// was handed a copy. Searches poll it between expansions and stop early.
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+
+public:
+    CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() {
+        flag->store(true, std::memory_order_relaxed);
+    }
+
+    bool isCancelled() const {
+        return flag->load(std::memory_order_relaxed);
+    }
+};
+
+}
\ No newline at end of file
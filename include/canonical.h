@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ast.h"
+#include "proof_search.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace logixpr {
+
+// A bijection between the variables of a problem and the canonical names
+// v0, v1, ... Laws never look at variable names, so a proof of the renamed
+// problem maps back to a proof of the original one step for step.
+class VariableRenaming {
+private:
+    std::vector<std::string> originals;
+    std::unordered_map<std::string, std::size_t> canonical_ids;
+
+public:
+    // Numbers variables in order of first appearance, left to right
+    void assign(const ASTNode& expression);
+
+    std::unique_ptr<ASTNode> toCanonical(const ASTNode& expression) const;
+    std::unique_ptr<ASTNode> toOriginal(const ASTNode& expression) const;
+    Proof toOriginal(const Proof& proof) const;
+
+    std::size_t size() const;
+    const std::string& getOriginalName(std::size_t id) const;
+
+    static std::string canonicalName(std::size_t id);
+};
+
+// Labels the variables of both sides jointly: first appearance in start,
+// then in target. Two pairs that differ only by a renaming of variables get
+// identical canonical expressions and keys.
+struct CanonicalPair {
+    std::unique_ptr<ASTNode> start;
+    std::unique_ptr<ASTNode> target;
+    VariableRenaming renaming;
+    std::string key;
+};
+
+CanonicalPair canonicalizePair(const ASTNode& start_expression, const ASTNode& target_expression);
+
+}
\ No newline at end of file
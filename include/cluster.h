@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ast.h"
+#include "proof_search.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace logixpr {
+
+struct EquivalenceClass {
+    // Indices into the clustered formulas, ascending
+    std::vector<std::size_t> members;
+    // The member with the fewest nodes, the earliest on ties
+    std::size_t representative;
+    // With proofs enabled, proofs[i] leads from members[i] to the
+    // representative (the representative's own is found and empty)
+    std::vector<Proof> proofs;
+};
+
+// Groups formulas by logical equivalence in time linear in the corpus.
+// Each formula is evaluated on a fixed set of pseudo-random assignments;
+// since the words for a variable depend only on its name and the seed,
+// equivalent formulas always get equal signatures. Formulas with equal
+// signatures are then split into exact classes by their BDDs, built in one
+// manager per bucket, where equivalent formulas share a node. Signatures
+// and buckets are processed on up to the configured number of executor
+// threads, and the result does not depend on it: classes are ordered by
+// their first member.
+class EquivalenceClusterer {
+private:
+    std::size_t signature_words;
+    std::size_t threads;
+    bool with_proofs;
+    std::uint64_t seed;
+    int proof_max_depth;
+    std::shared_ptr<ThreadPool> executor;
+
+public:
+    EquivalenceClusterer();
+
+    std::vector<EquivalenceClass> cluster(const std::vector<const ASTNode*>& formulas) const;
+
+    // One bit per assignment, 64 assignments per word
+    std::vector<std::uint64_t> signature(const ASTNode& formula) const;
+
+    // Words of random assignments per signature (default 4)
+    void setSignatureWords(std::size_t words);
+    // Workers, the caller included; 0 means one per executor thread (default 1)
+    void setThreads(std::size_t thread_count);
+    // nullptr selects ProofSearch's process-wide default executor
+    void setExecutor(std::shared_ptr<ThreadPool> pool);
+    // Searches a proof from every member to its representative (default off)
+    void setProofs(bool enabled);
+    void setProofMaxDepth(int depth);
+    void setSeed(std::uint64_t value);
+};
+
+}
\ No newline at end of file
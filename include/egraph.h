@@ -0,0 +1,131 @@
+#pragma once
+
+#include "ast.h"
+#include "flat_expr.h"
+#include "logic_laws.h"
+#include "proof_search.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace logixpr {
+
+struct ENode {
+    NodeType type;
+    std::uint32_t value;
+    std::uint32_t children[2];
+};
+
+struct ExplanationStep {
+    std::unique_ptr<ASTNode> expression;
+    LogicLaw law;
+    bool reversed;
+
+    ExplanationStep(std::unique_ptr<ASTNode> expr, LogicLaw law, bool reversed)
+        : expression(std::move(expr)), law(law), reversed(reversed) {}
+};
+
+// E-graph over propositional terms. Every e-node keeps the concrete children
+// it was created with, so each node denotes one concrete term; unions are
+// recorded in a proof forest that explains equalities as chains of law
+// applications.
+class EGraph {
+private:
+    struct NodeKey {
+        NodeType type;
+        std::uint32_t value;
+        std::uint32_t children[2];
+        bool operator==(const NodeKey& other) const;
+    };
+
+    struct NodeKeyHasher {
+        std::size_t operator()(const NodeKey& key) const;
+    };
+
+    enum class EdgeKind : std::uint8_t {
+        NONE,
+        CONGRUENCE,
+        RULE
+    };
+
+    struct ProofEdge {
+        std::uint32_t parent;
+        EdgeKind kind;
+        LogicLaw law;
+        bool forward;
+    };
+
+    VariableTable variables;
+    std::vector<ENode> nodes;
+    std::vector<std::uint32_t> union_find;
+    std::vector<std::vector<std::uint32_t>> members;
+    std::vector<std::vector<std::uint32_t>> parents;
+    std::vector<ProofEdge> proof_forest;
+    std::unordered_map<NodeKey, std::uint32_t, NodeKeyHasher> hashcons;
+    std::unordered_map<NodeKey, std::uint32_t, NodeKeyHasher> concrete_nodes;
+    std::vector<std::uint32_t> pending;
+    std::size_t class_count;
+
+public:
+    EGraph();
+
+    std::uint32_t addTerm(const ASTNode& term);
+    std::uint32_t add(const ENode& node);
+    std::uint32_t addVariable(const std::string& name);
+
+    std::uint32_t find(std::uint32_t id);
+    bool merge(std::uint32_t a, std::uint32_t b, LogicLaw law);
+    void rebuild();
+
+    std::size_t nodeCount() const;
+    std::size_t classCount() const;
+    std::vector<std::uint32_t> classRoots() const;
+    const std::vector<std::uint32_t>& classMembers(std::uint32_t root) const;
+    const ENode& getNode(std::uint32_t id) const;
+
+    std::unique_ptr<ASTNode> extractTerm(std::uint32_t id) const;
+    bool explain(std::uint32_t from, std::uint32_t to, std::vector<ExplanationStep>& steps, std::size_t max_steps) const;
+
+private:
+    static std::size_t arity(NodeType type);
+    NodeKey canonicalKey(const ENode& node);
+    static NodeKey concreteKey(const ENode& node);
+
+    std::uint32_t createNode(const ENode& node);
+    bool unite(std::uint32_t a, std::uint32_t b, EdgeKind kind, LogicLaw law);
+    void rerootProof(std::uint32_t id);
+    void repair(std::uint32_t root);
+
+    bool explainPath(std::uint32_t from, std::uint32_t to, std::vector<ExplanationStep>& steps, std::size_t max_steps) const;
+    bool explainEdge(std::uint32_t from, std::uint32_t to, const ProofEdge& edge, bool along_edge,
+                     std::vector<ExplanationStep>& steps, std::size_t max_steps) const;
+};
+
+// Equality saturation prover: grows an e-graph from both expressions with the
+// LogicLaw rewrite set until they share an e-class, then extracts a proof from
+// the explanation of their equality.
+class SaturationProver {
+private:
+    std::size_t node_limit;
+    std::chrono::milliseconds time_limit;
+    int iteration_limit;
+    std::size_t match_limit;
+    std::size_t explanation_limit;
+    CancellationToken cancellation;
+
+public:
+    explicit SaturationProver(std::size_t node_limit = 50000,
+                              std::chrono::milliseconds time_limit = std::chrono::milliseconds(2000));
+
+    Proof findProof(const ASTNode& start_expression, const ASTNode& target_expression);
+
+    void setNodeLimit(std::size_t limit);
+    void setTimeLimit(std::chrono::milliseconds limit);
+    void setIterationLimit(int limit);
+    void setMatchLimit(std::size_t limit);
+    void setCancellationToken(CancellationToken token);
+};
+
+}
\ No newline at end of file
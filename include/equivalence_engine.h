@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ast.h"
+#include "law_config.h"
+#include "law_table.h"
 #include "logic_laws.h"
 #include <vector>
 #include <memory>
@@ -21,27 +23,142 @@ private:
     
     using VisitedSet = std::unordered_set<std::unique_ptr<ASTNode>, ASTHasher, ASTEqual>;
     
+    LawConfiguration law_configuration;
+    
 public:
     std::vector<Transformation> generateAllTransformations(const ASTNode& expression);
     
+    std::vector<Transformation> generateSingleStepTransformations(const ASTNode& expression);
+    
     std::vector<Transformation> applyAllLaws(const ASTNode& expression);
     
     std::vector<Transformation> applyLawRecursively(const ASTNode& expression, LogicLaw law);
     
     bool areEquivalent(const ASTNode& expr1, const ASTNode& expr2);
-
-private:
-    std::vector<Transformation> applyLawToSubexpressions(const ASTNode& expression, LogicLaw law);
     
     std::unique_ptr<ASTNode> applyLawToNode(const ASTNode& node, LogicLaw law);
     
+    // Restricts and orders the laws used by generateAllTransformations and
+    // generateSingleStepTransformations; explicit per-law calls are unaffected
+    void setLawConfiguration(const LawConfiguration& configuration);
+    const LawConfiguration& getLawConfiguration() const;
+    
+    // Compile-time law selection: each call instantiates a traversal with the
+    // chosen laws' matchers inlined and every other law compiled out. The
+    // non-template members above are these instantiated with StandardLaws.
+    template <typename Laws>
+    std::vector<Transformation> generateAllTransformationsWith(const ASTNode& expression);
+    
+    template <typename Laws>
+    std::vector<Transformation> generateSingleStepTransformationsWith(const ASTNode& expression);
+    
+    template <LogicLaw Law>
+    std::vector<Transformation> applyLawRecursively(const ASTNode& expression);
+
+private:
+    std::vector<Transformation> applyLawToSubexpressions(const ASTNode& expression,
+                                                         std::vector<Transformation> first,
+                                                         std::vector<Transformation> second,
+                                                         bool combine);
+    
     std::vector<std::unique_ptr<ASTNode>> generateSubstitutions(const ASTNode& expression, 
                                                                const ASTNode& original_subexpr,
                                                                const ASTNode& new_subexpr);
+};
+
+template <typename Laws>
+std::vector<Transformation> EquivalenceEngine::generateAllTransformationsWith(const ASTNode& expression) {
+    // A law whose root type never occurs in the expression cannot fire anywhere
+    std::uint32_t present = nodeTypeMask(expression);
+    
+    std::vector<Transformation> transformations;
+    Laws::forEach([&](auto law) {
+        if (!(present & nodeTypeBit(LawRule<decltype(law)::value>::ROOT))) {
+            return;
+        }
+        for (auto& trans : applyLawRecursively<decltype(law)::value>(expression)) {
+            transformations.push_back(std::move(trans));
+        }
+    });
+    return transformations;
+}
+
+template <typename Laws>
+std::vector<Transformation> EquivalenceEngine::generateSingleStepTransformationsWith(const ASTNode& expression) {
+    using Transformations = std::vector<Transformation>;
+    
+    auto with_direct = [](const ASTNode& node, Transformations below) {
+        Transformations transformations;
+        Laws::applyAt(node, [&](LogicLaw law, std::unique_ptr<ASTNode> result) {
+            transformations.emplace_back(law, LogicLaws::getLawName(law), std::move(result));
+        });
+        for (auto& trans : below) {
+            transformations.push_back(std::move(trans));
+        }
+        return transformations;
+    };
+    
+    // Unlike applyLawRecursively, never rewrite both operands in one step
+    return foldTree<Transformations>(
+        expression,
+        [&](const ASTNode& node) { return with_direct(node, {}); },
+        [&](const UnaryOpNode& node, Transformations operand) {
+            return with_direct(node, applyLawToSubexpressions(node, std::move(operand), {}, false));
+        },
+        [&](const BinaryOpNode& node, Transformations left, Transformations right) {
+            return with_direct(node, applyLawToSubexpressions(node, std::move(left), std::move(right), false));
+        });
+}
+
+template <LogicLaw Law>
+std::vector<Transformation> EquivalenceEngine::applyLawRecursively(const ASTNode& expression) {
+    using Transformations = std::vector<Transformation>;
+    
+    auto with_direct = [](const ASTNode& node, Transformations below) {
+        Transformations transformations;
+        if (auto direct_result = LawRule<Law>::apply(node)) {
+            transformations.emplace_back(Law, LogicLaws::getLawName(Law), std::move(direct_result));
+        }
+        for (auto& trans : below) {
+            transformations.push_back(std::move(trans));
+        }
+        return transformations;
+    };
+    
+    return foldTree<Transformations>(
+        expression,
+        [&](const ASTNode& node) { return with_direct(node, {}); },
+        [&](const UnaryOpNode& node, Transformations operand) {
+            return with_direct(node, applyLawToSubexpressions(node, std::move(operand), {}, true));
+        },
+        [&](const BinaryOpNode& node, Transformations left, Transformations right) {
+            return with_direct(node, applyLawToSubexpressions(node, std::move(left), std::move(right), true));
+        });
+}
+
+// An engine restricted to a compile-time law subset, e.g.
+// SpecializedEquivalenceEngine<NonDistributiveLaws>
+template <typename Laws>
+class SpecializedEquivalenceEngine {
+private:
+    EquivalenceEngine engine;
+    
+public:
+    std::vector<Transformation> generateAllTransformations(const ASTNode& expression) {
+        return engine.generateAllTransformationsWith<Laws>(expression);
+    }
+    
+    std::vector<Transformation> generateSingleStepTransformations(const ASTNode& expression) {
+        return engine.generateSingleStepTransformationsWith<Laws>(expression);
+    }
     
-    std::size_t computeHash(const ASTNode& node) const;
+    std::unique_ptr<ASTNode> applyLawToNode(const ASTNode& node, LogicLaw law) {
+        return Laws::apply(node, law);
+    }
     
-    std::size_t combineHashes(std::size_t h1, std::size_t h2) const;
+    bool areEquivalent(const ASTNode& expr1, const ASTNode& expr2) {
+        return engine.areEquivalent(expr1, expr2);
+    }
 };
 
 }
\ No newline at end of file
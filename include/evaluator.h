@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace logixpr {
+
+enum class OpCode : std::uint8_t {
+    LOAD_VARIABLE,
+    LOAD_TRUE,
+    LOAD_FALSE,
+    NOT,
+    AND,
+    OR,
+    IMPLIES,
+    BICONDITIONAL
+};
+
+struct Instruction {
+    OpCode op;
+    std::uint32_t operand;
+};
+
+// Stack bytecode evaluated over 64 assignments at a time: every stack slot is
+// a machine word whose bit k holds the value for the k-th assignment of the
+// batch.
+class CompiledExpression {
+private:
+    std::vector<Instruction> code;
+    std::vector<std::string> variables;
+    std::size_t max_stack_depth;
+
+public:
+    static constexpr std::size_t MAX_ENUMERATION_VARIABLES = 48;
+
+    static CompiledExpression compile(const ASTNode& expression);
+    static CompiledExpression compile(const ASTNode& expression, const std::vector<std::string>& variable_order);
+
+    const std::vector<Instruction>& getCode() const;
+    const std::vector<std::string>& getVariables() const;
+    std::size_t variableCount() const;
+
+    bool evaluate(std::uint64_t assignment) const;
+    std::uint64_t evaluateBatch(const std::uint64_t* variable_words) const;
+
+    std::uint64_t countModels(unsigned num_threads = 0) const;
+    bool findAssignment(bool value, std::uint64_t& assignment, unsigned num_threads = 0) const;
+
+private:
+    CompiledExpression();
+    std::uint64_t run(const std::uint64_t* variable_words, std::uint64_t* stack) const;
+};
+
+class TruthTable {
+public:
+    static std::vector<std::string> collectVariables(const ASTNode& expression);
+    static std::vector<std::string> collectVariables(const ASTNode& expr1, const ASTNode& expr2);
+
+    static bool areEquivalent(const ASTNode& expr1, const ASTNode& expr2, unsigned num_threads = 0);
+    static bool findCounterexample(const ASTNode& expr1, const ASTNode& expr2,
+                                   std::vector<std::pair<std::string, bool>>& counterexample,
+                                   unsigned num_threads = 0);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ast.h"
+#include <string>
+
+namespace logixpr {
+
+enum class OutputStyle {
+    ASCII,
+    UNICODE,
+    FULLY_PARENTHESIZED
+};
+
+// Append-only serializer: every write lands in one growing buffer, so a tree
+// of n nodes is printed in O(n) and the buffer can be reused across calls.
+// ASCII matches ASTNode::toString(); FULLY_PARENTHESIZED also wraps negations.
+// All three styles are accepted back by ExpressionParser.
+class ExpressionWriter {
+private:
+    std::string buffer;
+    OutputStyle style;
+
+public:
+    explicit ExpressionWriter(OutputStyle style = OutputStyle::ASCII);
+
+    ExpressionWriter& write(const ASTNode& expression);
+    ExpressionWriter& append(const std::string& text);
+    ExpressionWriter& append(const char* text);
+    ExpressionWriter& append(char c);
+    ExpressionWriter& append(long long value);
+
+    const std::string& str() const;
+    std::string release();
+    std::size_t size() const;
+    ExpressionWriter& clear();
+
+    void setStyle(OutputStyle output_style);
+    OutputStyle getStyle() const;
+
+    static std::string toString(const ASTNode& expression, OutputStyle style = OutputStyle::ASCII);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace logixpr {
+
+class VariableTable {
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::uint32_t> ids;
+
+public:
+    std::uint32_t intern(const std::string& name);
+    bool lookup(const std::string& name, std::uint32_t& id) const;
+    const std::string& getName(std::uint32_t id) const;
+    std::size_t size() const;
+};
+
+// A single node of a FlatExpression. For VARIABLE nodes value is the interned
+// variable id, for CONSTANT nodes it is 0 or 1, and for binary nodes it is the
+// distance back to the root of the left child. Unary operands and right
+// children always sit immediately before their parent.
+struct FlatNode {
+    NodeType type;
+    std::uint32_t value;
+};
+
+static_assert(sizeof(FlatNode) == 8, "FlatNode must stay a compact 8-byte record");
+
+class FlatExpression {
+private:
+    std::vector<FlatNode> nodes;
+
+public:
+    FlatExpression() = default;
+    explicit FlatExpression(std::vector<FlatNode> nodes);
+
+    static FlatExpression fromAST(const ASTNode& node, VariableTable& variables);
+    std::unique_ptr<ASTNode> toAST(const VariableTable& variables) const;
+
+    static FlatExpression makeVariable(std::uint32_t id);
+    static FlatExpression makeConstant(bool value);
+    static FlatExpression makeNot(const FlatExpression& operand);
+    static FlatExpression makeBinary(NodeType op_type, const FlatExpression& left, const FlatExpression& right);
+
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t root() const;
+    const FlatNode& getNode(std::size_t index) const;
+    const std::vector<FlatNode>& getNodes() const;
+
+    std::size_t operandOf(std::size_t index) const;
+    std::size_t leftChild(std::size_t index) const;
+    std::size_t rightChild(std::size_t index) const;
+    std::size_t subtreeStart(std::size_t index) const;
+
+    FlatExpression subtree(std::size_t index) const;
+    FlatExpression replaceSubtree(std::size_t index, const FlatExpression& replacement) const;
+
+    std::size_t hash() const;
+    bool operator==(const FlatExpression& other) const;
+    bool operator!=(const FlatExpression& other) const;
+
+    bool evaluate(const std::vector<bool>& assignment) const;
+
+private:
+    void relink();
+};
+
+struct FlatExpressionHasher {
+    std::size_t operator()(const FlatExpression& expression) const {
+        return expression.hash();
+    }
+};
+
+}
\ No newline at end of file
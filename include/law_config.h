@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ast.h"
+#include "logic_laws.h"
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace logixpr {
+
+const std::size_t LAW_COUNT = static_cast<std::size_t>(LogicLaw::BICONDITIONAL_ELIMINATION) + 1;
+
+// Runtime choice of active laws plus a weight per law. Engines generate
+// transformations law by law in descending weight (ties keep the standard
+// order), so heavier laws are explored first among equally short proofs.
+class LawConfiguration {
+private:
+    std::uint32_t enabled_mask;
+    std::array<int, LAW_COUNT> weights;
+    std::vector<LogicLaw> active_order;
+
+public:
+    // Every law enabled with weight 1
+    LawConfiguration();
+
+    static LawConfiguration only(std::initializer_list<LogicLaw> laws);
+
+    // Keeps only laws that can fire somewhere between the two expressions.
+    // Laws here only ever eliminate -> and <->, so the connectives that can
+    // appear are the closure of those in start and target under the laws'
+    // outputs; a law whose pattern needs a connective outside that closure
+    // can never match. Dropping such laws never changes a search result.
+    static LawConfiguration forProblem(const ASTNode& start_expression, const ASTNode& target_expression);
+
+    void enable(LogicLaw law);
+    void disable(LogicLaw law);
+    bool isEnabled(LogicLaw law) const;
+
+    void setWeight(LogicLaw law, int weight);
+    int getWeight(LogicLaw law) const;
+
+    // Enabled laws, heaviest first
+    const std::vector<LogicLaw>& activeLaws() const;
+    // True for every law enabled with equal weights, i.e. the standard behaviour
+    bool isDefault() const;
+    std::uint32_t getMask() const;
+    // Stable text form, usable as part of a cache key
+    std::string key() const;
+
+private:
+    void reorder();
+};
+
+}
\ No newline at end of file
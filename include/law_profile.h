@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ast.h"
+#include "law_config.h"
+#include "logic_laws.h"
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace logixpr {
+
+struct Proof;
+
+// How often each law was used in successful proofs, keyed by the root
+// connective of the rewritten state and its depth in the proof. Searches
+// try the most used laws for a state first, so on recurring problem shapes
+// the proof is reached earlier within its level. Thread-safe, so one
+// profile can be shared by concurrent searchers.
+class LawProfile {
+private:
+    static const std::size_t ROOT_TYPES = static_cast<std::size_t>(NodeType::BICONDITIONAL) + 1;
+    static const std::size_t DEPTH_BUCKETS = 8;
+
+    using Counts = std::array<std::uint32_t, ROOT_TYPES * DEPTH_BUCKETS * LAW_COUNT>;
+
+    mutable std::mutex mutex;
+    Counts counts;
+    std::size_t proofs;
+    std::uint64_t version;
+
+public:
+    static const int VERSION = 1;
+
+    LawProfile();
+
+    // Counts every step of a found proof; unfound proofs are ignored
+    void record(const ASTNode& start_expression, const Proof& proof);
+    void recordStep(NodeType root, int depth, LogicLaw law);
+
+    // Depths past the last bucket share it
+    std::uint32_t getCount(NodeType root, int depth, LogicLaw law) const;
+    std::size_t getProofCount() const;
+    // Changes whenever an update makes order() rank some laws differently
+    // and is never shared by two profiles, so it identifies the ordering a
+    // search ran with (for example in retained search keys)
+    std::uint64_t getVersion() const;
+    bool empty() const;
+    void clear();
+
+    // Stable sort of a state's successors, most used law first: counts at
+    // the state's depth decide, then counts over all depths. Ties and an
+    // empty profile keep the engine's order.
+    void order(NodeType root, int depth, std::vector<Transformation>& successors) const;
+
+    // Text format: a header line, then one "root depth law count" line per
+    // non-zero count. Loading merges into the current counts and throws
+    // std::runtime_error on malformed input.
+    void save(std::ostream& out) const;
+    void load(std::istream& in);
+    // Returns false if the file cannot be opened
+    bool loadFile(const std::string& path);
+    void saveFile(const std::string& path) const;
+
+private:
+    static std::size_t slot(NodeType root, int depth, LogicLaw law);
+    static std::array<std::uint64_t, LAW_COUNT> ranks(const Counts& table, NodeType root, int depth);
+    static std::uint64_t nextVersion();
+    // Takes a new version if the counts rank laws differently than before;
+    // the caller holds the mutex
+    void updateVersion(const Counts& before);
+};
+
+}
\ No newline at end of file
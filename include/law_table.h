@@ -0,0 +1,157 @@
+#pragma once
+
+#include "ast.h"
+#include "logic_laws.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace logixpr {
+
+// Compile-time description of a law: the node type its pattern is rooted at
+// and the rewrite for a match. The root check is inlined at every call site,
+// so non-matching nodes never reach the rewrite function.
+template <NodeType Root, std::unique_ptr<ASTNode> (*Rewrite)(const ASTNode&)>
+struct LawRuleSpec {
+    static constexpr NodeType ROOT = Root;
+
+    static std::unique_ptr<ASTNode> apply(const ASTNode& node) {
+        return node.getType() == Root ? Rewrite(node) : nullptr;
+    }
+};
+
+template <LogicLaw Law>
+struct LawRule;
+
+template <> struct LawRule<LogicLaw::DOUBLE_NEGATION> : LawRuleSpec<NodeType::NOT, &LogicLaws::applyDoubleNegation> {};
+template <> struct LawRule<LogicLaw::DE_MORGAN_AND> : LawRuleSpec<NodeType::NOT, &LogicLaws::applyDeMorganAnd> {};
+template <> struct LawRule<LogicLaw::DE_MORGAN_OR> : LawRuleSpec<NodeType::NOT, &LogicLaws::applyDeMorganOr> {};
+template <> struct LawRule<LogicLaw::DISTRIBUTIVE_AND_OVER_OR> : LawRuleSpec<NodeType::AND, &LogicLaws::applyDistributiveAndOverOr> {};
+template <> struct LawRule<LogicLaw::DISTRIBUTIVE_OR_OVER_AND> : LawRuleSpec<NodeType::OR, &LogicLaws::applyDistributiveOrOverAnd> {};
+template <> struct LawRule<LogicLaw::ABSORPTION_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyAbsorptionAnd> {};
+template <> struct LawRule<LogicLaw::ABSORPTION_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyAbsorptionOr> {};
+template <> struct LawRule<LogicLaw::IDENTITY_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyIdentityAnd> {};
+template <> struct LawRule<LogicLaw::IDENTITY_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyIdentityOr> {};
+template <> struct LawRule<LogicLaw::ANNIHILATION_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyAnnihilationAnd> {};
+template <> struct LawRule<LogicLaw::ANNIHILATION_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyAnnihilationOr> {};
+template <> struct LawRule<LogicLaw::COMPLEMENT_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyComplementAnd> {};
+template <> struct LawRule<LogicLaw::COMPLEMENT_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyComplementOr> {};
+template <> struct LawRule<LogicLaw::IDEMPOTENT_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyIdempotentAnd> {};
+template <> struct LawRule<LogicLaw::IDEMPOTENT_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyIdempotentOr> {};
+template <> struct LawRule<LogicLaw::COMMUTATIVE_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyCommutativeAnd> {};
+template <> struct LawRule<LogicLaw::COMMUTATIVE_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyCommutativeOr> {};
+template <> struct LawRule<LogicLaw::ASSOCIATIVE_AND> : LawRuleSpec<NodeType::AND, &LogicLaws::applyAssociativeAnd> {};
+template <> struct LawRule<LogicLaw::ASSOCIATIVE_OR> : LawRuleSpec<NodeType::OR, &LogicLaws::applyAssociativeOr> {};
+template <> struct LawRule<LogicLaw::IMPLICATION_ELIMINATION> : LawRuleSpec<NodeType::IMPLIES, &LogicLaws::applyImplicationElimination> {};
+template <> struct LawRule<LogicLaw::BICONDITIONAL_ELIMINATION> : LawRuleSpec<NodeType::BICONDITIONAL, &LogicLaws::applyBiconditionalElimination> {};
+
+constexpr std::uint32_t nodeTypeBit(NodeType type) {
+    return 1u << static_cast<std::uint32_t>(type);
+}
+
+// Union of nodeTypeBit over every node of the expression
+inline std::uint32_t nodeTypeMask(const ASTNode& expression) {
+    return expression.getTypeMask();
+}
+
+// A law set fixed at compile time. Every helper expands to a straight-line
+// sequence of inlined root checks over the listed laws only; laws outside
+// the set cost nothing.
+template <LogicLaw... Laws>
+struct LawSet {
+    static constexpr std::size_t SIZE = sizeof...(Laws);
+    static constexpr std::array<LogicLaw, SIZE> LAWS = {Laws...};
+    // Node types at which at least one law of the set can fire
+    static constexpr std::uint32_t ROOT_MASK = (0u | ... | nodeTypeBit(LawRule<Laws>::ROOT));
+
+    static constexpr bool contains(LogicLaw law) {
+        return (false || ... || (law == Laws));
+    }
+
+    // Calls emit(law, result) for each law of the set that rewrites node, in set order
+    template <typename Emit>
+    static void applyAt(const ASTNode& node, Emit&& emit) {
+        if (!(ROOT_MASK & nodeTypeBit(node.getType()))) {
+            return;
+        }
+        (emitIfApplies<Laws>(node, emit), ...);
+    }
+
+    // Runtime law id; laws outside the set give nullptr
+    static std::unique_ptr<ASTNode> apply(const ASTNode& node, LogicLaw law) {
+        std::unique_ptr<ASTNode> result;
+        (void)((law == Laws && (result = LawRule<Laws>::apply(node), true)) || ...);
+        return result;
+    }
+
+    // Calls visit(std::integral_constant<LogicLaw, L>()) for each law L of the set
+    template <typename Visit>
+    static void forEach(Visit&& visit) {
+        (visit(std::integral_constant<LogicLaw, Laws>()), ...);
+    }
+
+private:
+    template <LogicLaw Law, typename Emit>
+    static void emitIfApplies(const ASTNode& node, Emit& emit) {
+        if (auto result = LawRule<Law>::apply(node)) {
+            emit(Law, std::move(result));
+        }
+    }
+};
+
+using StandardLaws = LawSet<
+    LogicLaw::DOUBLE_NEGATION,
+    LogicLaw::DE_MORGAN_AND,
+    LogicLaw::DE_MORGAN_OR,
+    LogicLaw::DISTRIBUTIVE_AND_OVER_OR,
+    LogicLaw::DISTRIBUTIVE_OR_OVER_AND,
+    LogicLaw::ABSORPTION_AND,
+    LogicLaw::ABSORPTION_OR,
+    LogicLaw::IDENTITY_AND,
+    LogicLaw::IDENTITY_OR,
+    LogicLaw::ANNIHILATION_AND,
+    LogicLaw::ANNIHILATION_OR,
+    LogicLaw::COMPLEMENT_AND,
+    LogicLaw::COMPLEMENT_OR,
+    LogicLaw::IDEMPOTENT_AND,
+    LogicLaw::IDEMPOTENT_OR,
+    LogicLaw::COMMUTATIVE_AND,
+    LogicLaw::COMMUTATIVE_OR,
+    LogicLaw::ASSOCIATIVE_AND,
+    LogicLaw::ASSOCIATIVE_OR,
+    LogicLaw::IMPLICATION_ELIMINATION,
+    LogicLaw::BICONDITIONAL_ELIMINATION>;
+
+using NonDistributiveLaws = LawSet<
+    LogicLaw::DOUBLE_NEGATION,
+    LogicLaw::DE_MORGAN_AND,
+    LogicLaw::DE_MORGAN_OR,
+    LogicLaw::ABSORPTION_AND,
+    LogicLaw::ABSORPTION_OR,
+    LogicLaw::IDENTITY_AND,
+    LogicLaw::IDENTITY_OR,
+    LogicLaw::ANNIHILATION_AND,
+    LogicLaw::ANNIHILATION_OR,
+    LogicLaw::COMPLEMENT_AND,
+    LogicLaw::COMPLEMENT_OR,
+    LogicLaw::IDEMPOTENT_AND,
+    LogicLaw::IDEMPOTENT_OR,
+    LogicLaw::COMMUTATIVE_AND,
+    LogicLaw::COMMUTATIVE_OR,
+    LogicLaw::ASSOCIATIVE_AND,
+    LogicLaw::ASSOCIATIVE_OR,
+    LogicLaw::IMPLICATION_ELIMINATION,
+    LogicLaw::BICONDITIONAL_ELIMINATION>;
+
+inline NodeType lawRoot(LogicLaw law) {
+    NodeType root = NodeType::VARIABLE;
+    StandardLaws::forEach([&](auto rule) {
+        if (decltype(rule)::value == law) {
+            root = LawRule<decltype(rule)::value>::ROOT;
+        }
+    });
+    return root;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ast.h"
+#include "normal_form.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace logixpr {
+
+enum class MinimizationMode {
+    AUTOMATIC,
+    EXACT,
+    HEURISTIC
+};
+
+// A product of literals over at most 64 variables: bit i of mask is set when
+// variable i occurs, and bit i of value then gives its polarity
+struct Cube {
+    std::uint64_t mask;
+    std::uint64_t value;
+
+    // True if every assignment satisfying other also satisfies this cube
+    bool contains(const Cube& other) const;
+    std::size_t literalCount() const;
+    bool operator==(const Cube& other) const;
+};
+
+// Two-level minimization: returns a sum of products (NormalForm::DISJUNCTIVE)
+// or product of sums (NormalForm::CONJUNCTIVE) equivalent to the input with
+// few terms and literals. EXACT runs Quine-McCluskey prime generation over the
+// truth table and a branch-and-bound cover, which is minimal unless the cover
+// search exhausts its budget. HEURISTIC extracts an irredundant cover from a
+// BDD of the function and improves it with Espresso-style reduce, expand and
+// irredundant passes, so it never enumerates minterms and scales with the
+// size of the cover instead. AUTOMATIC picks EXACT up to the exact variable
+// limit.
+class LogicMinimizer {
+private:
+    NormalForm form;
+    MinimizationMode mode;
+    std::size_t exact_variable_limit;
+    std::size_t cover_search_limit;
+
+public:
+    static constexpr std::size_t MAX_EXACT_VARIABLES = 16;
+    static constexpr std::size_t MAX_VARIABLES = 64;
+
+    explicit LogicMinimizer(NormalForm form = NormalForm::DISJUNCTIVE,
+                            MinimizationMode mode = MinimizationMode::AUTOMATIC);
+
+    std::unique_ptr<ASTNode> simplify(const ASTNode& expression) const;
+
+    // Cover of the expression's on-set over the given variables, in a
+    // deterministic order; every variable of the expression must be listed
+    std::vector<Cube> minimizeCover(const ASTNode& expression, const std::vector<std::string>& variables) const;
+
+    void setForm(NormalForm normal_form);
+    void setMode(MinimizationMode minimization_mode);
+    void setExactVariableLimit(std::size_t limit);
+    // Branch-and-bound nodes the exact cover may visit before settling for
+    // the best cover found so far
+    void setCoverSearchLimit(std::size_t limit);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ast.h"
+#include "equivalence_engine.h"
+#include "proof_search.h"
+#include <memory>
+#include <vector>
+
+namespace logixpr {
+
+enum class NormalForm {
+    NEGATION,
+    CONJUNCTIVE,
+    DISJUNCTIVE
+};
+
+// Drives an expression to a normal form by applying LogicLaws in a fixed
+// order, recording every application as a ProofStep. Besides the textbook
+// rewriting, each AND/OR chain is right-associated, sorted and deduplicated,
+// so equivalent inputs usually meet on the same expression.
+class NormalFormRewriter {
+private:
+    EquivalenceEngine equivalence_engine;
+    NormalForm form;
+    std::size_t max_steps;
+    CancellationToken cancellation;
+
+public:
+    explicit NormalFormRewriter(NormalForm form = NormalForm::CONJUNCTIVE, std::size_t max_steps = 10000);
+
+    // Returns nullptr if the step budget runs out or the search is cancelled
+    std::unique_ptr<ASTNode> normalize(const ASTNode& expression, std::vector<ProofStep>& steps);
+
+    // Normalizes both sides and splices the reversed target chain onto the
+    // start chain; the proof is not found if the normal forms differ
+    Proof proveEquivalence(const ASTNode& start_expression, const ASTNode& target_expression);
+
+    void setForm(NormalForm normal_form);
+    void setMaxSteps(std::size_t steps);
+    void setCancellationToken(CancellationToken token);
+};
+
+}
\ No newline at end of file
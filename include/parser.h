@@ -78,12 +78,11 @@ private:
     void consume(TokenType type);
     
     std::unique_ptr<ASTNode> parseExpression();
-    std::unique_ptr<ASTNode> parseBiconditional();
-    std::unique_ptr<ASTNode> parseImplication();
-    std::unique_ptr<ASTNode> parseDisjunction();
-    std::unique_ptr<ASTNode> parseConjunction();
-    std::unique_ptr<ASTNode> parseNegation();
     std::unique_ptr<ASTNode> parsePrimary();
+    
+    static bool isBinaryOperator(TokenType type);
+    static int precedence(TokenType type);
+    static void reduce(std::vector<std::unique_ptr<ASTNode>>& operands, TokenType op);
 };
 
 class ExpressionParser {
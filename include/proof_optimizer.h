@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ast.h"
+#include "equivalence_engine.h"
+#include "proof_search.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace logixpr {
+
+// Shortens an existing proof by running bounded BFS between the expressions
+// at steps i and j of a sliding window and splicing in any shorter
+// connection. Repeats until no window improves or the time budget runs out.
+class ProofOptimizer {
+private:
+    EquivalenceEngine equivalence_engine;
+    std::size_t window_size;
+    int max_transformations;
+    std::chrono::milliseconds time_limit;
+
+public:
+    explicit ProofOptimizer(std::size_t window_size = 6,
+                            std::chrono::milliseconds time_limit = std::chrono::milliseconds(500));
+
+    Proof optimize(const ASTNode& start_expression, const Proof& proof);
+
+    void setWindowSize(std::size_t size);
+    void setMaxTransformations(int transformations);
+    void setTimeLimit(std::chrono::milliseconds limit);
+
+private:
+    bool findShortcut(const ASTNode& from, const ASTNode& to, std::size_t max_steps,
+                      std::chrono::steady_clock::time_point deadline, std::vector<ProofStep>& shortcut);
+};
+
+}
\ No newline at end of file
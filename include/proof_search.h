@@ -1,12 +1,22 @@
 #pragma once
 
 #include "ast.h"
+#include "cancellation.h"
 #include "equivalence_engine.h"
+#include "expression_writer.h"
+#include "law_profile.h"
+#include "state_arena.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <functional>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
 #include <vector>
 #include <memory>
-#include <unordered_set>
 #include <unordered_map>
-#include <queue>
+#include <utility>
 
 namespace logixpr {
 
@@ -24,59 +34,259 @@ struct Proof {
     std::vector<ProofStep> steps;
     bool found_target;
     int total_steps;
+    // The expressions are not equivalent; the counterexample distinguishes
+    // them, and is empty when neither has variables
+    bool refuted;
+    std::vector<std::pair<std::string, bool>> counterexample;
     
-    Proof() : found_target(false), total_steps(0) {}
+    Proof() : found_target(false), total_steps(0), refuted(false) {}
 };
 
-class ProofSearchNode {
+// Bounded, thread-safe map from canonical problem keys to finished proofs.
+// The oldest entry is evicted first once capacity is reached.
+class ProofCache {
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const Proof>> entries;
+    std::deque<std::string> insertion_order;
+    std::size_t capacity;
+    mutable std::size_t hits;
+    mutable std::size_t misses;
+
 public:
-    std::unique_ptr<ASTNode> expression;
-    int depth;
-    std::vector<ProofStep> path;
+    explicit ProofCache(std::size_t capacity = 4096);
+
+    std::shared_ptr<const Proof> lookup(const std::string& key) const;
+    void store(const std::string& key, std::shared_ptr<const Proof> proof);
+    void clear();
+
+    std::size_t size() const;
+    std::size_t getHits() const;
+    std::size_t getMisses() const;
+};
+
+// Breadth-first search state that can be resumed by a later query
+struct BreadthFirstState {
+    SearchGraph graph;
+    // Record indices by subtree hash, kept only for retained searches
+    std::unordered_multimap<std::size_t, std::uint32_t> fingerprints;
+    bool indexed;
+    // Records before this one have been dequeued, and expanded or pruned
+    std::size_t expanded;
+    int transformations_explored;
+    // Transformations spent before each record was dequeued, so a query with
+    // a smaller budget only accepts the records it would have reached
+    std::vector<int> explored_before;
+    
+    BreadthFirstState(const ASTNode& start_expression, bool indexed);
+    
+    void add(const ASTNode& expression, std::uint32_t parent, LogicLaw law, const std::string& description);
+    std::size_t bytesUsed() const;
+};
+
+// Breadth-first searches kept between queries, so that a query from a start
+// an earlier query already explored resumes from the retained layers instead
+// of starting over. Entries are keyed by the start expression, the effective
+// laws, the depth limit and the law profile's version, which only changes
+// when the profile starts ranking laws differently; the least recently used
+// are dropped once the total footprint passes the byte limit. Not
+// thread-safe; each searcher owns its own.
+class SearchRetention {
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<BreadthFirstState>>;
+    
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::size_t byte_limit;
+    
+public:
+    explicit SearchRetention(std::size_t byte_limit);
+    
+    // The retained search for key, or a new one rooted at the start
+    std::shared_ptr<BreadthFirstState> acquire(const std::string& key, const ASTNode& start_expression);
+    // Evicts until the retained searches fit the byte limit
+    void trim();
+    void clear();
+    
+    std::size_t size() const;
+    std::size_t statesRetained() const;
+    std::size_t bytesUsed() const;
+};
+
+enum class SearchStrategy {
+    BREADTH_FIRST,
+    BEST_FIRST,
+    NORMAL_FORM,
+    EQUALITY_SATURATION
+};
+
+struct PortfolioResult {
+    Proof proof;
+    SearchStrategy winner;
+    std::chrono::milliseconds elapsed;
+    
+    PortfolioResult() : winner(SearchStrategy::BREADTH_FIRST), elapsed(0) {}
+};
+
+struct EnumerationLimits {
+    // 0 means no limit
+    std::size_t max_forms;
+    int max_depth;
+    // Forms with more nodes are neither reported nor expanded; 0 means no limit
+    std::size_t max_size;
+    // Workers expanding each batch, the caller included, drawn from the
+    // searcher's executor; 0 means one per executor thread
+    std::size_t threads;
     
-    ProofSearchNode(std::unique_ptr<ASTNode> expr, int d, std::vector<ProofStep> p)
-        : expression(std::move(expr)), depth(d), path(std::move(p)) {}
+    EnumerationLimits() : max_forms(0), max_depth(3), max_size(0), threads(1) {}
 };
 
+// Receives each distinct form and the number of steps it is from the input;
+// returning false stops the enumeration
+using FormSink = std::function<bool(const ASTNode& form, int depth)>;
+
 class ProofSearch {
 private:
     EquivalenceEngine equivalence_engine;
-    std::unordered_set<std::string> visited_expressions;
     int max_depth;
     int max_transformations;
+    bool semantic_precheck;
+    ExpressionWriter key_writer;
+    CancellationToken cancellation;
+    std::shared_ptr<ThreadPool> executor;
+    std::chrono::milliseconds grace_window;
+    std::shared_ptr<ProofCache> result_cache;
+    LawConfiguration law_configuration;
+    bool automatic_laws;
+    std::shared_ptr<LawProfile> law_profile;
+    std::shared_ptr<SearchRetention> retention;
     
 public:
     explicit ProofSearch(int max_depth = 10, int max_transformations = 10000);
     
+    // Solves the problem with variables renamed canonically, so results are
+    // cached and reused across instances that differ only in variable names
     Proof findProof(const ASTNode& start_expression, const ASTNode& target_expression);
     
     Proof findShortestProof(const ASTNode& start_expression, const ASTNode& target_expression);
     
-    std::vector<std::unique_ptr<ASTNode>> generateEquivalentForms(const ASTNode& expression, int max_steps = 5);
+    // One breadth-first search for many targets: every dequeued state is
+    // matched against the pending targets by fingerprint, and the search
+    // stops once all are found or the budget runs out. Returns a shortest
+    // proof (or a counterexample, or an unfound Proof) per target, in the
+    // order given. Unlike findProof there is no normal-form fallback.
+    std::vector<Proof> findProofs(const ASTNode& start_expression,
+                                  const std::vector<const ASTNode*>& target_expressions);
+    
+    // Expands the node with the lowest depth + estimateDistance first; finds
+    // deep proofs BFS cannot reach, but they need not be shortest
+    Proof findBestFirstProof(const ASTNode& start_expression, const ASTNode& target_expression);
+    
+    // Races each strategy on its own thread. Once one finds a proof the others
+    // get the grace window to find a shorter one, then all are cancelled. A
+    // counterexample ends the race at once.
+    PortfolioResult findProofPortfolio(const ASTNode& start_expression, const ASTNode& target_expression,
+                                       const std::vector<SearchStrategy>& strategies = {
+                                           SearchStrategy::BREADTH_FIRST, SearchStrategy::BEST_FIRST,
+                                           SearchStrategy::NORMAL_FORM, SearchStrategy::EQUALITY_SATURATION});
+    
+    std::vector<std::unique_ptr<ASTNode>> generateEquivalentForms(const ASTNode& expression, int max_steps = 5,
+                                                                  std::size_t max_forms = 50);
+    
+    // Streams every distinct form within the limits to the sink, in
+    // breadth-first discovery order starting with the input itself, and
+    // returns how many were reported. Only compact encodings of seen forms
+    // and the current and next levels are held, never the forms themselves.
+    // Each batch of a level is expanded on up to limits.threads workers of
+    // the executor and merged in order, so the output is the same for any
+    // thread count.
+    std::size_t enumerateEquivalentForms(const ASTNode& expression, const EnumerationLimits& limits,
+                                         const FormSink& sink);
+    
+    // The async variants copy the expressions and this searcher's limits and
+    // run on the executor, so any number of proofs share a fixed set of
+    // threads. Submission blocks while the executor's queue is full. A
+    // cancelled search completes early with an unfound Proof or an empty list.
+    std::future<Proof> findProofAsync(const ASTNode& start_expression, const ASTNode& target_expression,
+                                      CancellationToken token = CancellationToken());
+    void findProofAsync(const ASTNode& start_expression, const ASTNode& target_expression,
+                        std::function<void(Proof)> on_complete, CancellationToken token = CancellationToken());
+    std::future<std::vector<std::unique_ptr<ASTNode>>> generateEquivalentFormsAsync(
+        const ASTNode& expression, int max_steps = 5, CancellationToken token = CancellationToken());
     
     void setMaxDepth(int depth);
     void setMaxTransformations(int transformations);
+    void setSemanticPrecheck(bool enabled);
+    void setCancellationToken(CancellationToken token);
+    void setGraceWindow(std::chrono::milliseconds window);
+    // Laws available to every search; weights order successors
+    void setLawConfiguration(const LawConfiguration& configuration);
+    const LawConfiguration& getLawConfiguration() const;
+    // On by default: each query further drops the laws that cannot fire
+    // between its start and target (see LawConfiguration::forProblem). The
+    // default configuration is left whole, since the compiled StandardLaws
+    // traversal already skips laws whose root cannot occur.
+    void setAutomaticLawSelection(bool enabled);
+    // Laws the most recent query ran with
+    const LawConfiguration& getEffectiveLawConfiguration() const;
+    // findProof records each proof it finds into the profile, and every
+    // search tries successors in the profile's order; nullptr (the default)
+    // keeps the engine's order. Searchers may share one profile. Cached
+    // results stay valid as the profile learns, and cache hits are recorded
+    // too.
+    void setLawProfile(std::shared_ptr<LawProfile> profile);
+    std::shared_ptr<LawProfile> getLawProfile() const;
+    // Keeps breadth-first searches within this many bytes for later queries
+    // from the same start; 0 (the default) disables retention. Each call
+    // starts with nothing retained. Results are the same as without
+    // retention. Async and portfolio searches run on copies that do not retain.
+    void setRetainedGraphLimit(std::size_t bytes);
+    std::shared_ptr<SearchRetention> getSearchRetention() const;
+    // Searchers may share one cache; nullptr disables caching
+    void setResultCache(std::shared_ptr<ProofCache> cache);
+    std::shared_ptr<ProofCache> getResultCache() const;
+    // nullptr selects the process-wide default executor
+    void setExecutor(std::shared_ptr<ThreadPool> pool);
+    
+    // One worker per hardware thread; created on first use
+    static std::shared_ptr<ThreadPool> defaultExecutor();
+    
+    static std::string getStrategyName(SearchStrategy strategy);
 
 private:
-    bool isVisited(const ASTNode& expression);
-    void markVisited(const ASTNode& expression);
-    void clearVisited();
-    
     std::string expressionToString(const ASTNode& expression);
     
-    bool shouldPrune(const ProofSearchNode& node);
+    bool shouldPrune(const ASTNode& expression, int depth);
     
-    std::vector<ProofSearchNode> expandNode(const ProofSearchNode& node);
+    // Successors of the whole expression, then of each direct operand,
+    // reordered by the law profile for a state at this depth
+    std::vector<Transformation> expandExpression(const ASTNode& expression, int depth);
     
-    Proof reconstructProof(const std::vector<ProofStep>& path, bool found_target);
+    Proof reconstructProof(const SearchGraph& graph, std::size_t index);
+    
+    // A fresh state, or the retained one for this start and configuration
+    std::shared_ptr<BreadthFirstState> breadthFirstState(const ASTNode& start_expression);
+    Proof continueBreadthFirst(BreadthFirstState& state, const ASTNode& target_expression);
+    
+    bool refuteEquivalence(const ASTNode& start_expression, const ASTNode& target_expression, Proof& refutation);
     
     int estimateDistance(const ASTNode& current, const ASTNode& target);
+    
+    void configureLaws(const ASTNode& start_expression, const ASTNode& target_expression);
+    // Keeps a law if it is relevant to any of the targets
+    void configureLaws(const ASTNode& start_expression, const std::vector<const ASTNode*>& target_expressions);
+    Proof searchProof(const ASTNode& start_expression, const ASTNode& target_expression);
+    Proof findNormalFormProof(const ASTNode& start_expression, const ASTNode& target_expression);
+    Proof runStrategy(SearchStrategy strategy, const ASTNode& start_expression, const ASTNode& target_expression);
+    
+    ProofSearch detachedCopy(CancellationToken token) const;
+    ThreadPool& activeExecutor();
 };
 
 class ProofFormatter {
 public:
-    static std::string formatProof(const Proof& proof);
-    static std::string formatProofStep(const ProofStep& step);
+    static std::string formatProof(const Proof& proof, OutputStyle style = OutputStyle::ASCII);
+    static std::string formatProofStep(const ProofStep& step, OutputStyle style = OutputStyle::ASCII);
     static void printProof(const Proof& proof);
     static void printProofStatistics(const Proof& proof);
 };
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "ast.h"
+#include "flat_expr.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace logixpr {
+
+enum class SatResult {
+    SATISFIABLE,
+    UNSATISFIABLE,
+    UNKNOWN
+};
+
+// Conflict-driven clause learning solver with two watched literals, VSIDS
+// branching, phase saving, Luby restarts and activity-based clause deletion.
+// Literals are encoded as 2 * variable + (negated ? 1 : 0).
+class SatSolver {
+private:
+    struct Clause {
+        std::vector<int> literals;
+        bool learnt;
+        bool deleted;
+        double activity;
+    };
+
+    std::vector<Clause> clauses;
+    std::vector<std::vector<int>> watches;
+    std::vector<std::int8_t> assigns;
+    std::vector<int> levels;
+    std::vector<int> reasons;
+    std::vector<bool> saved_phase;
+    std::vector<double> activity;
+    std::vector<int> heap;
+    std::vector<int> heap_index;
+    std::vector<char> seen;
+    std::vector<int> trail;
+    std::vector<std::size_t> trail_limits;
+    std::vector<bool> model;
+    std::size_t propagation_head;
+    std::size_t learnt_count;
+    double max_learnts;
+    double variable_increment;
+    double clause_increment;
+    std::uint64_t conflicts;
+    bool inconsistent;
+
+public:
+    SatSolver();
+
+    static int makeLiteral(int variable, bool negated);
+    static int negate(int literal);
+
+    int newVariable();
+    int variableCount() const;
+
+    bool addClause(std::vector<int> literals);
+
+    SatResult solve(std::int64_t conflict_limit = -1);
+
+    bool getModelValue(int variable) const;
+    std::uint64_t getConflicts() const;
+
+private:
+    std::int8_t valueOf(int literal) const;
+    int decisionLevel() const;
+
+    void enqueue(int literal, int reason);
+    int propagate();
+    void analyze(int conflict, std::vector<int>& learnt, int& backtrack_level);
+    bool isRedundant(int literal) const;
+    void cancelUntil(int level);
+    int pickBranchLiteral();
+    SatResult search(std::uint64_t conflict_budget, std::int64_t& remaining);
+
+    int attachClause(std::vector<int> literals, bool learnt);
+    void reduceLearnts();
+
+    void bumpVariable(int variable);
+    void bumpClause(Clause& clause);
+
+    void heapInsert(int variable);
+    int heapPop();
+    void heapSiftUp(std::size_t position);
+    void heapSiftDown(std::size_t position);
+
+    static double luby(double base, int index);
+};
+
+class TseitinEncoder {
+private:
+    SatSolver& solver;
+    VariableTable variables;
+    std::vector<int> solver_variables;
+    int true_literal;
+
+public:
+    explicit TseitinEncoder(SatSolver& solver);
+
+    int encode(const ASTNode& expression);
+
+    const VariableTable& getVariables() const;
+    int solverVariable(std::uint32_t id) const;
+
+private:
+    int constantLiteral(bool value);
+    int defineAnd(int a, int b);
+    int defineOr(int a, int b);
+    int defineBiconditional(int a, int b);
+};
+
+enum class EquivalenceVerdict {
+    EQUIVALENT,
+    NOT_EQUIVALENT,
+    UNKNOWN
+};
+
+class SatEquivalenceChecker {
+public:
+    static EquivalenceVerdict check(const ASTNode& expr1, const ASTNode& expr2,
+                                    std::vector<std::pair<std::string, bool>>& counterexample,
+                                    std::int64_t conflict_limit = -1);
+};
+
+}
\ No newline at end of file
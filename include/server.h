@@ -0,0 +1,91 @@
+#pragma once
+
+#include "proof_search.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace logixpr {
+
+// Ceilings for the per-request options; requests may ask for less, never more
+struct ServerLimits {
+    int max_depth = 10;
+    int max_transformations = 10000;
+    int max_generate_steps = 5;
+    int max_generate_forms = 1000;
+    std::size_t max_request_bytes = 1 << 20;
+};
+
+// Line protocol: one request per line, fields separated by tabs.
+//
+//   prove <expr1> <expr2> [depth=N] [transformations=N]
+//   generate <expr> [steps=N] [limit=N]
+//   parse <expr>
+//
+// Responses stream back one line at a time: "step <n> <law> <expr>" for each
+// proof step, "form <expr>" for each generated form, then exactly one final
+// line, "ok ..." or "error <message>".
+class RequestHandler {
+private:
+    ServerLimits limits;
+    // Shared by every request, so repeated and renamed problems are answered from memory
+    std::shared_ptr<ProofCache> proof_cache;
+
+public:
+    using Emitter = std::function<void(const std::string&)>;
+
+    explicit RequestHandler(ServerLimits limits = ServerLimits());
+
+    // Safe to call from several threads at once
+    void handle(const std::string& request, const Emitter& emit) const;
+
+    const ServerLimits& getLimits() const;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Keeps one warm process serving many clients. A poll() loop owns every
+// socket and only reads; each complete request line goes to the worker pool,
+// and a connection is not read again until its current request has finished,
+// so responses on one connection never interleave.
+class UnixSocketServer {
+private:
+    struct Connection;
+
+    std::string socket_path;
+    RequestHandler handler;
+    ThreadPool pool;
+    int listen_fd;
+    int wake_pipe[2];
+    std::atomic<bool> stopping;
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    std::mutex finished_mutex;
+    std::vector<int> finished;
+
+public:
+    UnixSocketServer(const std::string& socket_path, std::size_t threads = 0,
+                     ServerLimits limits = ServerLimits());
+    ~UnixSocketServer();
+
+    UnixSocketServer(const UnixSocketServer&) = delete;
+    UnixSocketServer& operator=(const UnixSocketServer&) = delete;
+
+    // Blocks until stop() is called
+    void run();
+    void stop();
+
+private:
+    void acceptConnections();
+    void readFrom(Connection& connection);
+    void dispatch(const std::shared_ptr<Connection>& connection);
+    void wake();
+};
+
+#endif
+
+}
\ No newline at end of file
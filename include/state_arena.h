@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ast.h"
+#include "flat_expr.h"
+#include "logic_laws.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace logixpr {
+
+// Append-only store of expressions in a compact postorder byte encoding.
+// Every node is one tag byte: the NodeType in the low three bits, the value
+// of a constant in bit 3, and for a variable its interned id in the high
+// five bits (ids of 31 and above write 31 there and follow with a varint).
+// Bytes live in fixed-size blocks that never move, so a stored state can be
+// referenced by a string_view for as long as the arena lives.
+class StateArena {
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t block_size;
+    std::size_t block_used;
+    std::size_t bytes_reserved;
+    std::string scratch;
+    VariableTable variables;
+
+public:
+    explicit StateArena(std::size_t block_size = 1 << 16);
+
+    // Encodes into a scratch buffer; the view is valid until the next encode
+    std::string_view encode(const ASTNode& expression);
+    // Copies the latest encoding into the blocks
+    std::string_view commit();
+    std::string_view store(const ASTNode& expression);
+
+    std::unique_ptr<ASTNode> decode(std::string_view state) const;
+
+    // Bytes held in blocks, including unused block tails
+    std::size_t bytesReserved() const;
+};
+
+struct StateRecord {
+    std::string_view state;
+    std::uint32_t parent;
+    std::uint32_t depth;
+    LogicLaw law;
+    std::uint16_t description;
+};
+
+// Every state reached by a search, each stored once in a StateArena and
+// linked to the state it was derived from. Records are numbered in order of
+// discovery, which is also the order a breadth-first search expands them.
+class SearchGraph {
+private:
+    StateArena arena;
+    std::vector<StateRecord> records;
+    std::unordered_set<std::string_view> visited;
+    std::vector<std::string> descriptions;
+    std::unordered_map<std::string, std::uint16_t> description_ids;
+
+public:
+    static const std::uint32_t NO_PARENT = UINT32_MAX;
+
+    explicit SearchGraph(const ASTNode& root);
+
+    // Returns false, storing nothing, if an identical state was already added
+    bool add(const ASTNode& expression, std::uint32_t parent, LogicLaw law, const std::string& description);
+    bool contains(const ASTNode& expression);
+
+    std::size_t size() const;
+    const StateRecord& getRecord(std::size_t index) const;
+    const std::string& getDescription(std::size_t index) const;
+    std::unique_ptr<ASTNode> expression(std::size_t index) const;
+
+    // Approximate heap footprint of records, states and the visited index
+    std::size_t bytesUsed() const;
+};
+
+}
\ No newline at end of file
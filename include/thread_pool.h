@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logixpr {
+
+// Fixed set of worker threads draining a bounded FIFO queue. submit() blocks
+// while the queue is full, which pushes back on producers instead of letting
+// the backlog grow without limit; trySubmit() refuses instead.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::size_t max_queue;
+    std::size_t active;
+    bool stopping;
+    mutable std::mutex mutex;
+    std::condition_variable task_available;
+    std::condition_variable space_available;
+    std::condition_variable idle;
+
+public:
+    // thread_count 0 means one worker per hardware thread
+    explicit ThreadPool(std::size_t thread_count = 0, std::size_t max_queue = 1024);
+    // Finishes every queued task before joining
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    bool trySubmit(std::function<void()> task);
+
+    // Blocks until the queue is empty and no task is running
+    void wait();
+
+    // Calls work(i) once for every i below task_count, on at most
+    // parallelism threads including the caller, and returns when all calls
+    // have finished. The caller works through the tasks itself and helpers
+    // that have not started by then are skipped, so this is safe to call
+    // from a task already running on this pool. The first exception thrown
+    // by work is rethrown here.
+    void parallelFor(std::size_t task_count, std::size_t parallelism, const std::function<void(std::size_t)>& work);
+
+    std::size_t size() const;
+    std::size_t pending() const;
+
+private:
+    void workerLoop();
+};
+
+}
\ No newline at end of file
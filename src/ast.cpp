@@ -1,9 +1,179 @@
 #include "ast.h"
-#include <sstream>
+#include "expression_writer.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <tuple>
 
 namespace logixpr {
 
-VariableNode::VariableNode(const std::string& name) : name(name) {}
+namespace {
+
+// All traversals below keep their own stack so that arbitrarily deep trees
+// (long implication chains, !!!!... prefixes) never exhaust the call stack
+
+bool isBinaryType(NodeType type) {
+    return type == NodeType::AND || type == NodeType::OR ||
+           type == NodeType::IMPLIES || type == NodeType::BICONDITIONAL;
+}
+
+std::unique_ptr<ASTNode> copyLeaf(const ASTNode& node) {
+    if (node.getType() == NodeType::VARIABLE) {
+        return std::make_unique<VariableNode>(static_cast<const VariableNode&>(node).getName());
+    }
+    return std::make_unique<ConstantNode>(static_cast<const ConstantNode&>(node).getValue());
+}
+
+std::unique_ptr<ASTNode> copyTree(const ASTNode& root) {
+    return foldTree<std::unique_ptr<ASTNode>>(
+        root, copyLeaf,
+        [](const UnaryOpNode& node, std::unique_ptr<ASTNode> operand) -> std::unique_ptr<ASTNode> {
+            return std::make_unique<UnaryOpNode>(node.getType(), std::move(operand));
+        },
+        [](const BinaryOpNode& node, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right) -> std::unique_ptr<ASTNode> {
+            return std::make_unique<BinaryOpNode>(node.getType(), std::move(left), std::move(right));
+        });
+}
+
+bool sameOrderedTree(const ASTNode& a, const ASTNode& b) {
+    std::vector<std::pair<const ASTNode*, const ASTNode*>> stack{{&a, &b}};
+    while (!stack.empty()) {
+        auto [x, y] = stack.back();
+        stack.pop_back();
+        if (x->getType() != y->getType()) {
+            return false;
+        }
+        switch (x->getType()) {
+            case NodeType::VARIABLE:
+                if (static_cast<const VariableNode*>(x)->getName() != static_cast<const VariableNode*>(y)->getName()) {
+                    return false;
+                }
+                break;
+            case NodeType::CONSTANT:
+                if (static_cast<const ConstantNode*>(x)->getValue() != static_cast<const ConstantNode*>(y)->getValue()) {
+                    return false;
+                }
+                break;
+            case NodeType::NOT:
+                stack.push_back({&static_cast<const UnaryOpNode*>(x)->getOperand(),
+                                 &static_cast<const UnaryOpNode*>(y)->getOperand()});
+                break;
+            default: {
+                const auto* left = static_cast<const BinaryOpNode*>(x);
+                const auto* right = static_cast<const BinaryOpNode*>(y);
+                stack.push_back({&left->getRight(), &right->getRight()});
+                stack.push_back({&left->getLeft(), &right->getLeft()});
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+std::size_t mix(std::size_t seed, std::size_t value) {
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+bool isCommutative(NodeType type) {
+    return type == NodeType::AND || type == NodeType::OR;
+}
+
+std::uint32_t typeBit(NodeType type) {
+    return 1u << static_cast<std::uint32_t>(type);
+}
+
+using ShapeKey = std::tuple<int, std::string, int, int>;
+
+// Numbers every subtree so that two subtrees get the same id exactly when
+// they are equal up to swapping operands of AND/OR
+int canonicalId(const ASTNode& root, std::map<ShapeKey, int>& ids) {
+    auto intern = [&ids](ShapeKey key) {
+        return ids.emplace(std::move(key), static_cast<int>(ids.size())).first->second;
+    };
+
+    return foldTree<int>(
+        root,
+        [&](const ASTNode& node) {
+            if (node.getType() == NodeType::VARIABLE) {
+                return intern({static_cast<int>(node.getType()), static_cast<const VariableNode&>(node).getName(), 0, 0});
+            }
+            return intern({static_cast<int>(node.getType()), "", static_cast<const ConstantNode&>(node).getValue(), 0});
+        },
+        [&](const UnaryOpNode& node, int operand) {
+            return intern({static_cast<int>(node.getType()), "", operand, 0});
+        },
+        [&](const BinaryOpNode& node, int left, int right) {
+            if (isCommutative(node.getType()) && right < left) {
+                std::swap(left, right);
+            }
+            return intern({static_cast<int>(node.getType()), "", left, right});
+        });
+}
+
+bool sameTree(const ASTNode& a, const ASTNode& b) {
+    // The cached hash ignores AND/OR operand order, so it rejects almost
+    // every real mismatch before any traversal
+    if (a.getHash() != b.getHash() || a.getSize() != b.getSize()) {
+        return false;
+    }
+    if (sameOrderedTree(a, b)) {
+        return true;
+    }
+    std::map<ShapeKey, int> ids;
+    return canonicalId(a, ids) == canonicalId(b, ids);
+}
+
+// Detaches children before each node is destroyed so destruction of deep
+// trees does not recurse
+void dismantle(std::unique_ptr<ASTNode> first, std::unique_ptr<ASTNode> second) {
+    std::vector<std::unique_ptr<ASTNode>> pending;
+    if (first) pending.push_back(std::move(first));
+    if (second) pending.push_back(std::move(second));
+
+    while (!pending.empty()) {
+        std::unique_ptr<ASTNode> node = std::move(pending.back());
+        pending.pop_back();
+        if (node->getType() == NodeType::NOT) {
+            auto operand = static_cast<UnaryOpNode&>(*node).takeOperand();
+            if (operand) pending.push_back(std::move(operand));
+        } else if (isBinaryType(node->getType())) {
+            auto& binary = static_cast<BinaryOpNode&>(*node);
+            auto left = binary.takeLeft();
+            auto right = binary.takeRight();
+            if (left) pending.push_back(std::move(left));
+            if (right) pending.push_back(std::move(right));
+        }
+    }
+}
+
+}
+
+std::size_t ASTNode::getSize() const {
+    return size;
+}
+
+std::size_t ASTNode::getHeight() const {
+    return height;
+}
+
+std::size_t ASTNode::getHash() const {
+    return hash;
+}
+
+std::uint64_t ASTNode::getVariableMask() const {
+    return variable_mask;
+}
+
+std::uint32_t ASTNode::getTypeMask() const {
+    return type_mask;
+}
+
+VariableNode::VariableNode(const std::string& name) : name(name) {
+    std::size_t name_hash = std::hash<std::string>()(name);
+    type_mask = typeBit(NodeType::VARIABLE);
+    variable_mask = std::uint64_t(1) << (name_hash % 64);
+    hash = mix(static_cast<std::size_t>(NodeType::VARIABLE) + 1, name_hash);
+}
 
 NodeType VariableNode::getType() const {
     return NodeType::VARIABLE;
@@ -27,7 +197,10 @@ const std::string& VariableNode::getName() const {
     return name;
 }
 
-ConstantNode::ConstantNode(bool value) : value(value) {}
+ConstantNode::ConstantNode(bool value) : value(value) {
+    type_mask = typeBit(NodeType::CONSTANT);
+    hash = mix(static_cast<std::size_t>(NodeType::CONSTANT) + 1, value);
+}
 
 NodeType ConstantNode::getType() const {
     return NodeType::CONSTANT;
@@ -52,32 +225,34 @@ bool ConstantNode::getValue() const {
 }
 
 UnaryOpNode::UnaryOpNode(NodeType op_type, std::unique_ptr<ASTNode> operand)
-    : op_type(op_type), operand(std::move(operand)) {}
+    : op_type(op_type), operand(std::move(operand)) {
+    const ASTNode& child = *this->operand;
+    size = child.getSize() + 1;
+    height = child.getHeight() + 1;
+    type_mask = child.getTypeMask() | typeBit(op_type);
+    variable_mask = child.getVariableMask();
+    hash = mix(static_cast<std::size_t>(op_type) + 1, child.getHash());
+}
+
+UnaryOpNode::~UnaryOpNode() {
+    dismantle(std::move(operand), nullptr);
+}
 
 NodeType UnaryOpNode::getType() const {
     return op_type;
 }
 
 std::string UnaryOpNode::toString() const {
-    std::ostringstream oss;
-    switch (op_type) {
-        case NodeType::NOT:
-            oss << "!" << operand->toString();
-            break;
-        default:
-            oss << "UNKNOWN_UNARY(" << operand->toString() << ")";
-    }
-    return oss.str();
+    return ExpressionWriter::toString(*this);
 }
 
 std::unique_ptr<ASTNode> UnaryOpNode::clone() const {
-    return std::make_unique<UnaryOpNode>(op_type, operand->clone());
+    return copyTree(*this);
 }
 
 bool UnaryOpNode::equals(const ASTNode& other) const {
     if (other.getType() != op_type) return false;
-    const auto& unary = static_cast<const UnaryOpNode&>(other);
-    return operand->equals(*unary.operand);
+    return sameTree(*this, other);
 }
 
 const ASTNode& UnaryOpNode::getOperand() const {
@@ -89,53 +264,41 @@ std::unique_ptr<ASTNode> UnaryOpNode::takeOperand() {
 }
 
 BinaryOpNode::BinaryOpNode(NodeType op_type, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right)
-    : op_type(op_type), left(std::move(left)), right(std::move(right)) {}
+    : op_type(op_type), left(std::move(left)), right(std::move(right)) {
+    const ASTNode& first = *this->left;
+    const ASTNode& second = *this->right;
+    size = first.getSize() + second.getSize() + 1;
+    height = std::max(first.getHeight(), second.getHeight()) + 1;
+    type_mask = first.getTypeMask() | second.getTypeMask() | typeBit(op_type);
+    variable_mask = first.getVariableMask() | second.getVariableMask();
+    std::size_t left_hash = first.getHash();
+    std::size_t right_hash = second.getHash();
+    if (isCommutative(op_type) && right_hash < left_hash) {
+        std::swap(left_hash, right_hash);
+    }
+    hash = mix(mix(static_cast<std::size_t>(op_type) + 1, left_hash), right_hash);
+}
+
+BinaryOpNode::~BinaryOpNode() {
+    dismantle(std::move(left), std::move(right));
+}
 
 NodeType BinaryOpNode::getType() const {
     return op_type;
 }
 
 std::string BinaryOpNode::toString() const {
-    std::ostringstream oss;
-    oss << "(" << left->toString();
-    
-    switch (op_type) {
-        case NodeType::AND:
-            oss << " & ";
-            break;
-        case NodeType::OR:
-            oss << " | ";
-            break;
-        case NodeType::IMPLIES:
-            oss << " -> ";
-            break;
-        case NodeType::BICONDITIONAL:
-            oss << " <-> ";
-            break;
-        default:
-            oss << " UNKNOWN_BINARY ";
-    }
-    
-    oss << right->toString() << ")";
-    return oss.str();
+    return ExpressionWriter::toString(*this);
 }
 
 std::unique_ptr<ASTNode> BinaryOpNode::clone() const {
-    return std::make_unique<BinaryOpNode>(op_type, left->clone(), right->clone());
+    return copyTree(*this);
 }
 
 bool BinaryOpNode::equals(const ASTNode& other) const {
     if (other.getType() != op_type) return false;
-    const auto& binary = static_cast<const BinaryOpNode&>(other);
-    
-    // For commutative operations (AND and OR), check both orderings
-    if (op_type == NodeType::AND || op_type == NodeType::OR) {
-        return (left->equals(*binary.left) && right->equals(*binary.right)) ||
-               (left->equals(*binary.right) && right->equals(*binary.left));
-    }
-    
-    // For non-commutative operations, order matters
-    return left->equals(*binary.left) && right->equals(*binary.right);
+    // AND and OR match in either operand order, at any depth
+    return sameTree(*this, other);
 }
 
 const ASTNode& BinaryOpNode::getLeft() const {
@@ -0,0 +1,363 @@
+#include "bdd.h"
+#include "flat_expr.h"
+#include <algorithm>
+#include <functional>
+
+namespace logixpr {
+
+namespace {
+
+const std::uint32_t TERMINAL_REF_COUNT = 1u << 30;
+const std::size_t INITIAL_GC_THRESHOLD = 1u << 16;
+
+std::size_t mixPointers(const void* a, const void* b, std::size_t seed) {
+    std::hash<const void*> hasher;
+    seed ^= hasher(a) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(b) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+}
+
+Bdd::Bdd() : manager(nullptr), node(nullptr) {}
+
+Bdd::Bdd(BddManager* manager, BddNode* node) : manager(manager), node(node) {
+    if (node) {
+        ++node->ref_count;
+    }
+}
+
+Bdd::Bdd(const Bdd& other) : manager(other.manager), node(other.node) {
+    if (node) {
+        ++node->ref_count;
+    }
+}
+
+Bdd::Bdd(Bdd&& other) noexcept : manager(other.manager), node(other.node) {
+    other.manager = nullptr;
+    other.node = nullptr;
+}
+
+Bdd& Bdd::operator=(const Bdd& other) {
+    if (this != &other) {
+        if (other.node) {
+            ++other.node->ref_count;
+        }
+        release();
+        manager = other.manager;
+        node = other.node;
+    }
+    return *this;
+}
+
+Bdd& Bdd::operator=(Bdd&& other) noexcept {
+    if (this != &other) {
+        release();
+        manager = other.manager;
+        node = other.node;
+        other.manager = nullptr;
+        other.node = nullptr;
+    }
+    return *this;
+}
+
+Bdd::~Bdd() {
+    release();
+}
+
+bool Bdd::operator==(const Bdd& other) const {
+    return node == other.node;
+}
+
+bool Bdd::operator!=(const Bdd& other) const {
+    return node != other.node;
+}
+
+bool Bdd::isTrue() const {
+    return manager && node == manager->true_node;
+}
+
+bool Bdd::isFalse() const {
+    return manager && node == manager->false_node;
+}
+
+bool Bdd::isConstant() const {
+    return node && node->level == BddManager::TERMINAL_LEVEL;
+}
+
+const BddNode* Bdd::getNode() const {
+    return node;
+}
+
+void Bdd::release() {
+    // Dead nodes stay in the unique table until the next collection, so a
+    // function that is rebuilt soon after is found again instead of recreated
+    if (node) {
+        --node->ref_count;
+        node = nullptr;
+    }
+}
+
+std::size_t BddHasher::operator()(const Bdd& bdd) const {
+    return std::hash<const void*>()(bdd.getNode());
+}
+
+bool BddManager::NodeKey::operator==(const NodeKey& other) const {
+    return level == other.level && low == other.low && high == other.high;
+}
+
+std::size_t BddManager::NodeKeyHasher::operator()(const NodeKey& key) const {
+    return mixPointers(key.low, key.high, key.level);
+}
+
+bool BddManager::IteKey::operator==(const IteKey& other) const {
+    return f == other.f && g == other.g && h == other.h;
+}
+
+std::size_t BddManager::IteKeyHasher::operator()(const IteKey& key) const {
+    return mixPointers(key.g, key.h, std::hash<const void*>()(key.f));
+}
+
+BddManager::BddManager() : gc_threshold(INITIAL_GC_THRESHOLD) {
+    storage.push_back({TERMINAL_LEVEL, nullptr, nullptr, TERMINAL_REF_COUNT});
+    false_node = &storage.back();
+    storage.push_back({TERMINAL_LEVEL, nullptr, nullptr, TERMINAL_REF_COUNT});
+    true_node = &storage.back();
+}
+
+BddManager::BddManager(const std::vector<std::string>& variable_order) : BddManager() {
+    for (const auto& name : variable_order) {
+        levelOf(name);
+    }
+}
+
+std::vector<std::string> BddManager::orderVariables(const std::vector<const ASTNode*>& expressions) {
+    // Depth-first first-occurrence order: variables that meet in the same
+    // subformulas end up at neighbouring levels, which keeps the diagrams of
+    // typical formulas narrow
+    VariableTable table;
+    for (const ASTNode* expression : expressions) {
+        FlatExpression::fromAST(*expression, table);
+    }
+
+    std::vector<std::string> order;
+    for (std::uint32_t id = 0; id < table.size(); ++id) {
+        order.push_back(table.getName(id));
+    }
+    return order;
+}
+
+Bdd BddManager::constant(bool value) {
+    return Bdd(this, value ? true_node : false_node);
+}
+
+Bdd BddManager::variable(const std::string& name) {
+    return Bdd(this, makeNode(levelOf(name), false_node, true_node));
+}
+
+Bdd BddManager::build(const ASTNode& expression) {
+    maybeCollectGarbage();
+
+    VariableTable table;
+    FlatExpression flat = FlatExpression::fromAST(expression, table);
+
+    std::vector<std::uint32_t> levels;
+    for (std::uint32_t id = 0; id < table.size(); ++id) {
+        levels.push_back(levelOf(table.getName(id)));
+    }
+
+    std::vector<Bdd> stack;
+    for (const auto& node : flat.getNodes()) {
+        switch (node.type) {
+            case NodeType::VARIABLE:
+                stack.emplace_back(this, makeNode(levels[node.value], false_node, true_node));
+                break;
+            case NodeType::CONSTANT:
+                stack.emplace_back(this, node.value ? true_node : false_node);
+                break;
+            case NodeType::NOT:
+                stack.back() = Bdd(this, iteNode(stack.back().node, false_node, true_node));
+                break;
+            default: {
+                Bdd right = std::move(stack.back());
+                stack.pop_back();
+                BddNode* left = stack.back().node;
+                BddNode* result = nullptr;
+                switch (node.type) {
+                    case NodeType::AND:
+                        result = iteNode(left, right.node, false_node);
+                        break;
+                    case NodeType::OR:
+                        result = iteNode(left, true_node, right.node);
+                        break;
+                    case NodeType::IMPLIES:
+                        result = iteNode(left, right.node, true_node);
+                        break;
+                    default: {
+                        Bdd negated_right(this, iteNode(right.node, false_node, true_node));
+                        result = iteNode(left, right.node, negated_right.node);
+                        break;
+                    }
+                }
+                stack.back() = Bdd(this, result);
+                break;
+            }
+        }
+    }
+
+    return stack.back();
+}
+
+Bdd BddManager::ite(const Bdd& f, const Bdd& g, const Bdd& h) {
+    maybeCollectGarbage();
+    return Bdd(this, iteNode(f.node, g.node, h.node));
+}
+
+Bdd BddManager::negate(const Bdd& f) {
+    return ite(f, constant(false), constant(true));
+}
+
+Bdd BddManager::conjunction(const Bdd& f, const Bdd& g) {
+    return ite(f, g, constant(false));
+}
+
+Bdd BddManager::disjunction(const Bdd& f, const Bdd& g) {
+    return ite(f, constant(true), g);
+}
+
+Bdd BddManager::implication(const Bdd& f, const Bdd& g) {
+    return ite(f, g, constant(true));
+}
+
+Bdd BddManager::biconditional(const Bdd& f, const Bdd& g) {
+    return ite(f, g, negate(g));
+}
+
+Bdd BddManager::cofactor(const Bdd& f, std::uint32_t level, bool value) {
+    return Bdd(this, cofactor(f.node, level, value));
+}
+
+bool BddManager::evaluate(const Bdd& f, const std::vector<bool>& assignment) const {
+    const BddNode* node = f.node;
+    while (node->level != TERMINAL_LEVEL) {
+        bool value = node->level < assignment.size() && assignment[node->level];
+        node = value ? node->high : node->low;
+    }
+    return node == true_node;
+}
+
+const std::vector<std::string>& BddManager::getVariableOrder() const {
+    return variable_order;
+}
+
+std::uint32_t BddManager::levelOf(const std::string& name) {
+    auto it = variable_levels.find(name);
+    if (it != variable_levels.end()) {
+        return it->second;
+    }
+    // New variables go below every existing level, which leaves all
+    // previously built diagrams valid
+    std::uint32_t level = static_cast<std::uint32_t>(variable_order.size());
+    variable_order.push_back(name);
+    variable_levels.emplace(name, level);
+    return level;
+}
+
+std::size_t BddManager::nodeCount() const {
+    return unique_table.size();
+}
+
+std::size_t BddManager::collectGarbage() {
+    std::vector<BddNode*> dead;
+    for (const auto& entry : unique_table) {
+        if (entry.second->ref_count == 0) {
+            dead.push_back(entry.second);
+        }
+    }
+
+    std::size_t freed = 0;
+    while (!dead.empty()) {
+        BddNode* node = dead.back();
+        dead.pop_back();
+
+        unique_table.erase({node->level, node->low, node->high});
+        for (BddNode* child : {node->low, node->high}) {
+            if (--child->ref_count == 0 && child->level != TERMINAL_LEVEL) {
+                dead.push_back(child);
+            }
+        }
+        free_nodes.push_back(node);
+        ++freed;
+    }
+
+    computed_cache.clear();
+    return freed;
+}
+
+BddNode* BddManager::makeNode(std::uint32_t level, BddNode* low, BddNode* high) {
+    if (low == high) {
+        return low;
+    }
+
+    NodeKey key{level, low, high};
+    auto it = unique_table.find(key);
+    if (it != unique_table.end()) {
+        return it->second;
+    }
+
+    BddNode* node = nullptr;
+    if (!free_nodes.empty()) {
+        node = free_nodes.back();
+        free_nodes.pop_back();
+        *node = {level, low, high, 0};
+    } else {
+        storage.push_back({level, low, high, 0});
+        node = &storage.back();
+    }
+
+    // Children are referenced by their parents so that collection cascades
+    ++low->ref_count;
+    ++high->ref_count;
+    unique_table.emplace(key, node);
+    return node;
+}
+
+BddNode* BddManager::iteNode(BddNode* f, BddNode* g, BddNode* h) {
+    if (f == true_node) return g;
+    if (f == false_node) return h;
+    if (g == h) return g;
+    if (g == true_node && h == false_node) return f;
+
+    IteKey key{f, g, h};
+    auto cached = computed_cache.find(key);
+    if (cached != computed_cache.end()) {
+        return cached->second;
+    }
+
+    std::uint32_t top = std::min({f->level, g->level, h->level});
+    BddNode* high = iteNode(cofactor(f, top, true), cofactor(g, top, true), cofactor(h, top, true));
+    BddNode* low = iteNode(cofactor(f, top, false), cofactor(g, top, false), cofactor(h, top, false));
+    BddNode* result = makeNode(top, low, high);
+
+    computed_cache.emplace(key, result);
+    return result;
+}
+
+BddNode* BddManager::cofactor(BddNode* node, std::uint32_t level, bool value) const {
+    if (node->level != level) {
+        return node;
+    }
+    return value ? node->high : node->low;
+}
+
+void BddManager::maybeCollectGarbage() {
+    if (unique_table.size() < gc_threshold) {
+        return;
+    }
+    collectGarbage();
+    if (unique_table.size() * 2 > gc_threshold) {
+        gc_threshold *= 2;
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include "binary_format.h"
+#include "law_config.h"
+#include "logic_laws.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace logixpr {
+
+namespace {
+
+const char MAGIC[4] = {'L', 'X', 'P', 'B'};
+
+const std::uint8_t TAG_VARIABLE = 1;
+const std::uint8_t TAG_EXPRESSION = 2;
+const std::uint8_t TAG_PROOF = 3;
+
+const std::uint8_t PROOF_FOUND_TARGET = 1;
+const std::uint8_t PROOF_REFUTED = 2;
+
+// Step descriptions are almost always the law name, optionally reversed
+const std::uint64_t DESCRIPTION_LAW_NAME = 0;
+const std::uint64_t DESCRIPTION_REVERSED = 1;
+const std::uint64_t DESCRIPTION_TEXT = 2;
+
+const std::string REVERSED_SUFFIX = " (reversed)";
+
+const std::uint64_t NODE_TYPE_COUNT = static_cast<std::uint64_t>(NodeType::BICONDITIONAL) + 1;
+
+// Upper bound on up-front reservations so a corrupt count cannot force a huge allocation
+const std::size_t MAX_RESERVE = 1 << 16;
+
+void putVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void putString(std::string& out, const std::string& text) {
+    putVarint(out, text.size());
+    out += text;
+}
+
+}
+
+FormatError::FormatError(const std::string& msg, std::size_t offset) : message(msg), offset(offset) {}
+
+const char* FormatError::what() const noexcept {
+    return message.c_str();
+}
+
+std::size_t FormatError::getOffset() const {
+    return offset;
+}
+
+BinaryWriter::BinaryWriter(std::ostream& out) : out(out) {
+    buffer.append(MAGIC, sizeof(MAGIC));
+    buffer += static_cast<char>(VERSION);
+    flush();
+}
+
+void BinaryWriter::writeExpression(const ASTNode& expression) {
+    std::size_t first_new = variables.size();
+    FlatExpression flat = FlatExpression::fromAST(expression, variables);
+    defineNewVariables(first_new);
+    buffer += static_cast<char>(TAG_EXPRESSION);
+    encodeExpression(flat);
+    flush();
+}
+
+void BinaryWriter::writeExpression(const FlatExpression& expression, const VariableTable& expression_variables) {
+    std::size_t first_new = variables.size();
+    std::vector<FlatNode> nodes = expression.getNodes();
+    for (auto& node : nodes) {
+        if (node.type == NodeType::VARIABLE) {
+            node.value = variables.intern(expression_variables.getName(node.value));
+        }
+    }
+    defineNewVariables(first_new);
+    buffer += static_cast<char>(TAG_EXPRESSION);
+    encodeExpression(FlatExpression(std::move(nodes)));
+    flush();
+}
+
+void BinaryWriter::writeProof(const Proof& proof) {
+    std::size_t first_new = variables.size();
+    std::vector<FlatExpression> expressions;
+    expressions.reserve(proof.steps.size());
+    for (const auto& step : proof.steps) {
+        expressions.push_back(FlatExpression::fromAST(*step.expression, variables));
+    }
+    std::vector<std::uint32_t> counterexample_ids;
+    for (const auto& assignment : proof.counterexample) {
+        counterexample_ids.push_back(variables.intern(assignment.first));
+    }
+    defineNewVariables(first_new);
+
+    buffer += static_cast<char>(TAG_PROOF);
+    buffer += static_cast<char>((proof.found_target ? PROOF_FOUND_TARGET : 0) | (proof.refuted ? PROOF_REFUTED : 0));
+    putVarint(buffer, proof.steps.size());
+    for (std::size_t i = 0; i < proof.steps.size(); ++i) {
+        const ProofStep& step = proof.steps[i];
+        putVarint(buffer, static_cast<std::uint64_t>(step.law_applied));
+        putVarint(buffer, static_cast<std::uint64_t>(std::max(step.step_number, 0)));
+
+        std::string law_name = LogicLaws::getLawName(step.law_applied);
+        if (step.description == law_name) {
+            putVarint(buffer, DESCRIPTION_LAW_NAME);
+        } else if (step.description == law_name + REVERSED_SUFFIX) {
+            putVarint(buffer, DESCRIPTION_REVERSED);
+        } else {
+            putVarint(buffer, DESCRIPTION_TEXT);
+            putString(buffer, step.description);
+        }
+        encodeExpression(expressions[i]);
+    }
+
+    putVarint(buffer, proof.counterexample.size());
+    for (std::size_t i = 0; i < proof.counterexample.size(); ++i) {
+        putVarint(buffer, counterexample_ids[i]);
+        buffer += static_cast<char>(proof.counterexample[i].second ? 1 : 0);
+    }
+    flush();
+}
+
+void BinaryWriter::defineNewVariables(std::size_t first_new) {
+    for (std::size_t id = first_new; id < variables.size(); ++id) {
+        buffer += static_cast<char>(TAG_VARIABLE);
+        putString(buffer, variables.getName(static_cast<std::uint32_t>(id)));
+    }
+}
+
+void BinaryWriter::encodeExpression(const FlatExpression& expression) {
+    putVarint(buffer, expression.size());
+    for (const auto& node : expression.getNodes()) {
+        buffer += static_cast<char>(node.type);
+        if (node.type != NodeType::NOT) {
+            putVarint(buffer, node.value);
+        }
+    }
+}
+
+void BinaryWriter::flush() {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+    if (!out) {
+        throw std::runtime_error("Failed to write binary output");
+    }
+}
+
+BinaryReader::BinaryReader(const std::uint8_t* data, std::size_t size)
+    : data(data), size(size), in(nullptr), offset(0), pending_tag(-1) {
+    readHeader();
+}
+
+BinaryReader::BinaryReader(std::istream& in)
+    : data(nullptr), size(0), in(&in), offset(0), pending_tag(-1) {
+    readHeader();
+}
+
+RecordType BinaryReader::next() {
+    while (pending_tag < 0) {
+        if (atEnd()) {
+            return RecordType::END;
+        }
+        std::size_t tag_offset = offset;
+        std::uint8_t tag = readByte();
+        if (tag == TAG_VARIABLE) {
+            std::string name = readString();
+            std::uint32_t expected = static_cast<std::uint32_t>(variables.size());
+            if (variables.intern(name) != expected) {
+                throw FormatError("Variable defined twice: " + name, tag_offset);
+            }
+        } else if (tag == TAG_EXPRESSION || tag == TAG_PROOF) {
+            pending_tag = tag;
+        } else {
+            throw FormatError("Unknown record tag", tag_offset);
+        }
+    }
+    return pending_tag == TAG_EXPRESSION ? RecordType::EXPRESSION : RecordType::PROOF;
+}
+
+std::unique_ptr<ASTNode> BinaryReader::readExpression() {
+    return readFlatExpression().toAST(variables);
+}
+
+FlatExpression BinaryReader::readFlatExpression() {
+    expectRecord(RecordType::EXPRESSION);
+    return decodeExpression();
+}
+
+Proof BinaryReader::readProof() {
+    expectRecord(RecordType::PROOF);
+
+    Proof proof;
+    std::size_t flags_offset = offset;
+    std::uint8_t flags = readByte();
+    if (flags & ~(PROOF_FOUND_TARGET | PROOF_REFUTED)) {
+        throw FormatError("Unknown proof flags", flags_offset);
+    }
+    proof.found_target = (flags & PROOF_FOUND_TARGET) != 0;
+    proof.refuted = (flags & PROOF_REFUTED) != 0;
+
+    std::uint64_t step_count = readVarint();
+    proof.steps.reserve(std::min<std::uint64_t>(step_count, MAX_RESERVE));
+    for (std::uint64_t i = 0; i < step_count; ++i) {
+        std::size_t step_offset = offset;
+        std::uint64_t law_id = readVarint();
+        if (law_id >= LAW_COUNT) {
+            throw FormatError("Unknown law id", step_offset);
+        }
+        LogicLaw law = static_cast<LogicLaw>(law_id);
+        std::uint64_t step_number = readVarint();
+        if (step_number > static_cast<std::uint64_t>(INT32_MAX)) {
+            throw FormatError("Step number out of range", step_offset);
+        }
+
+        std::string description = LogicLaws::getLawName(law);
+        std::uint64_t description_kind = readVarint();
+        if (description_kind == DESCRIPTION_REVERSED) {
+            description += REVERSED_SUFFIX;
+        } else if (description_kind == DESCRIPTION_TEXT) {
+            description = readString();
+        } else if (description_kind != DESCRIPTION_LAW_NAME) {
+            throw FormatError("Unknown step description kind", step_offset);
+        }
+
+        auto expression = decodeExpression().toAST(variables);
+        proof.steps.emplace_back(std::move(expression), law, description, static_cast<int>(step_number));
+    }
+    proof.total_steps = static_cast<int>(proof.steps.size());
+
+    std::uint64_t assignment_count = readVarint();
+    for (std::uint64_t i = 0; i < assignment_count; ++i) {
+        std::size_t assignment_offset = offset;
+        std::uint64_t id = readVarint();
+        if (id >= variables.size()) {
+            throw FormatError("Undefined variable id", assignment_offset);
+        }
+        std::uint8_t value = readByte();
+        if (value > 1) {
+            throw FormatError("Invalid truth value", assignment_offset);
+        }
+        proof.counterexample.emplace_back(variables.getName(static_cast<std::uint32_t>(id)), value == 1);
+    }
+    return proof;
+}
+
+const VariableTable& BinaryReader::getVariables() const {
+    return variables;
+}
+
+std::size_t BinaryReader::getOffset() const {
+    return offset;
+}
+
+void BinaryReader::readHeader() {
+    for (char expected : MAGIC) {
+        if (atEnd() || readByte() != static_cast<std::uint8_t>(expected)) {
+            throw FormatError("Not a LogiXpr binary file", 0);
+        }
+    }
+    if (atEnd()) {
+        throw FormatError("Truncated header", offset);
+    }
+    std::uint8_t version = readByte();
+    if (version == 0 || version > BinaryWriter::VERSION) {
+        throw FormatError("Unsupported format version " + std::to_string(version), offset - 1);
+    }
+}
+
+bool BinaryReader::atEnd() {
+    if (in) {
+        return in->peek() == std::char_traits<char>::eof();
+    }
+    return offset >= size;
+}
+
+std::uint8_t BinaryReader::readByte() {
+    if (in) {
+        int c = in->get();
+        if (c == std::char_traits<char>::eof()) {
+            throw FormatError("Unexpected end of input", offset);
+        }
+        ++offset;
+        return static_cast<std::uint8_t>(c);
+    }
+    if (offset >= size) {
+        throw FormatError("Unexpected end of input", offset);
+    }
+    return data[offset++];
+}
+
+std::uint64_t BinaryReader::readVarint() {
+    std::size_t start = offset;
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte = readByte();
+        std::uint64_t bits = byte & 0x7F;
+        if (shift == 63 && bits > 1) {
+            break;
+        }
+        value |= bits << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw FormatError("Varint overflow", start);
+}
+
+std::string BinaryReader::readString() {
+    std::size_t start = offset;
+    std::uint64_t length = readVarint();
+    if (!in && length > size - offset) {
+        throw FormatError("String runs past end of input", start);
+    }
+    std::string text;
+    text.reserve(std::min<std::uint64_t>(length, MAX_RESERVE));
+    for (std::uint64_t i = 0; i < length; ++i) {
+        text += static_cast<char>(readByte());
+    }
+    return text;
+}
+
+void BinaryReader::expectRecord(RecordType type) {
+    std::size_t record_offset = offset;
+    if (next() != type) {
+        throw FormatError(type == RecordType::PROOF ? "Expected a proof record" : "Expected an expression record",
+                          record_offset);
+    }
+    pending_tag = -1;
+}
+
+FlatExpression BinaryReader::decodeExpression() {
+    std::size_t start = offset;
+    std::uint64_t node_count = readVarint();
+    if (node_count == 0 || node_count > UINT32_MAX || (!in && node_count > size - offset)) {
+        throw FormatError("Invalid expression length", start);
+    }
+
+    std::vector<FlatNode> nodes;
+    nodes.reserve(std::min<std::uint64_t>(node_count, MAX_RESERVE));
+    for (std::uint64_t i = 0; i < node_count; ++i) {
+        std::size_t node_offset = offset;
+        std::uint8_t type_id = readByte();
+        if (type_id >= NODE_TYPE_COUNT) {
+            throw FormatError("Unknown node type", node_offset);
+        }
+        NodeType type = static_cast<NodeType>(type_id);
+        std::uint64_t value = type == NodeType::NOT ? 0 : readVarint();
+        if ((type == NodeType::VARIABLE && value >= variables.size()) ||
+            (type == NodeType::CONSTANT && value > 1) || value > UINT32_MAX) {
+            throw FormatError("Invalid node value", node_offset);
+        }
+        nodes.push_back({type, static_cast<std::uint32_t>(value)});
+    }
+
+    // relink() recomputes the child distances; any disagreement with the
+    // stored ones means the record is corrupt
+    std::vector<FlatNode> stored = nodes;
+    FlatExpression expression;
+    try {
+        expression = FlatExpression(std::move(nodes));
+    } catch (const std::logic_error&) {
+        throw FormatError("Malformed expression", start);
+    }
+    for (std::size_t i = 0; i < stored.size(); ++i) {
+        if (stored[i].value != expression.getNode(i).value) {
+            throw FormatError("Inconsistent child reference", start);
+        }
+    }
+    return expression;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "canonical.h"
+#include "expression_writer.h"
+#include <stdexcept>
+
+namespace logixpr {
+
+namespace {
+
+template <typename Rename>
+std::unique_ptr<ASTNode> renameVariables(const ASTNode& expression, Rename rename) {
+    return foldTree<std::unique_ptr<ASTNode>>(
+        expression,
+        [&](const ASTNode& leaf) -> std::unique_ptr<ASTNode> {
+            if (leaf.getType() == NodeType::VARIABLE) {
+                return std::make_unique<VariableNode>(rename(static_cast<const VariableNode&>(leaf).getName()));
+            }
+            return leaf.clone();
+        },
+        [](const UnaryOpNode& node, std::unique_ptr<ASTNode> operand) -> std::unique_ptr<ASTNode> {
+            return std::make_unique<UnaryOpNode>(node.getType(), std::move(operand));
+        },
+        [](const BinaryOpNode& node, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right) -> std::unique_ptr<ASTNode> {
+            return std::make_unique<BinaryOpNode>(node.getType(), std::move(left), std::move(right));
+        });
+}
+
+std::size_t parseCanonicalName(const std::string& name) {
+    if (name.size() < 2 || name[0] != 'v') {
+        throw std::invalid_argument("Not a canonical variable: " + name);
+    }
+    return std::stoul(name.substr(1));
+}
+
+}
+
+void VariableRenaming::assign(const ASTNode& expression) {
+    foldTree<int>(
+        expression,
+        [this](const ASTNode& leaf) {
+            if (leaf.getType() == NodeType::VARIABLE) {
+                const std::string& name = static_cast<const VariableNode&>(leaf).getName();
+                if (canonical_ids.emplace(name, originals.size()).second) {
+                    originals.push_back(name);
+                }
+            }
+            return 0;
+        },
+        [](const UnaryOpNode&, int) { return 0; },
+        [](const BinaryOpNode&, int, int) { return 0; });
+}
+
+std::unique_ptr<ASTNode> VariableRenaming::toCanonical(const ASTNode& expression) const {
+    return renameVariables(expression, [this](const std::string& name) {
+        auto it = canonical_ids.find(name);
+        if (it == canonical_ids.end()) {
+            throw std::invalid_argument("Variable not covered by renaming: " + name);
+        }
+        return canonicalName(it->second);
+    });
+}
+
+std::unique_ptr<ASTNode> VariableRenaming::toOriginal(const ASTNode& expression) const {
+    return renameVariables(expression, [this](const std::string& name) {
+        return getOriginalName(parseCanonicalName(name));
+    });
+}
+
+Proof VariableRenaming::toOriginal(const Proof& proof) const {
+    Proof renamed;
+    renamed.found_target = proof.found_target;
+    renamed.total_steps = proof.total_steps;
+    renamed.refuted = proof.refuted;
+    for (const auto& step : proof.steps) {
+        renamed.steps.emplace_back(toOriginal(*step.expression), step.law_applied, step.description, step.step_number);
+    }
+    for (const auto& [name, value] : proof.counterexample) {
+        renamed.counterexample.emplace_back(getOriginalName(parseCanonicalName(name)), value);
+    }
+    return renamed;
+}
+
+std::size_t VariableRenaming::size() const {
+    return originals.size();
+}
+
+const std::string& VariableRenaming::getOriginalName(std::size_t id) const {
+    if (id >= originals.size()) {
+        throw std::out_of_range("Canonical variable out of range: " + canonicalName(id));
+    }
+    return originals[id];
+}
+
+std::string VariableRenaming::canonicalName(std::size_t id) {
+    return "v" + std::to_string(id);
+}
+
+CanonicalPair canonicalizePair(const ASTNode& start_expression, const ASTNode& target_expression) {
+    CanonicalPair pair;
+    pair.renaming.assign(start_expression);
+    pair.renaming.assign(target_expression);
+    pair.start = pair.renaming.toCanonical(start_expression);
+    pair.target = pair.renaming.toCanonical(target_expression);
+
+    ExpressionWriter writer;
+    writer.write(*pair.start).append('\t').write(*pair.target);
+    pair.key = writer.release();
+    return pair;
+}
+
+}
\ No newline at end of file
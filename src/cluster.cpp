@@ -0,0 +1,188 @@
+#include "cluster.h"
+#include "bdd.h"
+#include "evaluator.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace logixpr {
+
+namespace {
+
+const std::uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ull;
+
+std::uint64_t splitMix(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// A signature inside the flat signature array
+struct SignatureKey {
+    const std::uint64_t* words;
+    std::size_t count;
+
+    bool operator==(const SignatureKey& other) const {
+        return std::memcmp(words, other.words, count * sizeof(std::uint64_t)) == 0;
+    }
+};
+
+struct SignatureKeyHasher {
+    std::size_t operator()(const SignatureKey& key) const {
+        std::uint64_t hash = key.count;
+        for (std::size_t i = 0; i < key.count; ++i) {
+            hash = splitMix(hash ^ key.words[i]);
+        }
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+}
+
+EquivalenceClusterer::EquivalenceClusterer()
+    : signature_words(4), threads(1), with_proofs(false), seed(DEFAULT_SEED), proof_max_depth(10) {}
+
+std::vector<std::uint64_t> EquivalenceClusterer::signature(const ASTNode& formula) const {
+    CompiledExpression compiled = CompiledExpression::compile(formula);
+    const auto& names = compiled.getVariables();
+    std::vector<std::uint64_t> name_seeds(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        name_seeds[i] = splitMix(seed ^ std::hash<std::string>()(names[i]));
+    }
+
+    std::vector<std::uint64_t> words(std::max<std::size_t>(names.size(), 1));
+    std::vector<std::uint64_t> result(signature_words);
+    for (std::size_t w = 0; w < signature_words; ++w) {
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            words[i] = splitMix(name_seeds[i] + w);
+        }
+        result[w] = compiled.evaluateBatch(words.data());
+    }
+    return result;
+}
+
+std::vector<EquivalenceClass> EquivalenceClusterer::cluster(const std::vector<const ASTNode*>& formulas) const {
+    ThreadPool& pool = executor ? *executor : *ProofSearch::defaultExecutor();
+    std::size_t thread_count = threads == 0 ? pool.size() : threads;
+    // Each worker strides over its share of items
+    auto runWorkers = [&](std::size_t items, const std::function<void(std::size_t, std::size_t)>& work) {
+        std::size_t workers = std::max<std::size_t>(std::min(thread_count, items), 1);
+        if (workers == 1) {
+            work(0, 1);
+        } else {
+            pool.parallelFor(workers, workers, [&](std::size_t worker) { work(worker, workers); });
+        }
+    };
+
+    std::vector<std::uint64_t> signatures(formulas.size() * signature_words);
+    runWorkers(formulas.size(), [&](std::size_t worker, std::size_t workers) {
+        for (std::size_t i = worker; i < formulas.size(); i += workers) {
+            auto words = signature(*formulas[i]);
+            std::copy(words.begin(), words.end(), signatures.begin() + i * signature_words);
+        }
+    });
+
+    // Buckets in order of their first formula, members ascending
+    std::vector<std::vector<std::size_t>> buckets;
+    {
+        std::unordered_map<SignatureKey, std::size_t, SignatureKeyHasher> bucket_ids;
+        bucket_ids.reserve(formulas.size());
+        for (std::size_t i = 0; i < formulas.size(); ++i) {
+            SignatureKey key{signatures.data() + i * signature_words, signature_words};
+            auto inserted = bucket_ids.emplace(key, buckets.size());
+            if (inserted.second) {
+                buckets.emplace_back();
+            }
+            buckets[inserted.first->second].push_back(i);
+        }
+    }
+
+    std::vector<std::vector<EquivalenceClass>> bucket_classes(buckets.size());
+    runWorkers(buckets.size(), [&](std::size_t worker, std::size_t workers) {
+        ProofSearch searcher(proof_max_depth);
+        for (std::size_t b = worker; b < buckets.size(); b += workers) {
+            const auto& bucket = buckets[b];
+            auto& classes = bucket_classes[b];
+            if (bucket.size() == 1) {
+                classes.push_back({bucket, bucket.front(), {}});
+            } else {
+                std::vector<const ASTNode*> members;
+                for (std::size_t index : bucket) {
+                    members.push_back(formulas[index]);
+                }
+                // Equal signatures almost always mean equal functions; the
+                // BDDs settle it exactly
+                BddManager manager(BddManager::orderVariables(members));
+                std::unordered_map<Bdd, std::size_t, BddHasher> class_ids;
+                for (std::size_t index : bucket) {
+                    auto inserted = class_ids.emplace(manager.build(*formulas[index]), classes.size());
+                    if (inserted.second) {
+                        classes.push_back({{}, index, {}});
+                    }
+                    classes[inserted.first->second].members.push_back(index);
+                }
+            }
+
+            for (auto& equivalence_class : classes) {
+                for (std::size_t index : equivalence_class.members) {
+                    if (formulas[index]->getSize() < formulas[equivalence_class.representative]->getSize()) {
+                        equivalence_class.representative = index;
+                    }
+                }
+                if (!with_proofs) {
+                    continue;
+                }
+                const ASTNode& representative = *formulas[equivalence_class.representative];
+                for (std::size_t index : equivalence_class.members) {
+                    if (index == equivalence_class.representative) {
+                        Proof identity;
+                        identity.found_target = true;
+                        equivalence_class.proofs.push_back(std::move(identity));
+                    } else {
+                        equivalence_class.proofs.push_back(searcher.findProof(*formulas[index], representative));
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<EquivalenceClass> result;
+    for (auto& classes : bucket_classes) {
+        for (auto& equivalence_class : classes) {
+            result.push_back(std::move(equivalence_class));
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const EquivalenceClass& a, const EquivalenceClass& b) {
+        return a.members.front() < b.members.front();
+    });
+    return result;
+}
+
+void EquivalenceClusterer::setSignatureWords(std::size_t words) {
+    signature_words = std::max<std::size_t>(words, 1);
+}
+
+void EquivalenceClusterer::setThreads(std::size_t thread_count) {
+    threads = thread_count;
+}
+
+void EquivalenceClusterer::setExecutor(std::shared_ptr<ThreadPool> pool) {
+    executor = std::move(pool);
+}
+
+void EquivalenceClusterer::setProofs(bool enabled) {
+    with_proofs = enabled;
+}
+
+void EquivalenceClusterer::setProofMaxDepth(int depth) {
+    proof_max_depth = depth;
+}
+
+void EquivalenceClusterer::setSeed(std::uint64_t value) {
+    seed = value;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,671 @@
+#include "egraph.h"
+#include "parser.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_set>
+
+namespace logixpr {
+
+namespace {
+
+const std::uint32_t UNBOUND = std::numeric_limits<std::uint32_t>::max();
+
+struct PatternNode {
+    NodeType type;
+    std::uint32_t value;
+    std::size_t children[2];
+};
+
+// Patterns are stored in postorder, so the root is the last node
+struct Pattern {
+    std::vector<PatternNode> nodes;
+};
+
+struct RewriteRule {
+    LogicLaw law;
+    Pattern lhs;
+    Pattern rhs;
+    std::size_t variable_count;
+    std::uint32_t guard_variable;
+    NodeType guard_type;
+};
+
+struct RuleSpec {
+    LogicLaw law;
+    const char* lhs;
+    const char* rhs;
+    const char* guard_variable;
+    NodeType guard_type;
+};
+
+// One entry per shape that the corresponding LogicLaws::apply* function
+// accepts. A guard skips matches where the bound node has the given type,
+// because the law function would rewrite the other operand first; this keeps
+// every extracted step reproducible with EquivalenceEngine.
+const RuleSpec RULE_SPECS[] = {
+    {LogicLaw::DOUBLE_NEGATION, "!!a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::DE_MORGAN_AND, "!(a & b)", "!a | !b", nullptr, NodeType::VARIABLE},
+    {LogicLaw::DE_MORGAN_OR, "!(a | b)", "!a & !b", nullptr, NodeType::VARIABLE},
+    {LogicLaw::DISTRIBUTIVE_AND_OVER_OR, "a & (b | c)", "(a & b) | (a & c)", nullptr, NodeType::VARIABLE},
+    {LogicLaw::DISTRIBUTIVE_AND_OVER_OR, "(b | c) & a", "(b & a) | (c & a)", "a", NodeType::OR},
+    {LogicLaw::DISTRIBUTIVE_OR_OVER_AND, "a | (b & c)", "(a | b) & (a | c)", nullptr, NodeType::VARIABLE},
+    {LogicLaw::DISTRIBUTIVE_OR_OVER_AND, "(b & c) | a", "(b | a) & (c | a)", "a", NodeType::AND},
+    {LogicLaw::ABSORPTION_AND, "a & (a | b)", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_AND, "a & (b | a)", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_AND, "(a | b) & a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_AND, "(b | a) & a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_OR, "a | (a & b)", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_OR, "a | (b & a)", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_OR, "(a & b) | a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ABSORPTION_OR, "(b & a) | a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::IDENTITY_AND, "T & a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::IDENTITY_AND, "a & T", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::IDENTITY_OR, "F | a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::IDENTITY_OR, "a | F", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ANNIHILATION_AND, "F & a", "F", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ANNIHILATION_AND, "a & F", "F", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ANNIHILATION_OR, "T | a", "T", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ANNIHILATION_OR, "a | T", "T", nullptr, NodeType::VARIABLE},
+    {LogicLaw::COMPLEMENT_AND, "!a & a", "F", nullptr, NodeType::VARIABLE},
+    {LogicLaw::COMPLEMENT_AND, "a & !a", "F", nullptr, NodeType::VARIABLE},
+    {LogicLaw::COMPLEMENT_OR, "!a | a", "T", nullptr, NodeType::VARIABLE},
+    {LogicLaw::COMPLEMENT_OR, "a | !a", "T", nullptr, NodeType::VARIABLE},
+    {LogicLaw::IDEMPOTENT_AND, "a & a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::IDEMPOTENT_OR, "a | a", "a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::COMMUTATIVE_AND, "a & b", "b & a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::COMMUTATIVE_OR, "a | b", "b | a", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ASSOCIATIVE_AND, "(a & b) & c", "a & (b & c)", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ASSOCIATIVE_AND, "a & (b & c)", "(a & b) & c", "a", NodeType::AND},
+    {LogicLaw::ASSOCIATIVE_OR, "(a | b) | c", "a | (b | c)", nullptr, NodeType::VARIABLE},
+    {LogicLaw::ASSOCIATIVE_OR, "a | (b | c)", "(a | b) | c", "a", NodeType::OR},
+    {LogicLaw::IMPLICATION_ELIMINATION, "a -> b", "!a | b", nullptr, NodeType::VARIABLE},
+    {LogicLaw::BICONDITIONAL_ELIMINATION, "a <-> b", "(a -> b) & (b -> a)", nullptr, NodeType::VARIABLE}
+};
+
+Pattern compilePattern(const std::string& text, VariableTable& pattern_variables) {
+    FlatExpression flat = FlatExpression::fromAST(*ExpressionParser::parse(text), pattern_variables);
+
+    Pattern pattern;
+    for (std::size_t i = 0; i < flat.size(); ++i) {
+        const FlatNode& node = flat.getNode(i);
+        PatternNode pattern_node{node.type, 0, {0, 0}};
+        if (node.type == NodeType::VARIABLE || node.type == NodeType::CONSTANT) {
+            pattern_node.value = node.value;
+        } else if (node.type == NodeType::NOT) {
+            pattern_node.children[0] = flat.operandOf(i);
+        } else {
+            pattern_node.children[0] = flat.leftChild(i);
+            pattern_node.children[1] = flat.rightChild(i);
+        }
+        pattern.nodes.push_back(pattern_node);
+    }
+    return pattern;
+}
+
+const std::vector<RewriteRule>& rewriteRules() {
+    static const std::vector<RewriteRule> rules = [] {
+        std::vector<RewriteRule> compiled;
+        for (const auto& spec : RULE_SPECS) {
+            VariableTable pattern_variables;
+            Pattern lhs = compilePattern(spec.lhs, pattern_variables);
+            Pattern rhs = compilePattern(spec.rhs, pattern_variables);
+            std::uint32_t guard_variable = UNBOUND;
+            if (spec.guard_variable) {
+                pattern_variables.lookup(spec.guard_variable, guard_variable);
+            }
+            compiled.push_back({spec.law, std::move(lhs), std::move(rhs), pattern_variables.size(),
+                                guard_variable, spec.guard_type});
+        }
+        return compiled;
+    }();
+    return rules;
+}
+
+using Bindings = std::vector<std::uint32_t>;
+
+std::vector<Bindings> matchPattern(EGraph& graph, const Pattern& pattern, std::size_t index,
+                                   std::uint32_t id, std::vector<Bindings> states) {
+    const PatternNode& pattern_node = pattern.nodes[index];
+    std::vector<Bindings> result;
+
+    if (pattern_node.type == NodeType::VARIABLE) {
+        for (auto& state : states) {
+            std::uint32_t& binding = state[pattern_node.value];
+            if (binding == UNBOUND) {
+                binding = id;
+                result.push_back(std::move(state));
+            } else if (graph.find(binding) == graph.find(id)) {
+                result.push_back(std::move(state));
+            }
+        }
+        return result;
+    }
+
+    for (std::uint32_t member : graph.classMembers(graph.find(id))) {
+        const ENode& node = graph.getNode(member);
+        if (node.type != pattern_node.type) {
+            continue;
+        }
+        if (node.type == NodeType::CONSTANT) {
+            if (node.value == pattern_node.value) {
+                result.insert(result.end(), states.begin(), states.end());
+            }
+            continue;
+        }
+
+        std::vector<Bindings> partial = states;
+        partial = matchPattern(graph, pattern, pattern_node.children[0], node.children[0], std::move(partial));
+        if (node.type != NodeType::NOT) {
+            partial = matchPattern(graph, pattern, pattern_node.children[1], node.children[1], std::move(partial));
+        }
+        for (auto& state : partial) {
+            result.push_back(std::move(state));
+        }
+    }
+    return result;
+}
+
+std::uint32_t instantiatePattern(EGraph& graph, const Pattern& pattern, const Bindings& bindings) {
+    std::vector<std::uint32_t> stack;
+    for (const auto& pattern_node : pattern.nodes) {
+        switch (pattern_node.type) {
+            case NodeType::VARIABLE:
+                stack.push_back(bindings[pattern_node.value]);
+                break;
+            case NodeType::CONSTANT:
+                stack.push_back(graph.add({NodeType::CONSTANT, pattern_node.value, {0, 0}}));
+                break;
+            case NodeType::NOT:
+                stack.back() = graph.add({NodeType::NOT, 0, {stack.back(), 0}});
+                break;
+            default: {
+                std::uint32_t right = stack.back();
+                stack.pop_back();
+                stack.back() = graph.add({pattern_node.type, 0, {stack.back(), right}});
+                break;
+            }
+        }
+    }
+    return stack.back();
+}
+
+std::unique_ptr<ASTNode> composeTerm(NodeType type, const std::vector<std::unique_ptr<ASTNode>>& children) {
+    if (type == NodeType::NOT) {
+        return std::make_unique<UnaryOpNode>(NodeType::NOT, children[0]->clone());
+    }
+    return std::make_unique<BinaryOpNode>(type, children[0]->clone(), children[1]->clone());
+}
+
+}
+
+bool EGraph::NodeKey::operator==(const NodeKey& other) const {
+    return type == other.type && value == other.value &&
+           children[0] == other.children[0] && children[1] == other.children[1];
+}
+
+std::size_t EGraph::NodeKeyHasher::operator()(const NodeKey& key) const {
+    std::size_t h = std::hash<int>()(static_cast<int>(key.type));
+    for (std::uint32_t word : {key.value, key.children[0], key.children[1]}) {
+        h ^= std::hash<std::uint32_t>()(word) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+EGraph::EGraph() : class_count(0) {}
+
+std::uint32_t EGraph::addTerm(const ASTNode& term) {
+    FlatExpression flat = FlatExpression::fromAST(term, variables);
+
+    std::vector<std::uint32_t> stack;
+    for (const auto& node : flat.getNodes()) {
+        switch (node.type) {
+            case NodeType::VARIABLE:
+            case NodeType::CONSTANT:
+                stack.push_back(add({node.type, node.value, {0, 0}}));
+                break;
+            case NodeType::NOT:
+                stack.back() = add({NodeType::NOT, 0, {stack.back(), 0}});
+                break;
+            default: {
+                std::uint32_t right = stack.back();
+                stack.pop_back();
+                stack.back() = add({node.type, 0, {stack.back(), right}});
+                break;
+            }
+        }
+    }
+    return stack.back();
+}
+
+std::uint32_t EGraph::add(const ENode& node) {
+    NodeKey concrete = concreteKey(node);
+    auto existing = concrete_nodes.find(concrete);
+    if (existing != concrete_nodes.end()) {
+        return existing->second;
+    }
+
+    NodeKey key = canonicalKey(node);
+    auto congruent = hashcons.find(key);
+    if (congruent != hashcons.end()) {
+        // Same operator over equal classes but different concrete children:
+        // keep the concrete node for explanations and join it by congruence
+        std::uint32_t id = createNode(node);
+        concrete_nodes.emplace(concrete, id);
+        unite(id, congruent->second, EdgeKind::CONGRUENCE, LogicLaw::DOUBLE_NEGATION);
+        return id;
+    }
+
+    std::uint32_t id = createNode(node);
+    members[id].push_back(id);
+    for (std::size_t k = 0; k < arity(node.type); ++k) {
+        parents[find(node.children[k])].push_back(id);
+    }
+    hashcons.emplace(key, id);
+    concrete_nodes.emplace(concrete, id);
+    return id;
+}
+
+std::uint32_t EGraph::addVariable(const std::string& name) {
+    return add({NodeType::VARIABLE, variables.intern(name), {0, 0}});
+}
+
+std::uint32_t EGraph::find(std::uint32_t id) {
+    std::uint32_t root = id;
+    while (union_find[root] != root) {
+        root = union_find[root];
+    }
+    while (union_find[id] != root) {
+        std::uint32_t next = union_find[id];
+        union_find[id] = root;
+        id = next;
+    }
+    return root;
+}
+
+bool EGraph::merge(std::uint32_t a, std::uint32_t b, LogicLaw law) {
+    return unite(a, b, EdgeKind::RULE, law);
+}
+
+void EGraph::rebuild() {
+    while (!pending.empty()) {
+        std::vector<std::uint32_t> todo;
+        todo.swap(pending);
+
+        std::unordered_set<std::uint32_t> roots;
+        for (std::uint32_t id : todo) {
+            roots.insert(find(id));
+        }
+        for (std::uint32_t root : roots) {
+            repair(root);
+        }
+    }
+
+    // Drop members made redundant by congruence so matching does not revisit them
+    for (std::uint32_t root : classRoots()) {
+        auto& list = members[root];
+        if (list.size() < 2) {
+            continue;
+        }
+        std::unordered_set<NodeKey, NodeKeyHasher> seen;
+        std::vector<std::uint32_t> kept;
+        for (std::uint32_t member : list) {
+            if (seen.insert(canonicalKey(nodes[member])).second) {
+                kept.push_back(member);
+            }
+        }
+        list.swap(kept);
+    }
+}
+
+std::size_t EGraph::nodeCount() const {
+    return nodes.size();
+}
+
+std::size_t EGraph::classCount() const {
+    return class_count;
+}
+
+std::vector<std::uint32_t> EGraph::classRoots() const {
+    std::vector<std::uint32_t> roots;
+    for (std::uint32_t id = 0; id < union_find.size(); ++id) {
+        if (union_find[id] == id) {
+            roots.push_back(id);
+        }
+    }
+    return roots;
+}
+
+const std::vector<std::uint32_t>& EGraph::classMembers(std::uint32_t root) const {
+    return members[root];
+}
+
+const ENode& EGraph::getNode(std::uint32_t id) const {
+    return nodes[id];
+}
+
+std::unique_ptr<ASTNode> EGraph::extractTerm(std::uint32_t id) const {
+    const ENode& node = nodes[id];
+    switch (node.type) {
+        case NodeType::VARIABLE:
+            return std::make_unique<VariableNode>(variables.getName(node.value));
+        case NodeType::CONSTANT:
+            return std::make_unique<ConstantNode>(node.value != 0);
+        case NodeType::NOT:
+            return std::make_unique<UnaryOpNode>(NodeType::NOT, extractTerm(node.children[0]));
+        default:
+            return std::make_unique<BinaryOpNode>(node.type, extractTerm(node.children[0]), extractTerm(node.children[1]));
+    }
+}
+
+bool EGraph::explain(std::uint32_t from, std::uint32_t to, std::vector<ExplanationStep>& steps, std::size_t max_steps) const {
+    if (from == to) {
+        return true;
+    }
+    return explainPath(from, to, steps, max_steps);
+}
+
+std::size_t EGraph::arity(NodeType type) {
+    switch (type) {
+        case NodeType::VARIABLE:
+        case NodeType::CONSTANT:
+            return 0;
+        case NodeType::NOT:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+EGraph::NodeKey EGraph::canonicalKey(const ENode& node) {
+    NodeKey key{node.type, node.value, {0, 0}};
+    for (std::size_t k = 0; k < arity(node.type); ++k) {
+        key.children[k] = find(node.children[k]);
+    }
+    return key;
+}
+
+EGraph::NodeKey EGraph::concreteKey(const ENode& node) {
+    return {node.type, node.value, {node.children[0], node.children[1]}};
+}
+
+std::uint32_t EGraph::createNode(const ENode& node) {
+    std::uint32_t id = static_cast<std::uint32_t>(nodes.size());
+    ENode stored = node;
+    for (std::size_t k = arity(node.type); k < 2; ++k) {
+        stored.children[k] = 0;
+    }
+    nodes.push_back(stored);
+    union_find.push_back(id);
+    members.emplace_back();
+    parents.emplace_back();
+    proof_forest.push_back({id, EdgeKind::NONE, LogicLaw::DOUBLE_NEGATION, true});
+    ++class_count;
+    return id;
+}
+
+bool EGraph::unite(std::uint32_t a, std::uint32_t b, EdgeKind kind, LogicLaw law) {
+    std::uint32_t root_a = find(a);
+    std::uint32_t root_b = find(b);
+    if (root_a == root_b) {
+        return false;
+    }
+
+    rerootProof(a);
+    proof_forest[a] = {b, kind, law, true};
+
+    if (members[root_a].size() + parents[root_a].size() < members[root_b].size() + parents[root_b].size()) {
+        std::swap(root_a, root_b);
+    }
+    union_find[root_b] = root_a;
+    members[root_a].insert(members[root_a].end(), members[root_b].begin(), members[root_b].end());
+    parents[root_a].insert(parents[root_a].end(), parents[root_b].begin(), parents[root_b].end());
+    std::vector<std::uint32_t>().swap(members[root_b]);
+    std::vector<std::uint32_t>().swap(parents[root_b]);
+
+    pending.push_back(root_a);
+    --class_count;
+    return true;
+}
+
+void EGraph::rerootProof(std::uint32_t id) {
+    std::vector<std::uint32_t> path{id};
+    while (proof_forest[path.back()].parent != path.back()) {
+        path.push_back(proof_forest[path.back()].parent);
+    }
+
+    // Reverse every edge on the way to the old root
+    for (std::size_t i = path.size() - 1; i >= 1; --i) {
+        const ProofEdge& edge = proof_forest[path[i - 1]];
+        proof_forest[path[i]] = {path[i - 1], edge.kind, edge.law, !edge.forward};
+    }
+    proof_forest[id] = {id, EdgeKind::NONE, LogicLaw::DOUBLE_NEGATION, true};
+}
+
+void EGraph::repair(std::uint32_t id) {
+    std::uint32_t root = find(id);
+    std::vector<std::uint32_t> list;
+    list.swap(parents[root]);
+
+    std::unordered_set<NodeKey, NodeKeyHasher> seen;
+    std::vector<std::uint32_t> kept;
+    for (std::uint32_t parent : list) {
+        NodeKey key = canonicalKey(nodes[parent]);
+        auto it = hashcons.find(key);
+        if (it == hashcons.end()) {
+            hashcons.emplace(key, parent);
+        } else if (find(it->second) != find(parent)) {
+            unite(parent, it->second, EdgeKind::CONGRUENCE, LogicLaw::DOUBLE_NEGATION);
+        }
+        if (seen.insert(key).second) {
+            kept.push_back(parent);
+        }
+    }
+
+    auto& target = parents[find(root)];
+    target.insert(target.end(), kept.begin(), kept.end());
+}
+
+bool EGraph::explainPath(std::uint32_t from, std::uint32_t to, std::vector<ExplanationStep>& steps, std::size_t max_steps) const {
+    std::vector<std::uint32_t> from_path{from};
+    while (proof_forest[from_path.back()].parent != from_path.back()) {
+        from_path.push_back(proof_forest[from_path.back()].parent);
+    }
+    std::unordered_map<std::uint32_t, std::size_t> from_index;
+    for (std::size_t i = 0; i < from_path.size(); ++i) {
+        from_index.emplace(from_path[i], i);
+    }
+
+    std::vector<std::uint32_t> to_path;
+    std::uint32_t current = to;
+    while (from_index.find(current) == from_index.end()) {
+        if (proof_forest[current].parent == current) {
+            return false;
+        }
+        to_path.push_back(current);
+        current = proof_forest[current].parent;
+    }
+    std::size_t ancestor_index = from_index[current];
+
+    for (std::size_t i = 0; i < ancestor_index; ++i) {
+        if (!explainEdge(from_path[i], from_path[i + 1], proof_forest[from_path[i]], true, steps, max_steps)) {
+            return false;
+        }
+    }
+
+    std::uint32_t previous = current;
+    for (std::size_t i = to_path.size(); i > 0; --i) {
+        std::uint32_t next = to_path[i - 1];
+        if (!explainEdge(previous, next, proof_forest[next], false, steps, max_steps)) {
+            return false;
+        }
+        previous = next;
+    }
+    return true;
+}
+
+bool EGraph::explainEdge(std::uint32_t from, std::uint32_t to, const ProofEdge& edge, bool along_edge,
+                         std::vector<ExplanationStep>& steps, std::size_t max_steps) const {
+    if (edge.kind == EdgeKind::RULE) {
+        if (steps.size() >= max_steps) {
+            return false;
+        }
+        steps.emplace_back(extractTerm(to), edge.law, along_edge ? !edge.forward : edge.forward);
+        return true;
+    }
+
+    // Congruence: rewrite the children one at a time inside the shared operator
+    const ENode& source = nodes[from];
+    const ENode& destination = nodes[to];
+    std::vector<std::unique_ptr<ASTNode>> current;
+    for (std::size_t k = 0; k < arity(source.type); ++k) {
+        current.push_back(extractTerm(source.children[k]));
+    }
+
+    for (std::size_t k = 0; k < arity(source.type); ++k) {
+        std::vector<ExplanationStep> inner;
+        if (!explain(source.children[k], destination.children[k], inner, max_steps - steps.size())) {
+            return false;
+        }
+        for (auto& step : inner) {
+            current[k] = std::move(step.expression);
+            steps.emplace_back(composeTerm(source.type, current), step.law, step.reversed);
+        }
+    }
+    return steps.size() <= max_steps;
+}
+
+SaturationProver::SaturationProver(std::size_t node_limit, std::chrono::milliseconds time_limit)
+    : node_limit(node_limit), time_limit(time_limit), iteration_limit(64), match_limit(1000),
+      explanation_limit(10000) {}
+
+Proof SaturationProver::findProof(const ASTNode& start_expression, const ASTNode& target_expression) {
+    auto deadline = std::chrono::steady_clock::now() + time_limit;
+
+    EGraph graph;
+    std::uint32_t start_id = graph.addTerm(start_expression);
+    std::uint32_t target_id = graph.addTerm(target_expression);
+    graph.rebuild();
+
+    const auto& rules = rewriteRules();
+    std::vector<int> banned_until(rules.size(), 0);
+    std::vector<int> times_banned(rules.size(), 0);
+
+    for (int iteration = 0; iteration < iteration_limit; ++iteration) {
+        if (graph.find(start_id) == graph.find(target_id) ||
+            graph.nodeCount() > node_limit ||
+            std::chrono::steady_clock::now() > deadline || cancellation.isCancelled()) {
+            break;
+        }
+
+        std::vector<std::pair<std::size_t, Bindings>> matches;
+        std::vector<std::uint32_t> roots = graph.classRoots();
+        bool any_banned = false;
+
+        for (std::size_t r = 0; r < rules.size(); ++r) {
+            if (banned_until[r] > iteration) {
+                any_banned = true;
+                continue;
+            }
+
+            // Rules that fire too often (commutativity, associativity) are
+            // backed off exponentially so they cannot starve the others
+            std::size_t limit = match_limit << times_banned[r];
+            std::vector<Bindings> rule_matches;
+            for (std::uint32_t root : roots) {
+                std::vector<Bindings> initial{Bindings(rules[r].variable_count, UNBOUND)};
+                auto found = matchPattern(graph, rules[r].lhs, rules[r].lhs.nodes.size() - 1, root, std::move(initial));
+                for (auto& bindings : found) {
+                    if (rules[r].guard_variable != UNBOUND &&
+                        graph.getNode(bindings[rules[r].guard_variable]).type == rules[r].guard_type) {
+                        continue;
+                    }
+                    rule_matches.push_back(std::move(bindings));
+                }
+                if (rule_matches.size() > limit) {
+                    break;
+                }
+            }
+
+            if (rule_matches.size() > limit) {
+                banned_until[r] = iteration + (1 << times_banned[r]);
+                ++times_banned[r];
+                any_banned = true;
+                continue;
+            }
+            for (auto& bindings : rule_matches) {
+                matches.emplace_back(r, std::move(bindings));
+            }
+        }
+
+        std::size_t nodes_before = graph.nodeCount();
+        std::size_t classes_before = graph.classCount();
+
+        for (const auto& [rule_index, bindings] : matches) {
+            if (graph.nodeCount() > node_limit) {
+                break;
+            }
+            const auto& rule = rules[rule_index];
+            std::uint32_t lhs = instantiatePattern(graph, rule.lhs, bindings);
+            std::uint32_t rhs = instantiatePattern(graph, rule.rhs, bindings);
+            graph.merge(lhs, rhs, rule.law);
+        }
+        graph.rebuild();
+
+        if (!any_banned && graph.nodeCount() == nodes_before && graph.classCount() == classes_before) {
+            break;
+        }
+    }
+
+    Proof proof;
+    if (graph.find(start_id) != graph.find(target_id)) {
+        return proof;
+    }
+
+    std::vector<ExplanationStep> explanation;
+    if (!graph.explain(start_id, target_id, explanation, explanation_limit)) {
+        return proof;
+    }
+
+    std::string previous = start_expression.toString();
+    for (auto& step : explanation) {
+        std::string current = step.expression->toString();
+        if (current == previous) {
+            continue;
+        }
+        previous = current;
+
+        std::string description = LogicLaws::getLawName(step.law);
+        if (step.reversed) {
+            description += " (reversed)";
+        }
+        int step_number = static_cast<int>(proof.steps.size()) + 1;
+        proof.steps.emplace_back(std::move(step.expression), step.law, description, step_number);
+    }
+
+    proof.found_target = true;
+    proof.total_steps = static_cast<int>(proof.steps.size());
+    return proof;
+}
+
+void SaturationProver::setNodeLimit(std::size_t limit) {
+    node_limit = limit;
+}
+
+void SaturationProver::setTimeLimit(std::chrono::milliseconds limit) {
+    time_limit = limit;
+}
+
+void SaturationProver::setIterationLimit(int limit) {
+    iteration_limit = limit;
+}
+
+void SaturationProver::setMatchLimit(std::size_t limit) {
+    match_limit = limit;
+}
+
+void SaturationProver::setCancellationToken(CancellationToken token) {
+    cancellation = std::move(token);
+}
+
+}
\ No newline at end of file
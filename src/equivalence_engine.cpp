@@ -349,8 +349,7 @@ std::unique_ptr<ASTNode> LogicLaws::createOr(std::unique_ptr<ASTNode> left, std:
 }
 
 std::size_t EquivalenceEngine::ASTHasher::operator()(const std::unique_ptr<ASTNode>& node) const {
-    EquivalenceEngine engine;
-    return engine.computeHash(*node);
+    return node->getHash();
 }
 
 bool EquivalenceEngine::ASTEqual::operator()(const std::unique_ptr<ASTNode>& a, const std::unique_ptr<ASTNode>& b) const {
@@ -358,100 +357,107 @@ bool EquivalenceEngine::ASTEqual::operator()(const std::unique_ptr<ASTNode>& a,
 }
 
 std::vector<Transformation> EquivalenceEngine::generateAllTransformations(const ASTNode& expression) {
-    std::vector<Transformation> transformations;
+    if (law_configuration.isDefault()) {
+        return generateAllTransformationsWith<StandardLaws>(expression);
+    }
     
-    static const std::vector<LogicLaw> all_laws = {
-        LogicLaw::DOUBLE_NEGATION,
-        LogicLaw::DE_MORGAN_AND,
-        LogicLaw::DE_MORGAN_OR,
-        LogicLaw::DISTRIBUTIVE_AND_OVER_OR,
-        LogicLaw::DISTRIBUTIVE_OR_OVER_AND,
-        LogicLaw::ABSORPTION_AND,
-        LogicLaw::ABSORPTION_OR,
-        LogicLaw::IDENTITY_AND,
-        LogicLaw::IDENTITY_OR,
-        LogicLaw::ANNIHILATION_AND,
-        LogicLaw::ANNIHILATION_OR,
-        LogicLaw::COMPLEMENT_AND,
-        LogicLaw::COMPLEMENT_OR,
-        LogicLaw::IDEMPOTENT_AND,
-        LogicLaw::IDEMPOTENT_OR,
-        LogicLaw::COMMUTATIVE_AND,
-        LogicLaw::COMMUTATIVE_OR,
-        LogicLaw::ASSOCIATIVE_AND,
-        LogicLaw::ASSOCIATIVE_OR,
-        LogicLaw::IMPLICATION_ELIMINATION,
-        LogicLaw::BICONDITIONAL_ELIMINATION
-    };
+    std::uint32_t present = nodeTypeMask(expression);
     
-    for (LogicLaw law : all_laws) {
-        auto law_transformations = applyLawRecursively(expression, law);
-        for (auto& trans : law_transformations) {
+    std::vector<Transformation> transformations;
+    for (LogicLaw law : law_configuration.activeLaws()) {
+        if (!(present & nodeTypeBit(lawRoot(law)))) {
+            continue;
+        }
+        for (auto& trans : applyLawRecursively(expression, law)) {
             transformations.push_back(std::move(trans));
         }
     }
-    
     return transformations;
 }
 
-std::vector<Transformation> EquivalenceEngine::applyLawRecursively(const ASTNode& expression, LogicLaw law) {
-    std::vector<Transformation> transformations;
-    
-    auto direct_result = applyLawToNode(expression, law);
-    if (direct_result) {
-        transformations.emplace_back(law, LogicLaws::getLawName(law), std::move(direct_result));
+std::vector<Transformation> EquivalenceEngine::generateSingleStepTransformations(const ASTNode& expression) {
+    if (law_configuration.isDefault()) {
+        return generateSingleStepTransformationsWith<StandardLaws>(expression);
     }
     
-    auto subexpr_transformations = applyLawToSubexpressions(expression, law);
-    for (auto& trans : subexpr_transformations) {
-        transformations.push_back(std::move(trans));
-    }
+    using Transformations = std::vector<Transformation>;
+    const auto& laws = law_configuration.activeLaws();
     
+    auto with_direct = [&laws](const ASTNode& node, Transformations below) {
+        Transformations transformations;
+        for (LogicLaw law : laws) {
+            if (auto result = StandardLaws::apply(node, law)) {
+                transformations.emplace_back(law, LogicLaws::getLawName(law), std::move(result));
+            }
+        }
+        for (auto& trans : below) {
+            transformations.push_back(std::move(trans));
+        }
+        return transformations;
+    };
+    
+    return foldTree<Transformations>(
+        expression,
+        [&](const ASTNode& node) { return with_direct(node, {}); },
+        [&](const UnaryOpNode& node, Transformations operand) {
+            return with_direct(node, applyLawToSubexpressions(node, std::move(operand), {}, false));
+        },
+        [&](const BinaryOpNode& node, Transformations left, Transformations right) {
+            return with_direct(node, applyLawToSubexpressions(node, std::move(left), std::move(right), false));
+        });
+}
+
+std::vector<Transformation> EquivalenceEngine::applyLawRecursively(const ASTNode& expression, LogicLaw law) {
+    // Dispatch once on the law, then run the traversal specialized for it
+    std::vector<Transformation> transformations;
+    StandardLaws::forEach([&](auto rule) {
+        if (decltype(rule)::value == law) {
+            transformations = applyLawRecursively<decltype(rule)::value>(expression);
+        }
+    });
     return transformations;
 }
 
-std::vector<Transformation> EquivalenceEngine::applyLawToSubexpressions(const ASTNode& expression, LogicLaw law) {
+std::vector<Transformation> EquivalenceEngine::applyLawToSubexpressions(const ASTNode& expression,
+                                                                       std::vector<Transformation> first,
+                                                                       std::vector<Transformation> second,
+                                                                       bool combine) {
     std::vector<Transformation> transformations;
     
     if (expression.getType() == NodeType::NOT) {
-        const auto& unary = static_cast<const UnaryOpNode&>(expression);
-        auto sub_transformations = applyLawRecursively(unary.getOperand(), law);
-        
-        for (auto& trans : sub_transformations) {
+        for (auto& trans : first) {
             auto new_expr = std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(trans.result));
             transformations.emplace_back(trans.law, trans.description, std::move(new_expr));
         }
-    } else if (expression.getType() == NodeType::AND || 
-               expression.getType() == NodeType::OR ||
-               expression.getType() == NodeType::IMPLIES ||
-               expression.getType() == NodeType::BICONDITIONAL) {
-        const auto& binary = static_cast<const BinaryOpNode&>(expression);
-        
-        // Try transforming left subexpression
-        auto left_transformations = applyLawRecursively(binary.getLeft(), law);
-        for (auto& trans : left_transformations) {
-            auto new_expr = std::make_unique<BinaryOpNode>(
-                expression.getType(), 
-                std::move(trans.result), 
-                binary.getRight().clone()
-            );
-            transformations.emplace_back(trans.law, trans.description, std::move(new_expr));
-        }
-        
-        // Try transforming right subexpression
-        auto right_transformations = applyLawRecursively(binary.getRight(), law);
-        for (auto& trans : right_transformations) {
-            auto new_expr = std::make_unique<BinaryOpNode>(
-                expression.getType(), 
-                binary.getLeft().clone(),
-                std::move(trans.result)
-            );
-            transformations.emplace_back(trans.law, trans.description, std::move(new_expr));
-        }
-        
-        // Try transforming both subexpressions
-        for (auto& left_trans : left_transformations) {
-            for (auto& right_trans : right_transformations) {
+        return transformations;
+    }
+    
+    const auto& binary = static_cast<const BinaryOpNode&>(expression);
+    
+    // Left subexpression transformed
+    for (auto& trans : first) {
+        auto new_expr = std::make_unique<BinaryOpNode>(
+            expression.getType(), 
+            trans.result->clone(), 
+            binary.getRight().clone()
+        );
+        transformations.emplace_back(trans.law, trans.description, std::move(new_expr));
+    }
+    
+    // Right subexpression transformed
+    for (auto& trans : second) {
+        auto new_expr = std::make_unique<BinaryOpNode>(
+            expression.getType(), 
+            binary.getLeft().clone(),
+            trans.result->clone()
+        );
+        transformations.emplace_back(trans.law, trans.description, std::move(new_expr));
+    }
+    
+    // Both subexpressions transformed
+    if (combine) {
+        for (auto& left_trans : first) {
+            for (auto& right_trans : second) {
                 auto new_expr = std::make_unique<BinaryOpNode>(
                     expression.getType(),
                     left_trans.result->clone(),
@@ -470,95 +476,19 @@ std::vector<Transformation> EquivalenceEngine::applyLawToSubexpressions(const AS
 }
 
 std::unique_ptr<ASTNode> EquivalenceEngine::applyLawToNode(const ASTNode& node, LogicLaw law) {
-    switch (law) {
-        case LogicLaw::DOUBLE_NEGATION:
-            return LogicLaws::applyDoubleNegation(node);
-        case LogicLaw::DE_MORGAN_AND:
-            return LogicLaws::applyDeMorganAnd(node);
-        case LogicLaw::DE_MORGAN_OR:
-            return LogicLaws::applyDeMorganOr(node);
-        case LogicLaw::DISTRIBUTIVE_AND_OVER_OR:
-            return LogicLaws::applyDistributiveAndOverOr(node);
-        case LogicLaw::DISTRIBUTIVE_OR_OVER_AND:
-            return LogicLaws::applyDistributiveOrOverAnd(node);
-        case LogicLaw::ABSORPTION_AND:
-            return LogicLaws::applyAbsorptionAnd(node);
-        case LogicLaw::ABSORPTION_OR:
-            return LogicLaws::applyAbsorptionOr(node);
-        case LogicLaw::IDENTITY_AND:
-            return LogicLaws::applyIdentityAnd(node);
-        case LogicLaw::IDENTITY_OR:
-            return LogicLaws::applyIdentityOr(node);
-        case LogicLaw::ANNIHILATION_AND:
-            return LogicLaws::applyAnnihilationAnd(node);
-        case LogicLaw::ANNIHILATION_OR:
-            return LogicLaws::applyAnnihilationOr(node);
-        case LogicLaw::COMPLEMENT_AND:
-            return LogicLaws::applyComplementAnd(node);
-        case LogicLaw::COMPLEMENT_OR:
-            return LogicLaws::applyComplementOr(node);
-        case LogicLaw::IDEMPOTENT_AND:
-            return LogicLaws::applyIdempotentAnd(node);
-        case LogicLaw::IDEMPOTENT_OR:
-            return LogicLaws::applyIdempotentOr(node);
-        case LogicLaw::COMMUTATIVE_AND:
-            return LogicLaws::applyCommutativeAnd(node);
-        case LogicLaw::COMMUTATIVE_OR:
-            return LogicLaws::applyCommutativeOr(node);
-        case LogicLaw::ASSOCIATIVE_AND:
-            return LogicLaws::applyAssociativeAnd(node);
-        case LogicLaw::ASSOCIATIVE_OR:
-            return LogicLaws::applyAssociativeOr(node);
-        case LogicLaw::IMPLICATION_ELIMINATION:
-            return LogicLaws::applyImplicationElimination(node);
-        case LogicLaw::BICONDITIONAL_ELIMINATION:
-            return LogicLaws::applyBiconditionalElimination(node);
-        default:
-            return nullptr;
-    }
+    return StandardLaws::apply(node, law);
 }
 
-bool EquivalenceEngine::areEquivalent(const ASTNode& expr1, const ASTNode& expr2) {
-    return expr1.equals(expr2);
+void EquivalenceEngine::setLawConfiguration(const LawConfiguration& configuration) {
+    law_configuration = configuration;
 }
 
-std::size_t EquivalenceEngine::computeHash(const ASTNode& node) const {
-    std::hash<int> int_hasher;
-    std::hash<std::string> string_hasher;
-    std::hash<bool> bool_hasher;
-    
-    switch (node.getType()) {
-        case NodeType::VARIABLE: {
-            const auto& var = static_cast<const VariableNode&>(node);
-            return combineHashes(int_hasher(static_cast<int>(NodeType::VARIABLE)), 
-                               string_hasher(var.getName()));
-        }
-        case NodeType::CONSTANT: {
-            const auto& constant = static_cast<const ConstantNode&>(node);
-            return combineHashes(int_hasher(static_cast<int>(NodeType::CONSTANT)), 
-                               bool_hasher(constant.getValue()));
-        }
-        case NodeType::NOT: {
-            const auto& unary = static_cast<const UnaryOpNode&>(node);
-            return combineHashes(int_hasher(static_cast<int>(NodeType::NOT)), 
-                               computeHash(unary.getOperand()));
-        }
-        case NodeType::AND:
-        case NodeType::OR:
-        case NodeType::IMPLIES:
-        case NodeType::BICONDITIONAL: {
-            const auto& binary = static_cast<const BinaryOpNode&>(node);
-            std::size_t type_hash = int_hasher(static_cast<int>(node.getType()));
-            std::size_t left_hash = computeHash(binary.getLeft());
-            std::size_t right_hash = computeHash(binary.getRight());
-            return combineHashes(combineHashes(type_hash, left_hash), right_hash);
-        }
-    }
-    return 0;
+const LawConfiguration& EquivalenceEngine::getLawConfiguration() const {
+    return law_configuration;
 }
 
-std::size_t EquivalenceEngine::combineHashes(std::size_t h1, std::size_t h2) const {
-    return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+bool EquivalenceEngine::areEquivalent(const ASTNode& expr1, const ASTNode& expr2) {
+    return expr1.equals(expr2);
 }
 
 }
\ No newline at end of file
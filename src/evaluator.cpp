@@ -0,0 +1,318 @@
+#include "evaluator.h"
+#include "flat_expr.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace logixpr {
+
+namespace {
+
+// Bit k of LOW_VARIABLE_PATTERNS[j] is bit j of k, so the first six variables
+// enumerate all 64 combinations inside a single batch
+const std::uint64_t LOW_VARIABLE_PATTERNS[6] = {
+    0xAAAAAAAAAAAAAAAAull,
+    0xCCCCCCCCCCCCCCCCull,
+    0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull,
+    0xFFFF0000FFFF0000ull,
+    0xFFFFFFFF00000000ull
+};
+
+const std::uint64_t MIN_BLOCKS_PER_THREAD = 1024;
+
+std::uint64_t blockCount(std::size_t variable_count) {
+    return variable_count <= 6 ? 1 : (std::uint64_t(1) << (variable_count - 6));
+}
+
+std::uint64_t validRowMask(std::size_t variable_count) {
+    return variable_count >= 6 ? ~std::uint64_t(0) : ((std::uint64_t(1) << (std::uint64_t(1) << variable_count)) - 1);
+}
+
+void fillVariableWords(std::vector<std::uint64_t>& words, std::uint64_t block) {
+    for (std::size_t j = 0; j < words.size(); ++j) {
+        if (j < 6) {
+            words[j] = LOW_VARIABLE_PATTERNS[j];
+        } else {
+            words[j] = ((block >> (j - 6)) & 1) ? ~std::uint64_t(0) : 0;
+        }
+    }
+}
+
+unsigned lowestSetBit(std::uint64_t word) {
+    unsigned index = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+unsigned resolveThreadCount(unsigned requested, std::uint64_t blocks) {
+    unsigned threads = requested != 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t useful = std::max<std::uint64_t>(1, blocks / MIN_BLOCKS_PER_THREAD);
+    return static_cast<unsigned>(std::min<std::uint64_t>(threads, useful));
+}
+
+template <typename ShardFn>
+void runSharded(std::uint64_t blocks, unsigned num_threads, ShardFn shard) {
+    unsigned threads = resolveThreadCount(num_threads, blocks);
+    if (threads <= 1) {
+        shard(0, 0, blocks);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    std::uint64_t per_thread = blocks / threads;
+    std::uint64_t begin = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        std::uint64_t end = (t + 1 == threads) ? blocks : begin + per_thread;
+        workers.emplace_back(shard, t, begin, end);
+        begin = end;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void checkEnumerable(std::size_t variable_count) {
+    if (variable_count > CompiledExpression::MAX_ENUMERATION_VARIABLES) {
+        throw std::invalid_argument("Too many variables for truth table enumeration");
+    }
+}
+
+}
+
+CompiledExpression::CompiledExpression() : max_stack_depth(0) {}
+
+CompiledExpression CompiledExpression::compile(const ASTNode& expression) {
+    return compile(expression, {});
+}
+
+CompiledExpression CompiledExpression::compile(const ASTNode& expression, const std::vector<std::string>& variable_order) {
+    VariableTable table;
+    for (const auto& name : variable_order) {
+        table.intern(name);
+    }
+    FlatExpression flat = FlatExpression::fromAST(expression, table);
+
+    CompiledExpression compiled;
+    compiled.code.reserve(flat.size());
+
+    std::size_t depth = 0;
+    for (const auto& node : flat.getNodes()) {
+        switch (node.type) {
+            case NodeType::VARIABLE:
+                compiled.code.push_back({OpCode::LOAD_VARIABLE, node.value});
+                ++depth;
+                break;
+            case NodeType::CONSTANT:
+                compiled.code.push_back({node.value ? OpCode::LOAD_TRUE : OpCode::LOAD_FALSE, 0});
+                ++depth;
+                break;
+            case NodeType::NOT:
+                compiled.code.push_back({OpCode::NOT, 0});
+                break;
+            case NodeType::AND:
+                compiled.code.push_back({OpCode::AND, 0});
+                --depth;
+                break;
+            case NodeType::OR:
+                compiled.code.push_back({OpCode::OR, 0});
+                --depth;
+                break;
+            case NodeType::IMPLIES:
+                compiled.code.push_back({OpCode::IMPLIES, 0});
+                --depth;
+                break;
+            case NodeType::BICONDITIONAL:
+                compiled.code.push_back({OpCode::BICONDITIONAL, 0});
+                --depth;
+                break;
+        }
+        compiled.max_stack_depth = std::max(compiled.max_stack_depth, depth);
+    }
+
+    compiled.variables.reserve(table.size());
+    for (std::uint32_t id = 0; id < table.size(); ++id) {
+        compiled.variables.push_back(table.getName(id));
+    }
+
+    return compiled;
+}
+
+const std::vector<Instruction>& CompiledExpression::getCode() const {
+    return code;
+}
+
+const std::vector<std::string>& CompiledExpression::getVariables() const {
+    return variables;
+}
+
+std::size_t CompiledExpression::variableCount() const {
+    return variables.size();
+}
+
+bool CompiledExpression::evaluate(std::uint64_t assignment) const {
+    std::vector<std::uint64_t> words(variables.size());
+    for (std::size_t i = 0; i < words.size() && i < 64; ++i) {
+        words[i] = ((assignment >> i) & 1) ? ~std::uint64_t(0) : 0;
+    }
+    return (evaluateBatch(words.data()) & 1) != 0;
+}
+
+std::uint64_t CompiledExpression::evaluateBatch(const std::uint64_t* variable_words) const {
+    std::vector<std::uint64_t> stack(max_stack_depth);
+    return run(variable_words, stack.data());
+}
+
+std::uint64_t CompiledExpression::countModels(unsigned num_threads) const {
+    checkEnumerable(variables.size());
+
+    std::uint64_t blocks = blockCount(variables.size());
+    std::uint64_t mask = validRowMask(variables.size());
+    std::atomic<std::uint64_t> total{0};
+
+    runSharded(blocks, num_threads, [&](unsigned, std::uint64_t begin, std::uint64_t end) {
+        std::vector<std::uint64_t> words(variables.size());
+        std::vector<std::uint64_t> stack(max_stack_depth);
+        std::uint64_t local = 0;
+        for (std::uint64_t block = begin; block < end; ++block) {
+            fillVariableWords(words, block);
+            local += std::bitset<64>(run(words.data(), stack.data()) & mask).count();
+        }
+        total += local;
+    });
+
+    return total;
+}
+
+bool CompiledExpression::findAssignment(bool value, std::uint64_t& assignment, unsigned num_threads) const {
+    checkEnumerable(variables.size());
+
+    std::uint64_t blocks = blockCount(variables.size());
+    std::uint64_t mask = validRowMask(variables.size());
+    const std::uint64_t none = std::numeric_limits<std::uint64_t>::max();
+    std::atomic<std::uint64_t> best{none};
+
+    // Shards scan in order and stop once a lower assignment is known, so the
+    // reported assignment is always the smallest one regardless of timing
+    runSharded(blocks, num_threads, [&](unsigned, std::uint64_t begin, std::uint64_t end) {
+        std::vector<std::uint64_t> words(variables.size());
+        std::vector<std::uint64_t> stack(max_stack_depth);
+        for (std::uint64_t block = begin; block < end; ++block) {
+            if (block * 64 > best.load(std::memory_order_relaxed)) {
+                return;
+            }
+            fillVariableWords(words, block);
+            std::uint64_t result = run(words.data(), stack.data());
+            std::uint64_t hits = (value ? result : ~result) & mask;
+            if (hits != 0) {
+                std::uint64_t found = block * 64 + lowestSetBit(hits);
+                std::uint64_t current = best.load();
+                while (found < current && !best.compare_exchange_weak(current, found)) {}
+                return;
+            }
+        }
+    });
+
+    if (best == none) {
+        return false;
+    }
+    assignment = best;
+    return true;
+}
+
+std::uint64_t CompiledExpression::run(const std::uint64_t* variable_words, std::uint64_t* stack) const {
+    std::size_t top = 0;
+
+    for (const auto& instruction : code) {
+        switch (instruction.op) {
+            case OpCode::LOAD_VARIABLE:
+                stack[top++] = variable_words[instruction.operand];
+                break;
+            case OpCode::LOAD_TRUE:
+                stack[top++] = ~std::uint64_t(0);
+                break;
+            case OpCode::LOAD_FALSE:
+                stack[top++] = 0;
+                break;
+            case OpCode::NOT:
+                stack[top - 1] = ~stack[top - 1];
+                break;
+            case OpCode::AND:
+                --top;
+                stack[top - 1] &= stack[top];
+                break;
+            case OpCode::OR:
+                --top;
+                stack[top - 1] |= stack[top];
+                break;
+            case OpCode::IMPLIES:
+                --top;
+                stack[top - 1] = ~stack[top - 1] | stack[top];
+                break;
+            case OpCode::BICONDITIONAL:
+                --top;
+                stack[top - 1] = ~(stack[top - 1] ^ stack[top]);
+                break;
+        }
+    }
+
+    return stack[0];
+}
+
+std::vector<std::string> TruthTable::collectVariables(const ASTNode& expression) {
+    VariableTable table;
+    FlatExpression::fromAST(expression, table);
+
+    std::vector<std::string> names;
+    for (std::uint32_t id = 0; id < table.size(); ++id) {
+        names.push_back(table.getName(id));
+    }
+    return names;
+}
+
+std::vector<std::string> TruthTable::collectVariables(const ASTNode& expr1, const ASTNode& expr2) {
+    VariableTable table;
+    FlatExpression::fromAST(expr1, table);
+    FlatExpression::fromAST(expr2, table);
+
+    std::vector<std::string> names;
+    for (std::uint32_t id = 0; id < table.size(); ++id) {
+        names.push_back(table.getName(id));
+    }
+    return names;
+}
+
+bool TruthTable::areEquivalent(const ASTNode& expr1, const ASTNode& expr2, unsigned num_threads) {
+    std::vector<std::pair<std::string, bool>> counterexample;
+    return !findCounterexample(expr1, expr2, counterexample, num_threads);
+}
+
+bool TruthTable::findCounterexample(const ASTNode& expr1, const ASTNode& expr2,
+                                    std::vector<std::pair<std::string, bool>>& counterexample,
+                                    unsigned num_threads) {
+    auto difference = std::make_unique<UnaryOpNode>(
+        NodeType::NOT,
+        std::make_unique<BinaryOpNode>(NodeType::BICONDITIONAL, expr1.clone(), expr2.clone()));
+
+    auto compiled = CompiledExpression::compile(*difference, collectVariables(expr1, expr2));
+
+    std::uint64_t assignment = 0;
+    if (!compiled.findAssignment(true, assignment, num_threads)) {
+        return false;
+    }
+
+    counterexample.clear();
+    const auto& names = compiled.getVariables();
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        counterexample.emplace_back(names[i], ((assignment >> i) & 1) != 0);
+    }
+    return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "expression_writer.h"
+#include <vector>
+
+namespace logixpr {
+
+namespace {
+
+struct Symbols {
+    const char* negation;
+    const char* conjunction;
+    const char* disjunction;
+    const char* implication;
+    const char* biconditional;
+};
+
+const Symbols ASCII_SYMBOLS{"!", " & ", " | ", " -> ", " <-> "};
+const Symbols UNICODE_SYMBOLS{"¬", " ∧ ", " ∨ ", " → ", " ↔ "};
+
+const char* binarySymbol(const Symbols& symbols, NodeType type) {
+    switch (type) {
+        case NodeType::AND: return symbols.conjunction;
+        case NodeType::OR: return symbols.disjunction;
+        case NodeType::IMPLIES: return symbols.implication;
+        case NodeType::BICONDITIONAL: return symbols.biconditional;
+        default: return " UNKNOWN_BINARY ";
+    }
+}
+
+}
+
+ExpressionWriter::ExpressionWriter(OutputStyle style) : style(style) {}
+
+ExpressionWriter& ExpressionWriter::write(const ASTNode& expression) {
+    // Work items are either a node to expand or literal text to emit; the
+    // explicit stack keeps deep trees off the call stack
+    struct Item {
+        const ASTNode* node;
+        const char* text;
+    };
+
+    const Symbols& symbols = style == OutputStyle::UNICODE ? UNICODE_SYMBOLS : ASCII_SYMBOLS;
+    bool wrap_negation = style == OutputStyle::FULLY_PARENTHESIZED;
+
+    std::vector<Item> stack{{&expression, nullptr}};
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+        if (!item.node) {
+            buffer += item.text;
+            continue;
+        }
+
+        const ASTNode& node = *item.node;
+        switch (node.getType()) {
+            case NodeType::VARIABLE:
+                buffer += static_cast<const VariableNode&>(node).getName();
+                break;
+            case NodeType::CONSTANT:
+                buffer += static_cast<const ConstantNode&>(node).getValue() ? 'T' : 'F';
+                break;
+            case NodeType::NOT:
+                if (wrap_negation) {
+                    buffer += '(';
+                    stack.push_back({nullptr, ")"});
+                }
+                buffer += symbols.negation;
+                stack.push_back({&static_cast<const UnaryOpNode&>(node).getOperand(), nullptr});
+                break;
+            default: {
+                const auto& binary = static_cast<const BinaryOpNode&>(node);
+                buffer += '(';
+                stack.push_back({nullptr, ")"});
+                stack.push_back({&binary.getRight(), nullptr});
+                stack.push_back({nullptr, binarySymbol(symbols, node.getType())});
+                stack.push_back({&binary.getLeft(), nullptr});
+                break;
+            }
+        }
+    }
+    return *this;
+}
+
+ExpressionWriter& ExpressionWriter::append(const std::string& text) {
+    buffer += text;
+    return *this;
+}
+
+ExpressionWriter& ExpressionWriter::append(const char* text) {
+    buffer += text;
+    return *this;
+}
+
+ExpressionWriter& ExpressionWriter::append(char c) {
+    buffer += c;
+    return *this;
+}
+
+ExpressionWriter& ExpressionWriter::append(long long value) {
+    buffer += std::to_string(value);
+    return *this;
+}
+
+const std::string& ExpressionWriter::str() const {
+    return buffer;
+}
+
+std::string ExpressionWriter::release() {
+    std::string result = std::move(buffer);
+    buffer.clear();
+    return result;
+}
+
+std::size_t ExpressionWriter::size() const {
+    return buffer.size();
+}
+
+ExpressionWriter& ExpressionWriter::clear() {
+    // clear() keeps the capacity, which is the point of reusing a writer
+    buffer.clear();
+    return *this;
+}
+
+void ExpressionWriter::setStyle(OutputStyle output_style) {
+    style = output_style;
+}
+
+OutputStyle ExpressionWriter::getStyle() const {
+    return style;
+}
+
+std::string ExpressionWriter::toString(const ASTNode& expression, OutputStyle style) {
+    ExpressionWriter writer(style);
+    writer.write(expression);
+    return writer.release();
+}
+
+}
\ No newline at end of file
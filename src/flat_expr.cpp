@@ -0,0 +1,318 @@
+#include "flat_expr.h"
+#include <stdexcept>
+#include <utility>
+
+namespace logixpr {
+
+namespace {
+
+bool isBinaryType(NodeType type) {
+    return type == NodeType::AND || type == NodeType::OR ||
+           type == NodeType::IMPLIES || type == NodeType::BICONDITIONAL;
+}
+
+}
+
+std::uint32_t VariableTable::intern(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    std::uint32_t id = static_cast<std::uint32_t>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+bool VariableTable::lookup(const std::string& name, std::uint32_t& id) const {
+    auto it = ids.find(name);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+const std::string& VariableTable::getName(std::uint32_t id) const {
+    return names.at(id);
+}
+
+std::size_t VariableTable::size() const {
+    return names.size();
+}
+
+FlatExpression::FlatExpression(std::vector<FlatNode> nodes) : nodes(std::move(nodes)) {
+    relink();
+}
+
+FlatExpression FlatExpression::fromAST(const ASTNode& node, VariableTable& variables) {
+    FlatExpression result;
+    std::vector<std::pair<const ASTNode*, bool>> stack;
+    stack.emplace_back(&node, false);
+
+    while (!stack.empty()) {
+        auto [current, expanded] = stack.back();
+        stack.pop_back();
+
+        switch (current->getType()) {
+            case NodeType::VARIABLE: {
+                const auto& var = static_cast<const VariableNode&>(*current);
+                result.nodes.push_back({NodeType::VARIABLE, variables.intern(var.getName())});
+                break;
+            }
+            case NodeType::CONSTANT: {
+                const auto& constant = static_cast<const ConstantNode&>(*current);
+                result.nodes.push_back({NodeType::CONSTANT, constant.getValue() ? 1u : 0u});
+                break;
+            }
+            case NodeType::NOT: {
+                if (expanded) {
+                    result.nodes.push_back({NodeType::NOT, 0});
+                } else {
+                    const auto& unary = static_cast<const UnaryOpNode&>(*current);
+                    stack.emplace_back(current, true);
+                    stack.emplace_back(&unary.getOperand(), false);
+                }
+                break;
+            }
+            default: {
+                if (expanded) {
+                    result.nodes.push_back({current->getType(), 0});
+                } else {
+                    const auto& binary = static_cast<const BinaryOpNode&>(*current);
+                    stack.emplace_back(current, true);
+                    stack.emplace_back(&binary.getRight(), false);
+                    stack.emplace_back(&binary.getLeft(), false);
+                }
+                break;
+            }
+        }
+    }
+
+    result.relink();
+    return result;
+}
+
+std::unique_ptr<ASTNode> FlatExpression::toAST(const VariableTable& variables) const {
+    std::vector<std::unique_ptr<ASTNode>> stack;
+
+    for (const auto& node : nodes) {
+        switch (node.type) {
+            case NodeType::VARIABLE:
+                stack.push_back(std::make_unique<VariableNode>(variables.getName(node.value)));
+                break;
+            case NodeType::CONSTANT:
+                stack.push_back(std::make_unique<ConstantNode>(node.value != 0));
+                break;
+            case NodeType::NOT: {
+                auto operand = std::move(stack.back());
+                stack.pop_back();
+                stack.push_back(std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(operand)));
+                break;
+            }
+            default: {
+                auto right = std::move(stack.back());
+                stack.pop_back();
+                auto left = std::move(stack.back());
+                stack.pop_back();
+                stack.push_back(std::make_unique<BinaryOpNode>(node.type, std::move(left), std::move(right)));
+                break;
+            }
+        }
+    }
+
+    if (stack.size() != 1) {
+        throw std::logic_error("Malformed flat expression");
+    }
+    return std::move(stack.back());
+}
+
+FlatExpression FlatExpression::makeVariable(std::uint32_t id) {
+    FlatExpression result;
+    result.nodes.push_back({NodeType::VARIABLE, id});
+    return result;
+}
+
+FlatExpression FlatExpression::makeConstant(bool value) {
+    FlatExpression result;
+    result.nodes.push_back({NodeType::CONSTANT, value ? 1u : 0u});
+    return result;
+}
+
+FlatExpression FlatExpression::makeNot(const FlatExpression& operand) {
+    FlatExpression result;
+    result.nodes.reserve(operand.size() + 1);
+    result.nodes = operand.nodes;
+    result.nodes.push_back({NodeType::NOT, 0});
+    return result;
+}
+
+FlatExpression FlatExpression::makeBinary(NodeType op_type, const FlatExpression& left, const FlatExpression& right) {
+    FlatExpression result;
+    result.nodes.reserve(left.size() + right.size() + 1);
+    result.nodes.insert(result.nodes.end(), left.nodes.begin(), left.nodes.end());
+    result.nodes.insert(result.nodes.end(), right.nodes.begin(), right.nodes.end());
+    result.nodes.push_back({op_type, static_cast<std::uint32_t>(right.size() + 1)});
+    return result;
+}
+
+std::size_t FlatExpression::size() const {
+    return nodes.size();
+}
+
+bool FlatExpression::empty() const {
+    return nodes.empty();
+}
+
+std::size_t FlatExpression::root() const {
+    return nodes.size() - 1;
+}
+
+const FlatNode& FlatExpression::getNode(std::size_t index) const {
+    return nodes[index];
+}
+
+const std::vector<FlatNode>& FlatExpression::getNodes() const {
+    return nodes;
+}
+
+std::size_t FlatExpression::operandOf(std::size_t index) const {
+    return index - 1;
+}
+
+std::size_t FlatExpression::leftChild(std::size_t index) const {
+    return index - nodes[index].value;
+}
+
+std::size_t FlatExpression::rightChild(std::size_t index) const {
+    return index - 1;
+}
+
+std::size_t FlatExpression::subtreeStart(std::size_t index) const {
+    // The first node of a subtree is reached by always descending leftwards
+    while (true) {
+        NodeType type = nodes[index].type;
+        if (type == NodeType::NOT) {
+            index = operandOf(index);
+        } else if (isBinaryType(type)) {
+            index = leftChild(index);
+        } else {
+            return index;
+        }
+    }
+}
+
+FlatExpression FlatExpression::subtree(std::size_t index) const {
+    FlatExpression result;
+    result.nodes.assign(nodes.begin() + subtreeStart(index), nodes.begin() + index + 1);
+    return result;
+}
+
+FlatExpression FlatExpression::replaceSubtree(std::size_t index, const FlatExpression& replacement) const {
+    std::size_t start = subtreeStart(index);
+
+    FlatExpression result;
+    result.nodes.reserve(nodes.size() - (index + 1 - start) + replacement.size());
+    result.nodes.insert(result.nodes.end(), nodes.begin(), nodes.begin() + start);
+    result.nodes.insert(result.nodes.end(), replacement.nodes.begin(), replacement.nodes.end());
+    result.nodes.insert(result.nodes.end(), nodes.begin() + index + 1, nodes.end());
+
+    // Only ancestors whose right subtree contains the splice change their
+    // left-child offsets, but a single pass over the array is cheaper than
+    // locating them.
+    result.relink();
+    return result;
+}
+
+std::size_t FlatExpression::hash() const {
+    // The postorder array determines the tree, so hashing the records in
+    // sequence is a structural hash
+    std::size_t h = 1469598103934665603ull;
+    for (const auto& node : nodes) {
+        std::size_t word = (static_cast<std::size_t>(node.type) << 32) | node.value;
+        h ^= word + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+bool FlatExpression::operator==(const FlatExpression& other) const {
+    if (nodes.size() != other.nodes.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].type != other.nodes[i].type || nodes[i].value != other.nodes[i].value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FlatExpression::operator!=(const FlatExpression& other) const {
+    return !(*this == other);
+}
+
+bool FlatExpression::evaluate(const std::vector<bool>& assignment) const {
+    std::vector<bool> stack;
+    stack.reserve(nodes.size());
+
+    for (const auto& node : nodes) {
+        switch (node.type) {
+            case NodeType::VARIABLE:
+                stack.push_back(node.value < assignment.size() && assignment[node.value]);
+                break;
+            case NodeType::CONSTANT:
+                stack.push_back(node.value != 0);
+                break;
+            case NodeType::NOT:
+                stack.back() = !stack.back();
+                break;
+            default: {
+                bool right = stack.back();
+                stack.pop_back();
+                bool left = stack.back();
+                switch (node.type) {
+                    case NodeType::AND: stack.back() = left && right; break;
+                    case NodeType::OR: stack.back() = left || right; break;
+                    case NodeType::IMPLIES: stack.back() = !left || right; break;
+                    case NodeType::BICONDITIONAL: stack.back() = left == right; break;
+                    default: break;
+                }
+                break;
+            }
+        }
+    }
+
+    if (stack.size() != 1) {
+        throw std::logic_error("Malformed flat expression");
+    }
+    return stack.back();
+}
+
+void FlatExpression::relink() {
+    std::vector<std::uint32_t> sizes;
+
+    for (auto& node : nodes) {
+        if (node.type == NodeType::VARIABLE || node.type == NodeType::CONSTANT) {
+            sizes.push_back(1);
+        } else if (node.type == NodeType::NOT) {
+            if (sizes.empty()) {
+                throw std::logic_error("Malformed flat expression");
+            }
+            sizes.back() += 1;
+        } else {
+            if (sizes.size() < 2) {
+                throw std::logic_error("Malformed flat expression");
+            }
+            std::uint32_t right_size = sizes.back();
+            sizes.pop_back();
+            node.value = right_size + 1;
+            sizes.back() += right_size + 1;
+        }
+    }
+
+    if (!nodes.empty() && sizes.size() != 1) {
+        throw std::logic_error("Malformed flat expression");
+    }
+}
+
+}
\ No newline at end of file
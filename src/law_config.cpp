@@ -0,0 +1,159 @@
+#include "law_config.h"
+#include "law_table.h"
+#include <algorithm>
+
+namespace logixpr {
+
+namespace {
+
+std::uint32_t lawBit(LogicLaw law) {
+    return 1u << static_cast<std::uint32_t>(law);
+}
+
+const std::uint32_t ALL_LAWS_MASK = (1u << LAW_COUNT) - 1;
+
+// Node types needed for each law's pattern to match anywhere
+std::uint32_t requiredTypes(LogicLaw law) {
+    const std::uint32_t NOT = nodeTypeBit(NodeType::NOT);
+    const std::uint32_t AND = nodeTypeBit(NodeType::AND);
+    const std::uint32_t OR = nodeTypeBit(NodeType::OR);
+    const std::uint32_t CONSTANT = nodeTypeBit(NodeType::CONSTANT);
+
+    switch (law) {
+        case LogicLaw::DOUBLE_NEGATION: return NOT;
+        case LogicLaw::DE_MORGAN_AND: return NOT | AND;
+        case LogicLaw::DE_MORGAN_OR: return NOT | OR;
+        case LogicLaw::DISTRIBUTIVE_AND_OVER_OR:
+        case LogicLaw::DISTRIBUTIVE_OR_OVER_AND:
+        case LogicLaw::ABSORPTION_AND:
+        case LogicLaw::ABSORPTION_OR: return AND | OR;
+        case LogicLaw::IDENTITY_AND:
+        case LogicLaw::ANNIHILATION_AND: return AND | CONSTANT;
+        case LogicLaw::IDENTITY_OR:
+        case LogicLaw::ANNIHILATION_OR: return OR | CONSTANT;
+        case LogicLaw::COMPLEMENT_AND: return AND | NOT;
+        case LogicLaw::COMPLEMENT_OR: return OR | NOT;
+        case LogicLaw::IDEMPOTENT_AND:
+        case LogicLaw::COMMUTATIVE_AND:
+        case LogicLaw::ASSOCIATIVE_AND: return AND;
+        case LogicLaw::IDEMPOTENT_OR:
+        case LogicLaw::COMMUTATIVE_OR:
+        case LogicLaw::ASSOCIATIVE_OR: return OR;
+        case LogicLaw::IMPLICATION_ELIMINATION: return nodeTypeBit(NodeType::IMPLIES);
+        case LogicLaw::BICONDITIONAL_ELIMINATION: return nodeTypeBit(NodeType::BICONDITIONAL);
+    }
+    return 0;
+}
+
+// Node types a law can introduce
+std::uint32_t producedTypes(LogicLaw law) {
+    switch (law) {
+        case LogicLaw::DE_MORGAN_AND: return nodeTypeBit(NodeType::OR);
+        case LogicLaw::DE_MORGAN_OR: return nodeTypeBit(NodeType::AND);
+        case LogicLaw::COMPLEMENT_AND:
+        case LogicLaw::COMPLEMENT_OR: return nodeTypeBit(NodeType::CONSTANT);
+        case LogicLaw::IMPLICATION_ELIMINATION: return nodeTypeBit(NodeType::NOT) | nodeTypeBit(NodeType::OR);
+        case LogicLaw::BICONDITIONAL_ELIMINATION: return nodeTypeBit(NodeType::IMPLIES) | nodeTypeBit(NodeType::AND);
+        default: return 0;
+    }
+}
+
+}
+
+LawConfiguration::LawConfiguration() : enabled_mask(ALL_LAWS_MASK) {
+    weights.fill(1);
+    reorder();
+}
+
+LawConfiguration LawConfiguration::only(std::initializer_list<LogicLaw> laws) {
+    LawConfiguration configuration;
+    configuration.enabled_mask = 0;
+    for (LogicLaw law : laws) {
+        configuration.enabled_mask |= lawBit(law);
+    }
+    configuration.reorder();
+    return configuration;
+}
+
+LawConfiguration LawConfiguration::forProblem(const ASTNode& start_expression, const ASTNode& target_expression) {
+    std::uint32_t types = nodeTypeMask(start_expression) | nodeTypeMask(target_expression);
+
+    std::uint32_t enabled = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t i = 0; i < LAW_COUNT; ++i) {
+            LogicLaw law = static_cast<LogicLaw>(i);
+            std::uint32_t required = requiredTypes(law);
+            if ((enabled & lawBit(law)) || (types & required) != required) {
+                continue;
+            }
+            enabled |= lawBit(law);
+            types |= producedTypes(law);
+            changed = true;
+        }
+    }
+
+    LawConfiguration configuration;
+    configuration.enabled_mask = enabled;
+    configuration.reorder();
+    return configuration;
+}
+
+void LawConfiguration::enable(LogicLaw law) {
+    enabled_mask |= lawBit(law);
+    reorder();
+}
+
+void LawConfiguration::disable(LogicLaw law) {
+    enabled_mask &= ~lawBit(law);
+    reorder();
+}
+
+bool LawConfiguration::isEnabled(LogicLaw law) const {
+    return (enabled_mask & lawBit(law)) != 0;
+}
+
+void LawConfiguration::setWeight(LogicLaw law, int weight) {
+    weights[static_cast<std::size_t>(law)] = weight;
+    reorder();
+}
+
+int LawConfiguration::getWeight(LogicLaw law) const {
+    return weights[static_cast<std::size_t>(law)];
+}
+
+const std::vector<LogicLaw>& LawConfiguration::activeLaws() const {
+    return active_order;
+}
+
+bool LawConfiguration::isDefault() const {
+    return enabled_mask == ALL_LAWS_MASK &&
+           std::all_of(weights.begin(), weights.end(), [this](int weight) { return weight == weights[0]; });
+}
+
+std::uint32_t LawConfiguration::getMask() const {
+    return enabled_mask;
+}
+
+std::string LawConfiguration::key() const {
+    std::string text = std::to_string(enabled_mask);
+    for (LogicLaw law : active_order) {
+        text += ',';
+        text += std::to_string(getWeight(law));
+    }
+    return text;
+}
+
+void LawConfiguration::reorder() {
+    active_order.clear();
+    for (std::size_t i = 0; i < LAW_COUNT; ++i) {
+        if (enabled_mask & (1u << i)) {
+            active_order.push_back(static_cast<LogicLaw>(i));
+        }
+    }
+    std::stable_sort(active_order.begin(), active_order.end(),
+                     [this](LogicLaw a, LogicLaw b) { return getWeight(a) > getWeight(b); });
+}
+
+}
\ No newline at end of file
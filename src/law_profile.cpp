@@ -0,0 +1,194 @@
+#include "law_profile.h"
+#include "proof_search.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+
+namespace logixpr {
+
+namespace {
+
+const char* const PROFILE_MAGIC = "logixpr-law-profile";
+
+}
+
+LawProfile::LawProfile() : proofs(0), version(nextVersion()) {
+    counts.fill(0);
+}
+
+std::uint64_t LawProfile::nextVersion() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+}
+
+std::size_t LawProfile::slot(NodeType root, int depth, LogicLaw law) {
+    std::size_t bucket = std::min<std::size_t>(static_cast<std::size_t>(std::max(depth, 0)), DEPTH_BUCKETS - 1);
+    return (static_cast<std::size_t>(root) * DEPTH_BUCKETS + bucket) * LAW_COUNT + static_cast<std::size_t>(law);
+}
+
+std::array<std::uint64_t, LAW_COUNT> LawProfile::ranks(const Counts& table, NodeType root, int depth) {
+    // Count at this depth in the high half, total over depths in the low half
+    std::array<std::uint64_t, LAW_COUNT> rank{};
+    for (std::size_t law = 0; law < LAW_COUNT; ++law) {
+        std::uint64_t total = 0;
+        for (std::size_t bucket = 0; bucket < DEPTH_BUCKETS; ++bucket) {
+            total += table[slot(root, static_cast<int>(bucket), static_cast<LogicLaw>(law))];
+        }
+        std::uint64_t here = table[slot(root, depth, static_cast<LogicLaw>(law))];
+        rank[law] = (here << 32) | std::min<std::uint64_t>(total, UINT32_MAX);
+    }
+    return rank;
+}
+
+void LawProfile::updateVersion(const Counts& before) {
+    // Stable sorting only compares ranks, so the order changes exactly when
+    // some pair of laws compares differently
+    for (std::size_t root = 0; root < ROOT_TYPES; ++root) {
+        for (std::size_t bucket = 0; bucket < DEPTH_BUCKETS; ++bucket) {
+            auto old_rank = ranks(before, static_cast<NodeType>(root), static_cast<int>(bucket));
+            auto new_rank = ranks(counts, static_cast<NodeType>(root), static_cast<int>(bucket));
+            for (std::size_t a = 0; a < LAW_COUNT; ++a) {
+                for (std::size_t b = 0; b < LAW_COUNT; ++b) {
+                    if ((old_rank[a] < old_rank[b]) != (new_rank[a] < new_rank[b])) {
+                        version = nextVersion();
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void LawProfile::record(const ASTNode& start_expression, const Proof& proof) {
+    if (!proof.found_target || proof.steps.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Counts previous = counts;
+    const ASTNode* before = &start_expression;
+    for (std::size_t i = 0; i < proof.steps.size(); ++i) {
+        ++counts[slot(before->getType(), static_cast<int>(i), proof.steps[i].law_applied)];
+        before = proof.steps[i].expression.get();
+    }
+    ++proofs;
+    updateVersion(previous);
+}
+
+void LawProfile::recordStep(NodeType root, int depth, LogicLaw law) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Counts before = counts;
+    ++counts[slot(root, depth, law)];
+    updateVersion(before);
+}
+
+std::uint32_t LawProfile::getCount(NodeType root, int depth, LogicLaw law) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counts[slot(root, depth, law)];
+}
+
+std::size_t LawProfile::getProofCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return proofs;
+}
+
+std::uint64_t LawProfile::getVersion() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return version;
+}
+
+bool LawProfile::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::all_of(counts.begin(), counts.end(), [](std::uint32_t count) { return count == 0; });
+}
+
+void LawProfile::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Counts before = counts;
+    counts.fill(0);
+    proofs = 0;
+    updateVersion(before);
+}
+
+void LawProfile::order(NodeType root, int depth, std::vector<Transformation>& successors) const {
+    std::array<std::uint64_t, LAW_COUNT> rank;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        rank = ranks(counts, root, depth);
+    }
+    if (std::all_of(rank.begin(), rank.end(), [](std::uint64_t value) { return value == 0; })) {
+        return;
+    }
+    std::stable_sort(successors.begin(), successors.end(), [&](const Transformation& a, const Transformation& b) {
+        return rank[static_cast<std::size_t>(a.law)] > rank[static_cast<std::size_t>(b.law)];
+    });
+}
+
+void LawProfile::save(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    out << PROFILE_MAGIC << ' ' << VERSION << '\n';
+    out << "proofs " << proofs << '\n';
+    for (std::size_t root = 0; root < ROOT_TYPES; ++root) {
+        for (std::size_t bucket = 0; bucket < DEPTH_BUCKETS; ++bucket) {
+            for (std::size_t law = 0; law < LAW_COUNT; ++law) {
+                std::uint32_t count = counts[(root * DEPTH_BUCKETS + bucket) * LAW_COUNT + law];
+                if (count != 0) {
+                    out << root << ' ' << bucket << ' ' << law << ' ' << count << '\n';
+                }
+            }
+        }
+    }
+}
+
+void LawProfile::load(std::istream& in) {
+    std::string magic;
+    int version = 0;
+    std::string proofs_label;
+    std::size_t loaded_proofs = 0;
+    if (!(in >> magic >> version >> proofs_label >> loaded_proofs) || magic != PROFILE_MAGIC ||
+        version != VERSION || proofs_label != "proofs") {
+        throw std::runtime_error("Malformed law profile header");
+    }
+
+    // Parse everything before merging, so a bad file leaves the profile unchanged
+    std::vector<std::pair<std::size_t, std::uint32_t>> entries;
+    std::size_t root, bucket, law;
+    std::uint32_t count;
+    while (in >> root >> bucket >> law >> count) {
+        if (root >= ROOT_TYPES || bucket >= DEPTH_BUCKETS || law >= LAW_COUNT) {
+            throw std::runtime_error("Law profile entry out of range");
+        }
+        entries.emplace_back((root * DEPTH_BUCKETS + bucket) * LAW_COUNT + law, count);
+    }
+    if (!in.eof()) {
+        throw std::runtime_error("Malformed law profile entry");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Counts before = counts;
+    for (const auto& [index, value] : entries) {
+        counts[index] = static_cast<std::uint32_t>(std::min<std::uint64_t>(
+            static_cast<std::uint64_t>(counts[index]) + value, UINT32_MAX));
+    }
+    proofs += loaded_proofs;
+    updateVersion(before);
+}
+
+bool LawProfile::loadFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    load(in);
+    return true;
+}
+
+void LawProfile::saveFile(const std::string& path) const {
+    std::ofstream out(path);
+    save(out);
+    if (!out) {
+        throw std::runtime_error("Failed to write law profile: " + path);
+    }
+}
+
+}
\ No newline at end of file
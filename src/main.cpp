@@ -1,5 +1,10 @@
+#include "cluster.h"
+#include "minimizer.h"
 #include "parser.h"
 #include "proof_search.h"
+#include "server.h"
+#include <csignal>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -7,6 +12,22 @@
 
 using namespace logixpr;
 
+const std::size_t INTERACTIVE_RETAINED_BYTES = 64 << 20;
+const std::size_t MAX_THREAD_OPTION = 1024;
+
+// Accepts plain decimal digits only, so "-1" is rejected rather than wrapped
+bool parseCount(const std::string& text, std::size_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    try {
+        value = std::stoul(text);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
 void printUsage() {
     std::cout << "LogiXpr - Formal Logic Proof Generator\n\n";
     std::cout << "Usage: logixpr [options]\n\n";
@@ -14,11 +35,33 @@ void printUsage() {
     std::cout << "  -h, --help          Show this help message\n";
     std::cout << "  -i, --interactive   Run in interactive mode\n";
     std::cout << "  -p, --prove         Prove equivalence between two expressions\n";
-    std::cout << "  -g, --generate      Generate equivalent forms of an expression\n\n";
+    std::cout << "      --profile FILE  Order laws by, and learn into, a law usage profile\n";
+    std::cout << "  -g, --generate      Generate equivalent forms of an expression\n";
+    std::cout << "      --limit N       Stop after N forms (default 20, 0 for no limit)\n";
+    std::cout << "      --max-steps N   Law applications from the input (default 3)\n";
+    std::cout << "      --max-size N    Skip forms with more than N nodes\n";
+    std::cout << "      --threads N     Expansion workers (default 1, 0 for all cores)\n";
+    std::cout << "      --output FILE   Write one form per line to FILE\n";
+    std::cout << "  -c, --cluster FILE  Group the formulas of FILE, one per line, by equivalence\n";
+    std::cout << "      --proofs        Prove each member equivalent to its class representative\n";
+    std::cout << "      --threads N     Worker threads (default 1, 0 for all cores)\n";
+    std::cout << "  -s, --simplify      Minimize an expression to a two-level form\n";
+    std::cout << "      --pos           Product of sums instead of sum of products\n";
+    std::cout << "      --exact         Exact Quine-McCluskey (at most 16 variables)\n";
+    std::cout << "      --heuristic     Espresso-style heuristic for large inputs\n";
+    std::cout << "  --serve <socket> [threads]\n";
+    std::cout << "                      Serve requests on a Unix domain socket\n\n";
     std::cout << "Examples:\n";
     std::cout << "  logixpr -i                    # Interactive mode\n";
     std::cout << "  logixpr -p \"A & B\" \"B & A\"    # Prove equivalence\n";
-    std::cout << "  logixpr -g \"!(A & B)\"         # Generate equivalent forms\n\n";
+    std::cout << "  logixpr -g \"!(A & B)\"         # Generate equivalent forms\n";
+    std::cout << "  logixpr -g \"A -> B\" --limit 0 --max-steps 6 --threads 0 --output forms.txt\n";
+    std::cout << "                                # Stream a corpus of forms to disk\n";
+    std::cout << "  logixpr -c formulas.txt --threads 0\n";
+    std::cout << "                                # Cluster a corpus into equivalence classes\n";
+    std::cout << "  logixpr -s \"(A & B) | (A & !B)\" # Simplify to A\n";
+    std::cout << "  logixpr --serve /tmp/logixpr.sock\n";
+    std::cout << "                                # Serve tab-separated requests\n\n";
     std::cout << "Supported operators:\n";
     std::cout << "  !  ~  ¬     (NOT)\n";
     std::cout << "  &  &&  ∧    (AND)\n";
@@ -29,11 +72,247 @@ void printUsage() {
     std::cout << "  F           (FALSE)\n";
 }
 
+#if defined(__unix__) || defined(__APPLE__)
+UnixSocketServer* active_server = nullptr;
+
+void stopServer(int) {
+    if (active_server) {
+        active_server->stop();
+    }
+}
+#endif
+
+int runServer(const std::string& socket_path, std::size_t threads) {
+#if defined(__unix__) || defined(__APPLE__)
+    try {
+        UnixSocketServer server(socket_path, threads);
+        active_server = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        std::cout << "Listening on " << socket_path << "\n" << std::flush;
+        server.run();
+        active_server = nullptr;
+        return 0;
+    } catch (const std::exception& e) {
+        active_server = nullptr;
+        std::cout << "Error: " << e.what() << "\n";
+        return 1;
+    }
+#else
+    (void)socket_path;
+    (void)threads;
+    std::cout << "Server mode requires Unix domain sockets, which this platform lacks\n";
+    return 1;
+#endif
+}
+
+int runGenerate(int argc, char* argv[]) {
+    if (argc < 3 || argc % 2 == 0) {
+        std::cout << "Usage: " << argv[0] << " -g <expr> [--limit N] [--max-steps N] [--max-size N] "
+                  << "[--threads N] [--output file]\n";
+        return 1;
+    }
+    
+    EnumerationLimits limits;
+    limits.max_forms = 20;
+    std::string output_path;
+    for (int i = 3; i < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--output") {
+            output_path = value;
+            continue;
+        }
+        
+        std::size_t number = 0;
+        if (!parseCount(value, number) || (option == "--threads" && number > MAX_THREAD_OPTION)) {
+            std::cout << "Invalid value for " << option << ": " << value << "\n";
+            return 1;
+        }
+        if (option == "--limit") {
+            limits.max_forms = number;
+        } else if (option == "--max-steps") {
+            limits.max_depth = static_cast<int>(number);
+        } else if (option == "--max-size") {
+            limits.max_size = number;
+        } else if (option == "--threads") {
+            limits.threads = number;
+        } else {
+            std::cout << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+    
+    try {
+        auto expr = ExpressionParser::parse(argv[2]);
+        ProofSearch searcher;
+        ExpressionWriter writer;
+        
+        if (!output_path.empty()) {
+            std::ofstream output(output_path);
+            if (!output) {
+                std::cout << "Cannot open " << output_path << " for writing\n";
+                return 1;
+            }
+            // One form per line, written as found
+            std::size_t count = searcher.enumerateEquivalentForms(*expr, limits, [&](const ASTNode& form, int) {
+                output << writer.clear().write(form).append('\n').str();
+                return static_cast<bool>(output);
+            });
+            output.close();
+            if (!output) {
+                std::cout << "Error: failed writing " << output_path << "\n";
+                return 1;
+            }
+            std::cout << "Wrote " << count << " forms to " << output_path << "\n";
+            return 0;
+        }
+        
+        std::cout << "Equivalent forms of: " << expr->toString() << "\n\n";
+        std::size_t index = 0;
+        searcher.enumerateEquivalentForms(*expr, limits, [&](const ASTNode& form, int) {
+            std::cout << std::setw(2) << ++index << ". " << writer.clear().write(form).str() << "\n";
+            return true;
+        });
+        
+        return 0;
+        
+    } catch (const ParseError& e) {
+        std::cout << "Parse error: " << e.what() << " at position " << e.getPosition() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
+
+int runCluster(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " -c <file> [--proofs] [--threads N]\n";
+        return 1;
+    }
+    
+    EquivalenceClusterer clusterer;
+    bool with_proofs = false;
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--proofs") {
+            with_proofs = true;
+        } else if (option == "--threads" && i + 1 < argc) {
+            std::size_t threads = 0;
+            if (!parseCount(argv[++i], threads) || threads > MAX_THREAD_OPTION) {
+                std::cout << "Invalid value for --threads: " << argv[i] << "\n";
+                return 1;
+            }
+            clusterer.setThreads(threads);
+        } else {
+            std::cout << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+    clusterer.setProofs(with_proofs);
+    
+    std::ifstream input(argv[2]);
+    if (!input) {
+        std::cout << "Cannot open " << argv[2] << " for reading\n";
+        return 1;
+    }
+    
+    // Blank lines are skipped; a line that does not parse is reported and skipped
+    std::vector<std::unique_ptr<ASTNode>> formulas;
+    std::vector<std::size_t> line_numbers;
+    std::string line;
+    for (std::size_t line_number = 1; std::getline(input, line); ++line_number) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        try {
+            formulas.push_back(ExpressionParser::parse(line));
+            line_numbers.push_back(line_number);
+        } catch (const ParseError& e) {
+            std::cerr << "Line " << line_number << ": parse error: " << e.what() << " at position "
+                      << e.getPosition() << "\n";
+        }
+    }
+    
+    std::vector<const ASTNode*> corpus;
+    for (const auto& formula : formulas) {
+        corpus.push_back(formula.get());
+    }
+    
+    try {
+        auto classes = clusterer.cluster(corpus);
+        ExpressionWriter writer;
+        std::cout << corpus.size() << " formulas in " << classes.size() << " classes\n";
+        for (std::size_t c = 0; c < classes.size(); ++c) {
+            const auto& equivalence_class = classes[c];
+            std::cout << "\nClass " << c + 1 << " (" << equivalence_class.members.size() << " members): "
+                      << writer.clear().write(*corpus[equivalence_class.representative]).str() << "\n";
+            for (std::size_t i = 0; i < equivalence_class.members.size(); ++i) {
+                std::size_t member = equivalence_class.members[i];
+                std::cout << "  line " << line_numbers[member] << ": " << writer.clear().write(*corpus[member]).str();
+                if (with_proofs) {
+                    const Proof& proof = equivalence_class.proofs[i];
+                    if (proof.found_target) {
+                        std::cout << "  [" << proof.total_steps << " steps]";
+                    } else {
+                        std::cout << "  [no proof found]";
+                    }
+                }
+                std::cout << "\n";
+            }
+        }
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
+
+int runSimplify(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " -s <expr> [--pos] [--exact | --heuristic]\n";
+        return 1;
+    }
+    
+    LogicMinimizer minimizer;
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--pos") {
+            minimizer.setForm(NormalForm::CONJUNCTIVE);
+        } else if (option == "--exact") {
+            minimizer.setMode(MinimizationMode::EXACT);
+        } else if (option == "--heuristic") {
+            minimizer.setMode(MinimizationMode::HEURISTIC);
+        } else {
+            std::cout << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+    
+    try {
+        auto expr = ExpressionParser::parse(argv[2]);
+        auto simplified = minimizer.simplify(*expr);
+        std::cout << "Simplified: " << simplified->toString() << "\n";
+        return 0;
+        
+    } catch (const ParseError& e) {
+        std::cout << "Parse error: " << e.what() << " at position " << e.getPosition() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
+
 void runInteractiveMode() {
     std::cout << "LogiXpr Interactive Mode\n";
     std::cout << "Enter 'help' for commands, 'quit' to exit\n\n";
     
     ProofSearch searcher;
+    // Sessions tend to prove one expression against several targets in a row
+    searcher.setRetainedGraphLimit(INTERACTIVE_RETAINED_BYTES);
     std::string input;
     
     while (true) {
@@ -48,6 +327,7 @@ void runInteractiveMode() {
             std::cout << "Commands:\n";
             std::cout << "  prove <expr1> <expr2>  - Prove equivalence between expressions\n";
             std::cout << "  generate <expr>        - Generate equivalent forms\n";
+            std::cout << "  simplify <expr>        - Minimize to a sum of products\n";
             std::cout << "  parse <expr>           - Parse and display expression tree\n";
             std::cout << "  quit                   - Exit program\n\n";
             continue;
@@ -78,7 +358,7 @@ void runInteractiveMode() {
                 
                 auto proof = searcher.findProof(*expr1, *expr2);
                 
-                if (proof.found_target) {
+                if (proof.found_target || proof.refuted) {
                     ProofFormatter::printProof(proof);
                 } else {
                     std::cout << "No proof found within search limits.\n";
@@ -117,6 +397,20 @@ void runInteractiveMode() {
                 std::cout << "Error: " << e.what() << "\n";
             }
             
+        } else if (input.substr(0, 8) == "simplify") {
+            std::string expr_str = input.substr(9);
+            
+            try {
+                auto expr = ExpressionParser::parse(expr_str);
+                LogicMinimizer minimizer;
+                std::cout << "Simplified: " << minimizer.simplify(*expr)->toString() << "\n";
+                
+            } catch (const ParseError& e) {
+                std::cout << "Parse error: " << e.what() << " at position " << e.getPosition() << "\n";
+            } catch (const std::exception& e) {
+                std::cout << "Error: " << e.what() << "\n";
+            }
+            
         } else if (input.substr(0, 5) == "parse") {
             std::string expr_str = input.substr(6);
             
@@ -159,8 +453,9 @@ int main(int argc, char* argv[]) {
     }
     
     if (command == "-p" || command == "--prove") {
-        if (argc != 4) {
-            std::cout << "Usage: " << argv[0] << " -p <expr1> <expr2>\n";
+        bool with_profile = argc == 6 && std::string(argv[4]) == "--profile";
+        if (argc != 4 && !with_profile) {
+            std::cout << "Usage: " << argv[0] << " -p <expr1> <expr2> [--profile FILE]\n";
             return 1;
         }
         
@@ -169,11 +464,22 @@ int main(int argc, char* argv[]) {
             auto expr2 = ExpressionParser::parse(argv[3]);
             
             ProofSearch searcher;
+            std::shared_ptr<LawProfile> profile;
+            if (with_profile) {
+                // A missing file starts a new profile
+                profile = std::make_shared<LawProfile>();
+                profile->loadFile(argv[5]);
+                searcher.setLawProfile(profile);
+            }
             auto proof = searcher.findProof(*expr1, *expr2);
             
             ProofFormatter::printProof(proof);
             ProofFormatter::printProofStatistics(proof);
             
+            if (profile) {
+                profile->saveFile(argv[5]);
+            }
+            
             return proof.found_target ? 0 : 1;
             
         } catch (const ParseError& e) {
@@ -186,31 +492,28 @@ int main(int argc, char* argv[]) {
     }
     
     if (command == "-g" || command == "--generate") {
-        if (argc != 3) {
-            std::cout << "Usage: " << argv[0] << " -g <expr>\n";
+        return runGenerate(argc, argv);
+    }
+    
+    if (command == "-c" || command == "--cluster") {
+        return runCluster(argc, argv);
+    }
+    
+    if (command == "-s" || command == "--simplify") {
+        return runSimplify(argc, argv);
+    }
+    
+    if (command == "--serve") {
+        if (argc != 3 && argc != 4) {
+            std::cout << "Usage: " << argv[0] << " --serve <socket> [threads]\n";
             return 1;
         }
-        
-        try {
-            auto expr = ExpressionParser::parse(argv[2]);
-            
-            ProofSearch searcher;
-            auto equivalent_forms = searcher.generateEquivalentForms(*expr, 3);
-            
-            std::cout << "Equivalent forms of: " << expr->toString() << "\n\n";
-            for (size_t i = 0; i < equivalent_forms.size() && i < 20; ++i) {
-                std::cout << std::setw(2) << (i + 1) << ". " << equivalent_forms[i]->toString() << "\n";
-            }
-            
-            return 0;
-            
-        } catch (const ParseError& e) {
-            std::cout << "Parse error: " << e.what() << " at position " << e.getPosition() << "\n";
-            return 1;
-        } catch (const std::exception& e) {
-            std::cout << "Error: " << e.what() << "\n";
+        std::size_t threads = 0;
+        if (argc == 4 && (!parseCount(argv[3], threads) || threads > MAX_THREAD_OPTION)) {
+            std::cout << "Invalid thread count: " << argv[3] << "\n";
             return 1;
         }
+        return runServer(argv[2], threads);
     }
     
     std::cout << "Unknown option: " << command << "\n";
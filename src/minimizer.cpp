@@ -0,0 +1,592 @@
+#include "minimizer.h"
+#include "bdd.h"
+#include "evaluator.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace logixpr {
+
+namespace {
+
+// Assignment k of a 64-wide batch sets variable i (i < 6) to bit i of k
+const std::uint64_t BATCH_PATTERNS[6] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+};
+
+// Functions whose irredundant cover is larger are beyond what a two-level
+// form can usefully express
+const std::size_t MAX_HEURISTIC_CUBES = 1 << 16;
+
+const std::size_t DEFAULT_EXACT_VARIABLE_LIMIT = 10;
+const std::size_t DEFAULT_COVER_SEARCH_LIMIT = 100000;
+
+int popcount(std::uint64_t bits) {
+    int count = 0;
+    for (; bits; bits &= bits - 1) {
+        ++count;
+    }
+    return count;
+}
+
+int lowestBit(std::uint64_t bits) {
+    int index = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+struct CubeHasher {
+    std::size_t operator()(const Cube& cube) const {
+        return std::hash<std::uint64_t>()(cube.mask * 0x9e3779b97f4a7c15ull ^ cube.value);
+    }
+};
+
+using Cost = std::pair<std::size_t, std::size_t>;
+
+Cost coverCost(const std::vector<Cube>& cover) {
+    std::size_t literals = 0;
+    for (const Cube& cube : cover) {
+        literals += cube.literalCount();
+    }
+    return {cover.size(), literals};
+}
+
+// Orders cubes as their literal sequences compare in variable order, with a
+// present variable before an absent one and a positive literal first
+bool cubeOrder(const Cube& a, const Cube& b) {
+    std::uint64_t differences = (a.mask ^ b.mask) | ((a.value ^ b.value) & a.mask & b.mask);
+    if (!differences) {
+        return false;
+    }
+    std::uint64_t bit = std::uint64_t(1) << lowestBit(differences);
+    if ((a.mask ^ b.mask) & bit) {
+        return (a.mask & bit) != 0;
+    }
+    return (a.value & bit) != 0;
+}
+
+std::vector<std::uint64_t> onSet(const ASTNode& expression, const std::vector<std::string>& variables) {
+    auto compiled = CompiledExpression::compile(expression, variables);
+    std::size_t count = variables.size();
+    std::uint64_t total = std::uint64_t(1) << count;
+
+    std::vector<std::uint64_t> minterms;
+    std::vector<std::uint64_t> words(count);
+    for (std::uint64_t base = 0; base < total; base += 64) {
+        for (std::size_t i = 0; i < count; ++i) {
+            words[i] = i < 6 ? BATCH_PATTERNS[i] : (((base >> i) & 1) ? ~std::uint64_t(0) : 0);
+        }
+        std::uint64_t bits = compiled.evaluateBatch(words.data());
+        if (total < 64) {
+            bits &= (std::uint64_t(1) << total) - 1;
+        }
+        for (; bits; bits &= bits - 1) {
+            minterms.push_back(base + lowestBit(bits));
+        }
+    }
+    return minterms;
+}
+
+// Quine-McCluskey: merge cubes that differ in exactly one literal, level by
+// level; cubes that never merge are the prime implicants
+std::vector<Cube> primeImplicants(const std::vector<std::uint64_t>& minterms, std::size_t variable_count) {
+    std::uint64_t full_mask = (std::uint64_t(1) << variable_count) - 1;
+    std::vector<Cube> current;
+    for (std::uint64_t minterm : minterms) {
+        current.push_back({full_mask, minterm});
+    }
+
+    std::vector<Cube> primes;
+    while (!current.empty()) {
+        std::unordered_set<Cube, CubeHasher> present(current.begin(), current.end());
+        std::unordered_set<Cube, CubeHasher> merged_away;
+        std::unordered_set<Cube, CubeHasher> seen;
+        std::vector<Cube> next;
+
+        for (const Cube& cube : current) {
+            for (std::uint64_t bits = cube.mask; bits; bits &= bits - 1) {
+                std::uint64_t bit = bits & (~bits + 1);
+                Cube partner{cube.mask, cube.value ^ bit};
+                if (!present.count(partner)) {
+                    continue;
+                }
+                merged_away.insert(cube);
+                Cube merged{cube.mask & ~bit, cube.value & ~bit};
+                if (seen.insert(merged).second) {
+                    next.push_back(merged);
+                }
+            }
+        }
+        for (const Cube& cube : current) {
+            if (!merged_away.count(cube)) {
+                primes.push_back(cube);
+            }
+        }
+        current = std::move(next);
+    }
+    return primes;
+}
+
+bool covers(const Cube& cube, std::uint64_t minterm) {
+    return ((minterm ^ cube.value) & cube.mask) == 0;
+}
+
+// Minimum-cost set of primes covering every minterm: essential primes first,
+// then branch and bound on the uncovered minterm with the fewest candidates
+class CoverSearch {
+private:
+    const std::vector<Cube>& primes;
+    std::vector<std::vector<std::size_t>> candidates;
+    std::vector<std::vector<std::size_t>> covered_by;
+    std::vector<std::size_t> best;
+    Cost best_cost;
+    std::size_t budget;
+
+public:
+    CoverSearch(const std::vector<Cube>& primes, const std::vector<std::uint64_t>& minterms, std::size_t budget)
+        : primes(primes), candidates(minterms.size()), covered_by(primes.size()), budget(budget) {
+        for (std::size_t m = 0; m < minterms.size(); ++m) {
+            for (std::size_t p = 0; p < primes.size(); ++p) {
+                if (covers(primes[p], minterms[m])) {
+                    candidates[m].push_back(p);
+                    covered_by[p].push_back(m);
+                }
+            }
+        }
+    }
+
+    std::vector<Cube> solve() {
+        std::vector<int> cover_count(candidates.size(), 0);
+        std::vector<std::size_t> chosen;
+        for (std::size_t m = 0; m < candidates.size(); ++m) {
+            if (candidates[m].size() == 1 && cover_count[m] == 0) {
+                choose(candidates[m][0], chosen, cover_count, 1);
+            }
+        }
+
+        best = greedy(chosen, cover_count);
+        best_cost = cost(best);
+        search(chosen, cover_count);
+
+        std::vector<Cube> cover;
+        for (std::size_t p : best) {
+            cover.push_back(primes[p]);
+        }
+        return cover;
+    }
+
+private:
+    void choose(std::size_t prime, std::vector<std::size_t>& chosen, std::vector<int>& cover_count, int delta) {
+        if (delta > 0) {
+            chosen.push_back(prime);
+        } else {
+            chosen.pop_back();
+        }
+        for (std::size_t m : covered_by[prime]) {
+            cover_count[m] += delta;
+        }
+    }
+
+    Cost cost(const std::vector<std::size_t>& chosen) const {
+        std::size_t literals = 0;
+        for (std::size_t p : chosen) {
+            literals += primes[p].literalCount();
+        }
+        return {chosen.size(), literals};
+    }
+
+    std::size_t newlyCovered(std::size_t prime, const std::vector<int>& cover_count) const {
+        std::size_t count = 0;
+        for (std::size_t m : covered_by[prime]) {
+            count += cover_count[m] == 0;
+        }
+        return count;
+    }
+
+    std::vector<std::size_t> greedy(std::vector<std::size_t> chosen, std::vector<int> cover_count) {
+        for (std::size_t m = 0; m < candidates.size(); ++m) {
+            if (cover_count[m] != 0) {
+                continue;
+            }
+            std::size_t pick = candidates[m][0];
+            for (std::size_t p : candidates[m]) {
+                if (newlyCovered(p, cover_count) > newlyCovered(pick, cover_count)) {
+                    pick = p;
+                }
+            }
+            choose(pick, chosen, cover_count, 1);
+        }
+        return chosen;
+    }
+
+    void search(std::vector<std::size_t>& chosen, std::vector<int>& cover_count) {
+        if (budget == 0) {
+            return;
+        }
+        --budget;
+
+        Cost current = cost(chosen);
+        std::size_t branch = candidates.size();
+        for (std::size_t m = 0; m < candidates.size(); ++m) {
+            if (cover_count[m] == 0 && (branch == candidates.size() || candidates[m].size() < candidates[branch].size())) {
+                branch = m;
+            }
+        }
+        if (branch == candidates.size()) {
+            if (current < best_cost) {
+                best = chosen;
+                best_cost = current;
+            }
+            return;
+        }
+        // Any completion needs at least one more cube
+        if (Cost{current.first + 1, current.second} >= best_cost) {
+            return;
+        }
+
+        std::vector<std::size_t> options = candidates[branch];
+        std::sort(options.begin(), options.end(), [&](std::size_t a, std::size_t b) {
+            return newlyCovered(a, cover_count) > newlyCovered(b, cover_count);
+        });
+        for (std::size_t p : options) {
+            choose(p, chosen, cover_count, 1);
+            search(chosen, cover_count);
+            choose(p, chosen, cover_count, -1);
+        }
+    }
+};
+
+std::vector<Cube> exactCover(const ASTNode& expression, const std::vector<std::string>& variables,
+                             std::size_t search_limit) {
+    auto minterms = onSet(expression, variables);
+    if (minterms.size() == (std::size_t(1) << variables.size())) {
+        return {Cube{0, 0}};
+    }
+    auto primes = primeImplicants(minterms, variables.size());
+    CoverSearch search(primes, minterms, search_limit);
+    return search.solve();
+}
+
+// Starts from an irredundant cover read off the BDD, then runs Espresso-style
+// passes with the BDD as the oracle: a cube is an implicant iff it implies f,
+// and a cube is redundant iff the rest of the cover implies it
+class HeuristicMinimizer {
+private:
+    struct IsopEntry {
+        Bdd lower;
+        Bdd upper;
+        std::pair<std::vector<Cube>, Bdd> result;
+    };
+
+    BddManager manager;
+    Bdd function;
+    std::vector<Bdd> positive;
+    std::vector<Bdd> negative;
+    std::map<std::pair<const BddNode*, const BddNode*>, IsopEntry> isop_cache;
+
+public:
+    HeuristicMinimizer(const ASTNode& expression, const std::vector<std::string>& variables)
+        : manager(variables) {
+        function = manager.build(expression);
+        for (const auto& name : variables) {
+            positive.push_back(manager.variable(name));
+            negative.push_back(manager.negate(positive.back()));
+        }
+    }
+
+    std::vector<Cube> solve() {
+        if (function.isFalse()) {
+            return {};
+        }
+        if (function.isTrue()) {
+            return {Cube{0, 0}};
+        }
+
+        std::vector<Cube> cover = isop(function, function).first;
+        isop_cache.clear();
+        expand(cover);
+        irredundant(cover);
+
+        Cost best_cost = coverCost(cover);
+        while (true) {
+            std::vector<Cube> candidate = cover;
+            reduce(candidate);
+            expand(candidate);
+            irredundant(candidate);
+            Cost candidate_cost = coverCost(candidate);
+            if (!(candidate_cost < best_cost)) {
+                break;
+            }
+            cover = std::move(candidate);
+            best_cost = candidate_cost;
+        }
+        return cover;
+    }
+
+private:
+    Bdd cubeBdd(const Cube& cube) {
+        Bdd result = manager.constant(true);
+        for (std::uint64_t bits = cube.mask; bits; bits &= bits - 1) {
+            int variable = lowestBit(bits);
+            result = manager.conjunction(result, (cube.value >> variable) & 1 ? positive[variable] : negative[variable]);
+        }
+        return result;
+    }
+
+    bool implies(const Bdd& f, const Bdd& g) {
+        return manager.implication(f, g).isTrue();
+    }
+
+    // Minato-Morreale irredundant sum of products of any function between
+    // lower and upper, built by recursion on the top variable's cofactors
+    std::pair<std::vector<Cube>, Bdd> isop(const Bdd& lower, const Bdd& upper) {
+        if (lower.isFalse()) {
+            return {{}, manager.constant(false)};
+        }
+        if (upper.isTrue()) {
+            return {{Cube{0, 0}}, manager.constant(true)};
+        }
+        auto key = std::make_pair(lower.getNode(), upper.getNode());
+        auto cached = isop_cache.find(key);
+        if (cached != isop_cache.end()) {
+            return cached->second.result;
+        }
+
+        std::uint32_t level = std::min(lower.getNode()->level, upper.getNode()->level);
+        Bdd lower_low = manager.cofactor(lower, level, false);
+        Bdd lower_high = manager.cofactor(lower, level, true);
+        Bdd upper_low = manager.cofactor(upper, level, false);
+        Bdd upper_high = manager.cofactor(upper, level, true);
+
+        auto low = isop(manager.conjunction(lower_low, manager.negate(upper_high)), upper_low);
+        auto high = isop(manager.conjunction(lower_high, manager.negate(upper_low)), upper_high);
+        Bdd rest = manager.disjunction(manager.conjunction(lower_low, manager.negate(low.second)),
+                                       manager.conjunction(lower_high, manager.negate(high.second)));
+        auto shared = isop(rest, manager.conjunction(upper_low, upper_high));
+
+        std::uint64_t bit = std::uint64_t(1) << level;
+        std::vector<Cube> cover;
+        for (const Cube& cube : low.first) {
+            cover.push_back({cube.mask | bit, cube.value});
+        }
+        for (const Cube& cube : high.first) {
+            cover.push_back({cube.mask | bit, cube.value | bit});
+        }
+        cover.insert(cover.end(), shared.first.begin(), shared.first.end());
+        if (cover.size() > MAX_HEURISTIC_CUBES) {
+            throw std::invalid_argument("Function has too many terms for two-level minimization");
+        }
+
+        Bdd covered = manager.disjunction(
+            manager.disjunction(manager.conjunction(negative[level], low.second),
+                                manager.conjunction(positive[level], high.second)),
+            shared.second);
+        // The entry keeps both bounds referenced so their nodes cannot be recycled under the key
+        isop_cache.emplace(key, IsopEntry{lower, upper, {cover, covered}});
+        return {std::move(cover), std::move(covered)};
+    }
+
+    // Drops literals from each cube while it stays an implicant, then removes
+    // cubes the enlarged ones contain; small cubes go first since they have
+    // the fewest literals left to try
+    void expand(std::vector<Cube>& cover) {
+        std::stable_sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) {
+            return a.literalCount() < b.literalCount();
+        });
+        std::vector<Cube> expanded;
+        for (Cube cube : cover) {
+            bool contained = std::any_of(expanded.begin(), expanded.end(),
+                                         [&](const Cube& other) { return other.contains(cube); });
+            if (contained) {
+                continue;
+            }
+            for (std::uint64_t bits = cube.mask; bits; bits &= bits - 1) {
+                std::uint64_t bit = bits & (~bits + 1);
+                Cube raised{cube.mask & ~bit, cube.value & ~bit};
+                if (implies(cubeBdd(raised), function)) {
+                    cube = raised;
+                }
+            }
+            expanded.erase(std::remove_if(expanded.begin(), expanded.end(),
+                                          [&](const Cube& other) { return cube.contains(other); }),
+                           expanded.end());
+            expanded.push_back(cube);
+        }
+        cover = std::move(expanded);
+    }
+
+    // or[i] is the disjunction of cover[i..]
+    std::vector<Bdd> suffixDisjunctions(const std::vector<Cube>& cover) {
+        std::vector<Bdd> suffix(cover.size() + 1, manager.constant(false));
+        for (std::size_t i = cover.size(); i-- > 0;) {
+            suffix[i] = manager.disjunction(cubeBdd(cover[i]), suffix[i + 1]);
+        }
+        return suffix;
+    }
+
+    // Removes cubes covered by the others, trying the largest cubes last
+    void irredundant(std::vector<Cube>& cover) {
+        std::stable_sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) {
+            return a.literalCount() > b.literalCount();
+        });
+        auto suffix = suffixDisjunctions(cover);
+        Bdd kept_disjunction = manager.constant(false);
+        std::vector<Cube> kept;
+        for (std::size_t i = 0; i < cover.size(); ++i) {
+            Bdd cube = cubeBdd(cover[i]);
+            if (implies(cube, manager.disjunction(kept_disjunction, suffix[i + 1]))) {
+                continue;
+            }
+            kept_disjunction = manager.disjunction(kept_disjunction, cube);
+            kept.push_back(cover[i]);
+        }
+        cover = std::move(kept);
+    }
+
+    // Shrinks each cube to the smallest cube containing the part of it no
+    // other cube covers, which lets the next expand move in a new direction
+    void reduce(std::vector<Cube>& cover) {
+        auto suffix = suffixDisjunctions(cover);
+        Bdd reduced_disjunction = manager.constant(false);
+        std::vector<Cube> reduced;
+        for (std::size_t i = 0; i < cover.size(); ++i) {
+            Bdd others = manager.disjunction(reduced_disjunction, suffix[i + 1]);
+            Bdd part = manager.conjunction(cubeBdd(cover[i]), manager.negate(others));
+            if (part.isFalse()) {
+                continue;
+            }
+            Cube cube = supercube(part);
+            reduced_disjunction = manager.disjunction(reduced_disjunction, cubeBdd(cube));
+            reduced.push_back(cube);
+        }
+        cover = std::move(reduced);
+    }
+
+    Cube supercube(const Bdd& part) {
+        Cube cube{0, 0};
+        for (std::size_t i = 0; i < positive.size(); ++i) {
+            std::uint64_t bit = std::uint64_t(1) << i;
+            if (manager.conjunction(part, negative[i]).isFalse()) {
+                cube.mask |= bit;
+                cube.value |= bit;
+            } else if (manager.conjunction(part, positive[i]).isFalse()) {
+                cube.mask |= bit;
+            }
+        }
+        return cube;
+    }
+};
+
+std::unique_ptr<ASTNode> joinTerms(std::vector<std::unique_ptr<ASTNode>> terms, NodeType type) {
+    std::unique_ptr<ASTNode> result = std::move(terms.front());
+    for (std::size_t i = 1; i < terms.size(); ++i) {
+        result = std::make_unique<BinaryOpNode>(type, std::move(result), std::move(terms[i]));
+    }
+    return result;
+}
+
+// A sum of the cubes, or with dual set the product of their complements,
+// i.e. the cubes of the complement read back as clauses
+std::unique_ptr<ASTNode> buildTwoLevel(const std::vector<Cube>& cover, const std::vector<std::string>& variables,
+                                       bool dual) {
+    NodeType inner = dual ? NodeType::OR : NodeType::AND;
+    NodeType outer = dual ? NodeType::AND : NodeType::OR;
+    if (cover.empty()) {
+        return std::make_unique<ConstantNode>(dual);
+    }
+
+    std::vector<std::unique_ptr<ASTNode>> terms;
+    for (const Cube& cube : cover) {
+        if (cube.mask == 0) {
+            return std::make_unique<ConstantNode>(!dual);
+        }
+        std::vector<std::unique_ptr<ASTNode>> literals;
+        for (std::uint64_t bits = cube.mask; bits; bits &= bits - 1) {
+            int variable = lowestBit(bits);
+            std::unique_ptr<ASTNode> literal = std::make_unique<VariableNode>(variables[variable]);
+            if ((((cube.value >> variable) & 1) != 0) == dual) {
+                literal = std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(literal));
+            }
+            literals.push_back(std::move(literal));
+        }
+        terms.push_back(joinTerms(std::move(literals), inner));
+    }
+    return joinTerms(std::move(terms), outer);
+}
+
+}
+
+bool Cube::contains(const Cube& other) const {
+    return (mask & other.mask) == mask && ((value ^ other.value) & mask) == 0;
+}
+
+std::size_t Cube::literalCount() const {
+    return static_cast<std::size_t>(popcount(mask));
+}
+
+bool Cube::operator==(const Cube& other) const {
+    return mask == other.mask && value == other.value;
+}
+
+LogicMinimizer::LogicMinimizer(NormalForm form, MinimizationMode mode)
+    : form(NormalForm::DISJUNCTIVE), mode(mode), exact_variable_limit(DEFAULT_EXACT_VARIABLE_LIMIT),
+      cover_search_limit(DEFAULT_COVER_SEARCH_LIMIT) {
+    setForm(form);
+}
+
+std::unique_ptr<ASTNode> LogicMinimizer::simplify(const ASTNode& expression) const {
+    auto variables = TruthTable::collectVariables(expression);
+    if (form == NormalForm::DISJUNCTIVE) {
+        return buildTwoLevel(minimizeCover(expression, variables), variables, false);
+    }
+    // A product of sums of f is a sum of products of !f with every literal flipped
+    UnaryOpNode complement(NodeType::NOT, expression.clone());
+    return buildTwoLevel(minimizeCover(complement, variables), variables, true);
+}
+
+std::vector<Cube> LogicMinimizer::minimizeCover(const ASTNode& expression,
+                                                const std::vector<std::string>& variables) const {
+    if (variables.size() > MAX_VARIABLES) {
+        throw std::invalid_argument("Too many variables for two-level minimization");
+    }
+
+    bool exact = mode == MinimizationMode::EXACT ||
+                 (mode == MinimizationMode::AUTOMATIC && variables.size() <= exact_variable_limit);
+    if (exact && variables.size() > MAX_EXACT_VARIABLES) {
+        throw std::invalid_argument("Too many variables for exact minimization");
+    }
+
+    std::vector<Cube> cover = exact ? exactCover(expression, variables, cover_search_limit)
+                                    : HeuristicMinimizer(expression, variables).solve();
+    std::sort(cover.begin(), cover.end(), cubeOrder);
+    return cover;
+}
+
+void LogicMinimizer::setForm(NormalForm normal_form) {
+    if (normal_form == NormalForm::NEGATION) {
+        throw std::invalid_argument("Minimization produces a conjunctive or disjunctive form");
+    }
+    form = normal_form;
+}
+
+void LogicMinimizer::setMode(MinimizationMode minimization_mode) {
+    mode = minimization_mode;
+}
+
+void LogicMinimizer::setExactVariableLimit(std::size_t limit) {
+    exact_variable_limit = std::min(limit, MAX_EXACT_VARIABLES);
+}
+
+void LogicMinimizer::setCoverSearchLimit(std::size_t limit) {
+    cover_search_limit = limit;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "normal_form.h"
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace logixpr {
+
+namespace {
+
+using Path = std::vector<int>;
+
+std::unique_ptr<ASTNode> replaceAt(const ASTNode& node, const Path& path, std::size_t depth,
+                                   std::unique_ptr<ASTNode> replacement) {
+    if (depth == path.size()) {
+        return replacement;
+    }
+    if (node.getType() == NodeType::NOT) {
+        const auto& unary = static_cast<const UnaryOpNode&>(node);
+        return std::make_unique<UnaryOpNode>(NodeType::NOT,
+                                             replaceAt(unary.getOperand(), path, depth + 1, std::move(replacement)));
+    }
+
+    const auto& binary = static_cast<const BinaryOpNode&>(node);
+    if (path[depth] == 0) {
+        return std::make_unique<BinaryOpNode>(node.getType(),
+                                              replaceAt(binary.getLeft(), path, depth + 1, std::move(replacement)),
+                                              binary.getRight().clone());
+    }
+    return std::make_unique<BinaryOpNode>(node.getType(), binary.getLeft().clone(),
+                                          replaceAt(binary.getRight(), path, depth + 1, std::move(replacement)));
+}
+
+bool isBinary(const ASTNode& node) {
+    NodeType type = node.getType();
+    return type == NodeType::AND || type == NodeType::OR ||
+           type == NodeType::IMPLIES || type == NodeType::BICONDITIONAL;
+}
+
+// Chain elements are ordered by their atom first so that a literal and its
+// negation end up next to each other
+struct ElementKey {
+    std::string atom;
+    bool negated;
+};
+
+ElementKey elementKey(const ASTNode& node) {
+    if (node.getType() == NodeType::NOT) {
+        return {static_cast<const UnaryOpNode&>(node).getOperand().toString(), true};
+    }
+    return {node.toString(), false};
+}
+
+class RewriteSession {
+public:
+    using Rule = std::function<bool(const ASTNode&, const Path&)>;
+
+private:
+    EquivalenceEngine& equivalence_engine;
+    std::unique_ptr<ASTNode> current;
+    std::vector<ProofStep>& steps;
+    std::size_t first_step;
+    std::size_t max_steps;
+    const CancellationToken& cancellation;
+
+public:
+    RewriteSession(EquivalenceEngine& engine, std::unique_ptr<ASTNode> expression,
+                   std::vector<ProofStep>& steps, std::size_t max_steps, const CancellationToken& cancellation)
+        : equivalence_engine(engine), current(std::move(expression)), steps(steps),
+          first_step(steps.size()), max_steps(max_steps), cancellation(cancellation) {}
+
+    bool exhausted() const {
+        return steps.size() - first_step > max_steps || cancellation.isCancelled();
+    }
+
+    std::unique_ptr<ASTNode> release() {
+        return std::move(current);
+    }
+
+    bool apply(const Path& path, LogicLaw law) {
+        const ASTNode* node = current.get();
+        for (int index : path) {
+            if (node->getType() == NodeType::NOT) {
+                node = &static_cast<const UnaryOpNode*>(node)->getOperand();
+            } else {
+                const auto* binary = static_cast<const BinaryOpNode*>(node);
+                node = index == 0 ? &binary->getLeft() : &binary->getRight();
+            }
+        }
+
+        auto result = equivalence_engine.applyLawToNode(*node, law);
+        if (!result) {
+            return false;
+        }
+        current = replaceAt(*current, path, 0, std::move(result));
+        steps.emplace_back(current->clone(), law, LogicLaws::getLawName(law), static_cast<int>(steps.size()) + 1);
+        return true;
+    }
+
+    // Applies the rule until it no longer fires anywhere; each round rewrites
+    // the first accepting position in preorder
+    bool runPhase(const Rule& rule) {
+        bool changed = false;
+        while (!exhausted() && rewriteOnce(rule)) {
+            changed = true;
+        }
+        return changed;
+    }
+
+    bool rewriteOnce(const Rule& rule) {
+        Path path;
+        return visit(*current, path, rule);
+    }
+
+private:
+    bool visit(const ASTNode& node, Path& path, const Rule& rule) {
+        if (rule(node, path)) {
+            return true;
+        }
+        if (node.getType() == NodeType::NOT) {
+            path.push_back(0);
+            if (visit(static_cast<const UnaryOpNode&>(node).getOperand(), path, rule)) {
+                return true;
+            }
+            path.pop_back();
+        } else if (isBinary(node)) {
+            const auto& binary = static_cast<const BinaryOpNode&>(node);
+            path.push_back(0);
+            if (visit(binary.getLeft(), path, rule)) {
+                return true;
+            }
+            path.back() = 1;
+            if (visit(binary.getRight(), path, rule)) {
+                return true;
+            }
+            path.pop_back();
+        }
+        return false;
+    }
+};
+
+}
+
+NormalFormRewriter::NormalFormRewriter(NormalForm form, std::size_t max_steps)
+    : form(form), max_steps(max_steps) {}
+
+std::unique_ptr<ASTNode> NormalFormRewriter::normalize(const ASTNode& expression, std::vector<ProofStep>& steps) {
+    RewriteSession session(equivalence_engine, expression.clone(), steps, max_steps, cancellation);
+
+    auto eliminate = [&](const ASTNode& node, const Path& path) {
+        if (node.getType() == NodeType::BICONDITIONAL) {
+            return session.apply(path, LogicLaw::BICONDITIONAL_ELIMINATION);
+        }
+        if (node.getType() == NodeType::IMPLIES) {
+            return session.apply(path, LogicLaw::IMPLICATION_ELIMINATION);
+        }
+        return false;
+    };
+
+    auto push_negations = [&](const ASTNode& node, const Path& path) {
+        if (node.getType() != NodeType::NOT) {
+            return false;
+        }
+        switch (static_cast<const UnaryOpNode&>(node).getOperand().getType()) {
+            case NodeType::NOT:
+                return session.apply(path, LogicLaw::DOUBLE_NEGATION);
+            case NodeType::AND:
+                return session.apply(path, LogicLaw::DE_MORGAN_AND);
+            case NodeType::OR:
+                return session.apply(path, LogicLaw::DE_MORGAN_OR);
+            default:
+                return false;
+        }
+    };
+
+    NodeType outer = form == NormalForm::DISJUNCTIVE ? NodeType::OR : NodeType::AND;
+    NodeType inner = form == NormalForm::DISJUNCTIVE ? NodeType::AND : NodeType::OR;
+    LogicLaw distribution = form == NormalForm::DISJUNCTIVE ? LogicLaw::DISTRIBUTIVE_AND_OVER_OR
+                                                            : LogicLaw::DISTRIBUTIVE_OR_OVER_AND;
+    auto distribute = [&](const ASTNode& node, const Path& path) {
+        if (node.getType() != inner) {
+            return false;
+        }
+        const auto& binary = static_cast<const BinaryOpNode&>(node);
+        if (binary.getLeft().getType() == outer || binary.getRight().getType() == outer) {
+            return session.apply(path, distribution);
+        }
+        return false;
+    };
+
+    auto simplify = [&](const ASTNode& node, const Path& path) {
+        static const LogicLaw and_laws[] = {
+            LogicLaw::IDENTITY_AND, LogicLaw::ANNIHILATION_AND, LogicLaw::COMPLEMENT_AND,
+            LogicLaw::IDEMPOTENT_AND, LogicLaw::ABSORPTION_AND
+        };
+        static const LogicLaw or_laws[] = {
+            LogicLaw::IDENTITY_OR, LogicLaw::ANNIHILATION_OR, LogicLaw::COMPLEMENT_OR,
+            LogicLaw::IDEMPOTENT_OR, LogicLaw::ABSORPTION_OR
+        };
+        if (node.getType() != NodeType::AND && node.getType() != NodeType::OR) {
+            return false;
+        }
+        for (LogicLaw law : node.getType() == NodeType::AND ? and_laws : or_laws) {
+            if (session.apply(path, law)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto associate = [&](const ASTNode& node, const Path& path) {
+        if (node.getType() != NodeType::AND && node.getType() != NodeType::OR) {
+            return false;
+        }
+        if (static_cast<const BinaryOpNode&>(node).getLeft().getType() != node.getType()) {
+            return false;
+        }
+        return session.apply(path, node.getType() == NodeType::AND ? LogicLaw::ASSOCIATIVE_AND
+                                                                   : LogicLaw::ASSOCIATIVE_OR);
+    };
+
+    // Bubble sort over right-associated chains. Swapping two elements inside
+    // a chain takes associativity, commutativity and associativity back.
+    auto sort = [&](const ASTNode& node, const Path& path) {
+        NodeType type = node.getType();
+        if (type != NodeType::AND && type != NodeType::OR) {
+            return false;
+        }
+        bool is_and = type == NodeType::AND;
+        LogicLaw associative = is_and ? LogicLaw::ASSOCIATIVE_AND : LogicLaw::ASSOCIATIVE_OR;
+        LogicLaw commutative = is_and ? LogicLaw::COMMUTATIVE_AND : LogicLaw::COMMUTATIVE_OR;
+        LogicLaw idempotent = is_and ? LogicLaw::IDEMPOTENT_AND : LogicLaw::IDEMPOTENT_OR;
+        LogicLaw complement = is_and ? LogicLaw::COMPLEMENT_AND : LogicLaw::COMPLEMENT_OR;
+
+        const auto& binary = static_cast<const BinaryOpNode&>(node);
+        bool nested = binary.getRight().getType() == type;
+        const ASTNode& next = nested ? static_cast<const BinaryOpNode&>(binary.getRight()).getLeft()
+                                     : binary.getRight();
+
+        ElementKey left_key = elementKey(binary.getLeft());
+        ElementKey right_key = elementKey(next);
+        bool out_of_order = left_key.atom > right_key.atom ||
+                            (left_key.atom == right_key.atom && left_key.negated && !right_key.negated);
+        bool collapses = left_key.atom == right_key.atom && !out_of_order;
+        if (!out_of_order && !collapses) {
+            return false;
+        }
+
+        if (!nested) {
+            if (out_of_order) {
+                return session.apply(path, commutative);
+            }
+            return session.apply(path, idempotent) || session.apply(path, complement);
+        }
+
+        Path pair = path;
+        pair.push_back(0);
+        session.apply(path, associative);
+        if (out_of_order) {
+            session.apply(pair, commutative);
+            session.apply(path, associative);
+            return true;
+        }
+        return session.apply(pair, idempotent) || session.apply(pair, complement);
+    };
+
+    session.runPhase(eliminate);
+    session.runPhase(push_negations);
+
+    // Tautologies and duplicates are removed between distribution steps;
+    // distributing first would multiply them out before they are noticed
+    while (!session.exhausted()) {
+        bool changed = session.runPhase(simplify);
+        changed |= session.runPhase(associate);
+        changed |= session.runPhase(sort);
+        if (changed) {
+            continue;
+        }
+        if (form == NormalForm::NEGATION || !session.rewriteOnce(distribute)) {
+            break;
+        }
+    }
+
+    if (session.exhausted()) {
+        return nullptr;
+    }
+    return session.release();
+}
+
+Proof NormalFormRewriter::proveEquivalence(const ASTNode& start_expression, const ASTNode& target_expression) {
+    Proof proof;
+
+    std::vector<ProofStep> start_steps;
+    std::vector<ProofStep> target_steps;
+    auto start_normal = normalize(start_expression, start_steps);
+    auto target_normal = normalize(target_expression, target_steps);
+    if (!start_normal || !target_normal || start_normal->toString() != target_normal->toString()) {
+        return proof;
+    }
+
+    // Position of every expression on the target chain, counted from the
+    // target itself, so the start chain can be cut where it first joins it
+    std::unordered_map<std::string, std::size_t> target_chain;
+    target_chain.emplace(target_expression.toString(), 0);
+    for (std::size_t i = 0; i < target_steps.size(); ++i) {
+        target_chain.emplace(target_steps[i].expression->toString(), i + 1);
+    }
+
+    std::size_t join = target_chain.at(target_expression.toString());
+    std::size_t start_length = 0;
+    auto found = target_chain.find(start_expression.toString());
+    if (found != target_chain.end()) {
+        join = found->second;
+    } else {
+        for (; start_length < start_steps.size(); ++start_length) {
+            found = target_chain.find(start_steps[start_length].expression->toString());
+            if (found != target_chain.end()) {
+                join = found->second;
+                ++start_length;
+                break;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < start_length; ++i) {
+        proof.steps.push_back(std::move(start_steps[i]));
+    }
+    for (std::size_t i = join; i > 0; --i) {
+        const ASTNode& previous = i >= 2 ? *target_steps[i - 2].expression : target_expression;
+        LogicLaw law = target_steps[i - 1].law_applied;
+        proof.steps.emplace_back(previous.clone(), law, LogicLaws::getLawName(law) + " (reversed)", 0);
+    }
+
+    for (std::size_t i = 0; i < proof.steps.size(); ++i) {
+        proof.steps[i].step_number = static_cast<int>(i) + 1;
+    }
+    proof.found_target = true;
+    proof.total_steps = static_cast<int>(proof.steps.size());
+    return proof;
+}
+
+void NormalFormRewriter::setForm(NormalForm normal_form) {
+    form = normal_form;
+}
+
+void NormalFormRewriter::setMaxSteps(std::size_t steps) {
+    max_steps = steps;
+}
+
+void NormalFormRewriter::setCancellationToken(CancellationToken token) {
+    cancellation = std::move(token);
+}
+
+}
\ No newline at end of file
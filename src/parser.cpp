@@ -118,6 +118,12 @@ Token Lexer::readOperator() {
     } else if ((ch == '&' || ch == '|') && currentChar() == ch) {
         op_str += currentChar();
         advance();
+    } else if (static_cast<unsigned char>(ch) >= 0x80) {
+        // The Unicode connectives are multi-byte UTF-8; take the continuation bytes too
+        while ((static_cast<unsigned char>(currentChar()) & 0xC0) == 0x80) {
+            op_str += currentChar();
+            advance();
+        }
     }
     
     auto it = operators.find(op_str);
@@ -164,66 +170,73 @@ void Parser::consume(TokenType type) {
     advance();
 }
 
+// Operator-precedence parsing with explicit operand/operator stacks, so
+// nesting depth (parentheses, !!!!... prefixes, long -> chains) costs heap
+// rather than call stack. Precedence from loosest: <->, ->, |, &, !.
 std::unique_ptr<ASTNode> Parser::parseExpression() {
-    return parseBiconditional();
-}
-
-std::unique_ptr<ASTNode> Parser::parseBiconditional() {
-    auto left = parseImplication();
-    
-    while (match(TokenType::BICONDITIONAL)) {
-        advance();
-        auto right = parseImplication();
-        left = std::make_unique<BinaryOpNode>(NodeType::BICONDITIONAL, std::move(left), std::move(right));
-    }
-    
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseImplication() {
-    auto left = parseDisjunction();
-    
-    if (match(TokenType::IMPLIES)) {
-        advance();
-        auto right = parseImplication();
-        return std::make_unique<BinaryOpNode>(NodeType::IMPLIES, std::move(left), std::move(right));
-    }
+    std::vector<std::unique_ptr<ASTNode>> operands;
+    std::vector<TokenType> operators;
+    size_t open_parens = 0;
+    bool expect_operand = true;
     
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseDisjunction() {
-    auto left = parseConjunction();
-    
-    while (match(TokenType::OR)) {
-        advance();
-        auto right = parseConjunction();
-        left = std::make_unique<BinaryOpNode>(NodeType::OR, std::move(left), std::move(right));
-    }
-    
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseConjunction() {
-    auto left = parseNegation();
-    
-    while (match(TokenType::AND)) {
-        advance();
-        auto right = parseNegation();
-        left = std::make_unique<BinaryOpNode>(NodeType::AND, std::move(left), std::move(right));
+    while (true) {
+        const Token& token = currentToken();
+        
+        if (expect_operand) {
+            if (token.type == TokenType::NOT || token.type == TokenType::LPAREN) {
+                if (token.type == TokenType::LPAREN) {
+                    open_parens++;
+                }
+                operators.push_back(token.type);
+                advance();
+                continue;
+            }
+            operands.push_back(parsePrimary());
+            expect_operand = false;
+            continue;
+        }
+        
+        if (isBinaryOperator(token.type)) {
+            int token_precedence = precedence(token.type);
+            while (!operators.empty() && operators.back() != TokenType::LPAREN) {
+                int top_precedence = precedence(operators.back());
+                // Implication is right-associative, the other binaries left-associative
+                bool pops = top_precedence > token_precedence ||
+                            (top_precedence == token_precedence && token.type != TokenType::IMPLIES);
+                if (!pops) {
+                    break;
+                }
+                reduce(operands, operators.back());
+                operators.pop_back();
+            }
+            operators.push_back(token.type);
+            expect_operand = true;
+            advance();
+            continue;
+        }
+        
+        if (token.type == TokenType::RPAREN && open_parens > 0) {
+            while (operators.back() != TokenType::LPAREN) {
+                reduce(operands, operators.back());
+                operators.pop_back();
+            }
+            operators.pop_back();
+            open_parens--;
+            advance();
+            continue;
+        }
+        
+        if (open_parens > 0) {
+            throw ParseError("Expected different token type", token.position);
+        }
+        break;
     }
     
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseNegation() {
-    if (match(TokenType::NOT)) {
-        advance();
-        auto operand = parseNegation();
-        return std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(operand));
+    while (!operators.empty()) {
+        reduce(operands, operators.back());
+        operators.pop_back();
     }
-    
-    return parsePrimary();
+    return std::move(operands.back());
 }
 
 std::unique_ptr<ASTNode> Parser::parsePrimary() {
@@ -243,14 +256,41 @@ std::unique_ptr<ASTNode> Parser::parsePrimary() {
         return std::make_unique<ConstantNode>(false);
     }
     
-    if (match(TokenType::LPAREN)) {
-        advance();
-        auto expr = parseExpression();
-        consume(TokenType::RPAREN);
-        return expr;
+    throw ParseError("Expected variable, constant, or parenthesized expression", currentToken().position);
+}
+
+bool Parser::isBinaryOperator(TokenType type) {
+    return type == TokenType::AND || type == TokenType::OR ||
+           type == TokenType::IMPLIES || type == TokenType::BICONDITIONAL;
+}
+
+int Parser::precedence(TokenType type) {
+    switch (type) {
+        case TokenType::NOT: return 5;
+        case TokenType::AND: return 4;
+        case TokenType::OR: return 3;
+        case TokenType::IMPLIES: return 2;
+        case TokenType::BICONDITIONAL: return 1;
+        default: return 0;
+    }
+}
+
+void Parser::reduce(std::vector<std::unique_ptr<ASTNode>>& operands, TokenType op) {
+    if (op == TokenType::NOT) {
+        operands.back() = std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(operands.back()));
+        return;
     }
     
-    throw ParseError("Expected variable, constant, or parenthesized expression", currentToken().position);
+    NodeType type = NodeType::AND;
+    switch (op) {
+        case TokenType::OR: type = NodeType::OR; break;
+        case TokenType::IMPLIES: type = NodeType::IMPLIES; break;
+        case TokenType::BICONDITIONAL: type = NodeType::BICONDITIONAL; break;
+        default: break;
+    }
+    auto right = std::move(operands.back());
+    operands.pop_back();
+    operands.back() = std::make_unique<BinaryOpNode>(type, std::move(operands.back()), std::move(right));
 }
 
 std::unique_ptr<ASTNode> ExpressionParser::parse(const std::string& expression) {
@@ -0,0 +1,133 @@
+#include "proof_optimizer.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace logixpr {
+
+namespace {
+
+const std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+struct SearchRecord {
+    std::unique_ptr<ASTNode> expression;
+    std::size_t parent;
+    std::size_t depth;
+    LogicLaw law;
+    std::string description;
+};
+
+}
+
+ProofOptimizer::ProofOptimizer(std::size_t window_size, std::chrono::milliseconds time_limit)
+    : window_size(window_size), max_transformations(5000), time_limit(time_limit) {}
+
+Proof ProofOptimizer::optimize(const ASTNode& start_expression, const Proof& proof) {
+    Proof optimized;
+    optimized.found_target = proof.found_target;
+    optimized.refuted = proof.refuted;
+    optimized.counterexample = proof.counterexample;
+    for (const auto& step : proof.steps) {
+        optimized.steps.emplace_back(step.expression->clone(), step.law_applied, step.description, step.step_number);
+    }
+
+    if (proof.found_target) {
+        auto deadline = std::chrono::steady_clock::now() + time_limit;
+
+        // chain[k] is the expression after k steps
+        auto expressionAt = [&](std::size_t k) -> const ASTNode& {
+            return k == 0 ? start_expression : *optimized.steps[k - 1].expression;
+        };
+
+        bool improved = true;
+        while (improved && std::chrono::steady_clock::now() < deadline) {
+            improved = false;
+            for (std::size_t i = 0; i + 2 <= optimized.steps.size(); ++i) {
+                std::size_t last = std::min(i + window_size, optimized.steps.size());
+                for (std::size_t j = last; j >= i + 2; --j) {
+                    std::vector<ProofStep> shortcut;
+                    if (!findShortcut(expressionAt(i), expressionAt(j), j - i - 1, deadline, shortcut)) {
+                        continue;
+                    }
+                    optimized.steps.erase(optimized.steps.begin() + i, optimized.steps.begin() + j);
+                    optimized.steps.insert(optimized.steps.begin() + i,
+                                           std::make_move_iterator(shortcut.begin()),
+                                           std::make_move_iterator(shortcut.end()));
+                    improved = true;
+                    break;
+                }
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < optimized.steps.size(); ++i) {
+        optimized.steps[i].step_number = static_cast<int>(i) + 1;
+    }
+    optimized.total_steps = static_cast<int>(optimized.steps.size());
+    return optimized;
+}
+
+void ProofOptimizer::setWindowSize(std::size_t size) {
+    window_size = size;
+}
+
+void ProofOptimizer::setMaxTransformations(int transformations) {
+    max_transformations = transformations;
+}
+
+void ProofOptimizer::setTimeLimit(std::chrono::milliseconds limit) {
+    time_limit = limit;
+}
+
+bool ProofOptimizer::findShortcut(const ASTNode& from, const ASTNode& to, std::size_t max_steps,
+                                  std::chrono::steady_clock::time_point deadline, std::vector<ProofStep>& shortcut) {
+    // Windows are spliced back into a chain, so the goal test has to be exact
+    // rather than the commutativity-aware equals() used by ProofSearch
+    std::string goal = to.toString();
+
+    std::vector<SearchRecord> records;
+    records.push_back({from.clone(), 0, 0, LogicLaw::DOUBLE_NEGATION, ""});
+    std::unordered_set<std::string> visited{from.toString()};
+
+    std::size_t found = NOT_FOUND;
+    if (*visited.begin() == goal) {
+        found = 0;
+    }
+
+    int transformations_explored = 0;
+    for (std::size_t next = 0; found == NOT_FOUND && next < records.size(); ++next) {
+        if (records[next].depth >= max_steps || transformations_explored >= max_transformations ||
+            std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+
+        auto transformations = equivalence_engine.generateSingleStepTransformations(*records[next].expression);
+        transformations_explored += transformations.size();
+        for (auto& transformation : transformations) {
+            std::string key = transformation.result->toString();
+            if (!visited.insert(key).second) {
+                continue;
+            }
+            records.push_back({std::move(transformation.result), next, records[next].depth + 1,
+                               transformation.law, transformation.description});
+            if (key == goal) {
+                found = records.size() - 1;
+                break;
+            }
+        }
+    }
+
+    if (found == NOT_FOUND) {
+        return false;
+    }
+
+    for (std::size_t index = found; index != 0; index = records[index].parent) {
+        shortcut.emplace_back(std::move(records[index].expression), records[index].law, records[index].description, 0);
+    }
+    std::reverse(shortcut.begin(), shortcut.end());
+    return true;
+}
+
+}
\ No newline at end of file
@@ -1,92 +1,626 @@
 #include "proof_search.h"
+#include "bucket_queue.h"
+#include "canonical.h"
+#include "egraph.h"
+#include "normal_form.h"
+#include "proof_optimizer.h"
+#include "sat_solver.h"
 #include <algorithm>
+#include <condition_variable>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+#include <unordered_set>
 
 namespace logixpr {
 
+namespace {
+
+const std::int64_t PRECHECK_CONFLICT_LIMIT = 100000;
+
+// Node count past which a state is not expanded; about the size of an
+// expression that prints in 200 characters
+const std::size_t MAX_EXPRESSION_SIZE = 64;
+
+// States of one enumeration level expanded between two merges
+const std::size_t ENUMERATION_BATCH = 4096;
+
+std::vector<Transformation> expandWith(EquivalenceEngine& engine, const ASTNode& expression) {
+    // Transformations of the entire expression
+    auto successors = engine.generateAllTransformations(expression);
+    
+    // Transformations of each direct operand, rebuilt under the same root
+    auto rebuild = [&](std::vector<Transformation> transformations, auto make) {
+        for (auto& transformation : transformations) {
+            transformation.result = make(std::move(transformation.result));
+            successors.push_back(std::move(transformation));
+        }
+    };
+    
+    NodeType type = expression.getType();
+    if (type == NodeType::IMPLIES || type == NodeType::BICONDITIONAL ||
+        type == NodeType::AND || type == NodeType::OR) {
+        const auto& binary = static_cast<const BinaryOpNode&>(expression);
+        rebuild(engine.generateAllTransformations(binary.getLeft()),
+                [&](std::unique_ptr<ASTNode> left) -> std::unique_ptr<ASTNode> {
+                    return std::make_unique<BinaryOpNode>(type, std::move(left), binary.getRight().clone());
+                });
+        rebuild(engine.generateAllTransformations(binary.getRight()),
+                [&](std::unique_ptr<ASTNode> right) -> std::unique_ptr<ASTNode> {
+                    return std::make_unique<BinaryOpNode>(type, binary.getLeft().clone(), std::move(right));
+                });
+    } else if (type == NodeType::NOT) {
+        const auto& unary = static_cast<const UnaryOpNode&>(expression);
+        rebuild(engine.generateAllTransformations(unary.getOperand()),
+                [](std::unique_ptr<ASTNode> operand) -> std::unique_ptr<ASTNode> {
+                    return std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(operand));
+                });
+    }
+    
+    return successors;
+}
+
+}
+
+ProofCache::ProofCache(std::size_t capacity) : capacity(std::max<std::size_t>(capacity, 1)), hits(0), misses(0) {}
+
+std::shared_ptr<const Proof> ProofCache::lookup(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    return it->second;
+}
+
+void ProofCache::store(const std::string& key, std::shared_ptr<const Proof> proof) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!entries.emplace(key, std::move(proof)).second) {
+        return;
+    }
+    insertion_order.push_back(key);
+    if (insertion_order.size() > capacity) {
+        entries.erase(insertion_order.front());
+        insertion_order.pop_front();
+    }
+}
+
+void ProofCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    insertion_order.clear();
+}
+
+std::size_t ProofCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+std::size_t ProofCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+std::size_t ProofCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+BreadthFirstState::BreadthFirstState(const ASTNode& start_expression, bool indexed)
+    : graph(start_expression), indexed(indexed), expanded(0), transformations_explored(0) {
+    if (indexed) {
+        fingerprints.emplace(start_expression.getHash(), 0);
+    }
+}
+
+void BreadthFirstState::add(const ASTNode& expression, std::uint32_t parent, LogicLaw law,
+                            const std::string& description) {
+    if (graph.add(expression, parent, law, description) && indexed) {
+        fingerprints.emplace(expression.getHash(), static_cast<std::uint32_t>(graph.size() - 1));
+    }
+}
+
+std::size_t BreadthFirstState::bytesUsed() const {
+    // Same node estimate as SearchGraph's visited index
+    std::size_t fingerprint_bytes = fingerprints.size() * (sizeof(void*) * 2 + sizeof(std::size_t) * 2) +
+                                    fingerprints.bucket_count() * sizeof(void*);
+    return graph.bytesUsed() + fingerprint_bytes + explored_before.capacity() * sizeof(int);
+}
+
+SearchRetention::SearchRetention(std::size_t byte_limit) : byte_limit(byte_limit) {}
+
+std::shared_ptr<BreadthFirstState> SearchRetention::acquire(const std::string& key,
+                                                            const ASTNode& start_expression) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        return entries.front().second;
+    }
+    entries.emplace_front(key, std::make_shared<BreadthFirstState>(start_expression, true));
+    index.emplace(key, entries.begin());
+    return entries.front().second;
+}
+
+void SearchRetention::trim() {
+    std::size_t total = bytesUsed();
+    while (!entries.empty() && total > byte_limit) {
+        total -= entries.back().second->bytesUsed();
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+void SearchRetention::clear() {
+    entries.clear();
+    index.clear();
+}
+
+std::size_t SearchRetention::size() const {
+    return entries.size();
+}
+
+std::size_t SearchRetention::statesRetained() const {
+    std::size_t states = 0;
+    for (const auto& entry : entries) {
+        states += entry.second->graph.size();
+    }
+    return states;
+}
+
+std::size_t SearchRetention::bytesUsed() const {
+    std::size_t bytes = 0;
+    for (const auto& entry : entries) {
+        bytes += entry.second->bytesUsed();
+    }
+    return bytes;
+}
+
 ProofSearch::ProofSearch(int max_depth, int max_transformations) 
-    : max_depth(max_depth), max_transformations(max_transformations) {}
+    : max_depth(max_depth), max_transformations(max_transformations), semantic_precheck(true),
+      grace_window(std::chrono::milliseconds(20)), result_cache(std::make_shared<ProofCache>()), automatic_laws(true) {}
 
 Proof ProofSearch::findProof(const ASTNode& start_expression, const ASTNode& target_expression) {
-    return findShortestProof(start_expression, target_expression);
+    if (!result_cache) {
+        Proof proof = searchProof(start_expression, target_expression);
+        if (law_profile) {
+            law_profile->record(start_expression, proof);
+        }
+        return proof;
+    }
+    
+    CanonicalPair problem = canonicalizePair(start_expression, target_expression);
+    // Results depend on the limits as well as on the problem
+    std::string key = problem.key + '\t' + std::to_string(max_depth) + '\t' +
+                      std::to_string(max_transformations) + (semantic_precheck ? "\tP" : "") + '\t' +
+                      law_configuration.key() + (automatic_laws ? "\tA" : "");
+    if (auto cached = result_cache->lookup(key)) {
+        if (law_profile) {
+            law_profile->record(*problem.start, *cached);
+        }
+        return problem.renaming.toOriginal(*cached);
+    }
+    
+    auto proof = std::make_shared<Proof>(searchProof(*problem.start, *problem.target));
+    if (!cancellation.isCancelled()) {
+        result_cache->store(key, proof);
+    }
+    if (law_profile) {
+        law_profile->record(*problem.start, *proof);
+    }
+    return problem.renaming.toOriginal(*proof);
+}
+
+Proof ProofSearch::searchProof(const ASTNode& start_expression, const ASTNode& target_expression) {
+    Proof proof = findShortestProof(start_expression, target_expression);
+    // The rewriter needs its full fixed law order, so a restricted law set disables the fallback
+    if (proof.found_target || proof.refuted || cancellation.isCancelled() ||
+        !law_configuration.isDefault()) {
+        return proof;
+    }
+    
+    // Past the BFS horizon, fall back to normalizing both sides; the proof is
+    // no longer minimal but is found in time linear in the rewrite count, and
+    // the optimizer then removes most of the detours
+    Proof normal_form_proof = findNormalFormProof(start_expression, target_expression);
+    return normal_form_proof.found_target ? std::move(normal_form_proof) : std::move(proof);
 }
 
 Proof ProofSearch::findShortestProof(const ASTNode& start_expression, const ASTNode& target_expression) {
-    clearVisited();
+    Proof refutation;
+    if (refuteEquivalence(start_expression, target_expression, refutation)) {
+        return refutation;
+    }
     
-    std::queue<ProofSearchNode> queue;
-    queue.emplace(start_expression.clone(), 0, std::vector<ProofStep>());
+    configureLaws(start_expression, target_expression);
     
-    markVisited(start_expression);
+    auto state = breadthFirstState(start_expression);
+    Proof proof = continueBreadthFirst(*state, target_expression);
+    if (retention) {
+        retention->trim();
+    }
+    return proof;
+}
+
+std::shared_ptr<BreadthFirstState> ProofSearch::breadthFirstState(const ASTNode& start_expression) {
+    if (!retention) {
+        return std::make_shared<BreadthFirstState>(start_expression, false);
+    }
+    // Pruning depends on the depth limit; the budget is tracked by the state itself
+    std::string key = expressionToString(start_expression) + '\t' +
+                      equivalence_engine.getLawConfiguration().key() + '\t' + std::to_string(max_depth);
+    // The profile orders successors, and with them the record numbering
+    if (law_profile) {
+        key += "\tL" + std::to_string(law_profile->getVersion());
+    }
+    return retention->acquire(key, start_expression);
+}
+
+Proof ProofSearch::continueBreadthFirst(BreadthFirstState& state, const ASTNode& target_expression) {
+    SearchGraph& graph = state.graph;
     
-    int transformations_explored = 0;
+    // A fresh search dequeues records in index order too, so it would stop
+    // at the earliest already dequeued record equal to the target, provided
+    // its budget lasted that far
+    if (state.indexed) {
+        std::size_t match = graph.size();
+        auto [first, last] = state.fingerprints.equal_range(target_expression.getHash());
+        for (auto it = first; it != last; ++it) {
+            if (it->second < state.expanded && it->second < match &&
+                state.explored_before[it->second] < max_transformations &&
+                static_cast<int>(graph.getRecord(it->second).depth) <= max_depth &&
+                equivalence_engine.areEquivalent(*graph.expression(it->second), target_expression)) {
+                match = it->second;
+            }
+        }
+        if (match < graph.size()) {
+            return reconstructProof(graph, match);
+        }
+    }
     
-    while (!queue.empty() && transformations_explored < max_transformations) {
-        ProofSearchNode current = std::move(queue.front());
-        queue.pop();
-        
-        if (current.depth > max_depth) {
+    // Records are numbered in discovery order, so expanding them in index
+    // order is the BFS queue without holding any tree until it is expanded
+    while (state.expanded < graph.size() && state.transformations_explored < max_transformations &&
+           !cancellation.isCancelled()) {
+        std::size_t next = state.expanded;
+        if (state.indexed && state.explored_before.size() == next) {
+            state.explored_before.push_back(state.transformations_explored);
+        }
+        int depth = static_cast<int>(graph.getRecord(next).depth);
+        if (depth > max_depth) {
+            ++state.expanded;
             continue;
         }
         
-        if (equivalence_engine.areEquivalent(*current.expression, target_expression)) {
-            return reconstructProof(current.path, true);
+        auto current = graph.expression(next);
+        if (equivalence_engine.areEquivalent(*current, target_expression)) {
+            // Left unexpanded; a later query resumes by expanding it
+            return reconstructProof(graph, next);
         }
+        ++state.expanded;
         
-        if (shouldPrune(current)) {
+        if (shouldPrune(*current, depth)) {
             continue;
         }
         
-        auto expanded_nodes = expandNode(current);
-        transformations_explored += expanded_nodes.size();
+        auto successors = expandExpression(*current, depth);
+        state.transformations_explored += successors.size();
         
-        for (auto& node : expanded_nodes) {
-            if (!isVisited(*node.expression)) {
-                markVisited(*node.expression);
-                queue.push(std::move(node));
-            }
+        for (auto& successor : successors) {
+            state.add(*successor.result, static_cast<std::uint32_t>(next), successor.law, successor.description);
         }
     }
     
-    return reconstructProof({}, false);
+    return Proof();
 }
 
-std::vector<std::unique_ptr<ASTNode>> ProofSearch::generateEquivalentForms(const ASTNode& expression, int max_steps) {
-    std::vector<std::unique_ptr<ASTNode>> equivalent_forms;
-    clearVisited();
+std::vector<Proof> ProofSearch::findProofs(const ASTNode& start_expression,
+                                           const std::vector<const ASTNode*>& target_expressions) {
+    std::vector<Proof> proofs(target_expressions.size());
     
-    std::queue<ProofSearchNode> queue;
-    queue.emplace(expression.clone(), 0, std::vector<ProofStep>());
-    markVisited(expression);
+    // Pending targets by fingerprint; equal trees always share one
+    std::unordered_multimap<std::size_t, std::size_t> pending;
+    std::vector<const ASTNode*> searched_targets;
+    for (std::size_t i = 0; i < target_expressions.size(); ++i) {
+        if (!refuteEquivalence(start_expression, *target_expressions[i], proofs[i])) {
+            pending.emplace(target_expressions[i]->getHash(), i);
+            searched_targets.push_back(target_expressions[i]);
+        }
+    }
+    if (pending.empty()) {
+        return proofs;
+    }
+    
+    configureLaws(start_expression, searched_targets);
     
+    SearchGraph graph(start_expression);
     int transformations_explored = 0;
     
-    while (!queue.empty() && transformations_explored < max_transformations && equivalent_forms.size() < 50) {
-        ProofSearchNode current = std::move(queue.front());
-        queue.pop();
+    for (std::size_t next = 0; next < graph.size() && !pending.empty() &&
+                               transformations_explored < max_transformations && !cancellation.isCancelled(); ++next) {
+        int depth = static_cast<int>(graph.getRecord(next).depth);
+        if (depth > max_depth) {
+            continue;
+        }
+        
+        auto current = graph.expression(next);
+        auto [first, last] = pending.equal_range(current->getHash());
+        for (auto it = first; it != last;) {
+            if (equivalence_engine.areEquivalent(*current, *target_expressions[it->second])) {
+                proofs[it->second] = reconstructProof(graph, next);
+                if (law_profile) {
+                    law_profile->record(start_expression, proofs[it->second]);
+                }
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
         
-        if (current.depth > max_steps) {
+        if (shouldPrune(*current, depth)) {
             continue;
         }
         
-        equivalent_forms.push_back(current.expression->clone());
+        auto successors = expandExpression(*current, depth);
+        transformations_explored += successors.size();
         
-        auto expanded_nodes = expandNode(current);
-        transformations_explored += expanded_nodes.size();
+        for (auto& successor : successors) {
+            graph.add(*successor.result, static_cast<std::uint32_t>(next), successor.law, successor.description);
+        }
+    }
+    
+    return proofs;
+}
+
+Proof ProofSearch::findBestFirstProof(const ASTNode& start_expression, const ASTNode& target_expression) {
+    Proof refutation;
+    if (refuteEquivalence(start_expression, target_expression, refutation)) {
+        return refutation;
+    }
+    
+    configureLaws(start_expression, target_expression);
+    
+    // Priorities are small integers; ties go to the earlier node, which keeps
+    // the order deterministic
+    BucketQueue<std::size_t> frontier;
+    SearchGraph graph(start_expression);
+    frontier.push(estimateDistance(start_expression, target_expression), 0);
+    
+    int transformations_explored = 0;
+    
+    while (!frontier.empty() && transformations_explored < max_transformations && !cancellation.isCancelled()) {
+        std::size_t index = frontier.pop();
+        
+        auto current = graph.expression(index);
+        if (equivalence_engine.areEquivalent(*current, target_expression)) {
+            return reconstructProof(graph, index);
+        }
+        
+        int depth = static_cast<int>(graph.getRecord(index).depth);
+        if (shouldPrune(*current, depth)) {
+            continue;
+        }
         
-        for (auto& node : expanded_nodes) {
-            if (!isVisited(*node.expression)) {
-                markVisited(*node.expression);
-                queue.push(std::move(node));
+        auto successors = expandExpression(*current, depth);
+        transformations_explored += successors.size();
+        
+        for (auto& successor : successors) {
+            if (graph.add(*successor.result, static_cast<std::uint32_t>(index), successor.law, successor.description)) {
+                int priority = depth + 1 + estimateDistance(*successor.result, target_expression);
+                frontier.push(priority, graph.size() - 1);
             }
         }
     }
     
+    return Proof();
+}
+
+PortfolioResult ProofSearch::findProofPortfolio(const ASTNode& start_expression, const ASTNode& target_expression,
+                                                const std::vector<SearchStrategy>& strategies) {
+    struct Race {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::size_t finished = 0;
+        bool decided = false;
+        bool refuted = false;
+        std::chrono::steady_clock::time_point first_result;
+        PortfolioResult result;
+    };
+    
+    auto started = std::chrono::steady_clock::now();
+    Race race;
+    CancellationToken race_token;
+    
+    std::vector<std::thread> runners;
+    runners.reserve(strategies.size());
+    for (SearchStrategy strategy : strategies) {
+        runners.emplace_back([&, strategy] {
+            ProofSearch runner = detachedCopy(race_token);
+            // One refutation is enough; it is left to the BFS runner
+            runner.semantic_precheck = semantic_precheck && strategy == SearchStrategy::BREADTH_FIRST;
+            
+            Proof proof;
+            try {
+                proof = runner.runStrategy(strategy, start_expression, target_expression);
+            } catch (const std::exception&) {
+            }
+            
+            std::lock_guard<std::mutex> lock(race.mutex);
+            ++race.finished;
+            bool refutes = proof.refuted;
+            bool better = proof.found_target &&
+                          (!race.decided || (!race.refuted && proof.steps.size() < race.result.proof.steps.size()));
+            if ((refutes && !race.decided) || better) {
+                if (!race.decided) {
+                    race.first_result = std::chrono::steady_clock::now();
+                }
+                race.decided = true;
+                race.refuted = refutes;
+                race.result.proof = std::move(proof);
+                race.result.winner = strategy;
+            }
+            race.changed.notify_all();
+        });
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(race.mutex);
+        auto settled = [&] { return race.decided || race.finished == runners.size(); };
+        // Poll so that cancelling this searcher also stops the race
+        while (!race.changed.wait_for(lock, std::chrono::milliseconds(10), settled)) {
+            if (cancellation.isCancelled()) {
+                break;
+            }
+        }
+        if (race.decided && !race.refuted) {
+            race.changed.wait_until(lock, race.first_result + grace_window,
+                                    [&] { return race.finished == runners.size() || cancellation.isCancelled(); });
+        }
+    }
+    race_token.cancel();
+    for (auto& runner : runners) {
+        runner.join();
+    }
+    
+    race.result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+    return std::move(race.result);
+}
+
+std::vector<std::unique_ptr<ASTNode>> ProofSearch::generateEquivalentForms(const ASTNode& expression, int max_steps,
+                                                                          std::size_t max_forms) {
+    std::vector<std::unique_ptr<ASTNode>> equivalent_forms;
+    EnumerationLimits limits;
+    limits.max_forms = max_forms;
+    limits.max_depth = max_steps;
+    enumerateEquivalentForms(expression, limits, [&](const ASTNode& form, int) {
+        equivalent_forms.push_back(form.clone());
+        return true;
+    });
     return equivalent_forms;
 }
 
+std::size_t ProofSearch::enumerateEquivalentForms(const ASTNode& expression, const EnumerationLimits& limits,
+                                                  const FormSink& sink) {
+    if (cancellation.isCancelled()) {
+        return 0;
+    }
+    configureLaws(expression, expression);
+    
+    std::size_t thread_count = limits.threads;
+    if (thread_count == 0) {
+        thread_count = activeExecutor().size();
+    }
+    
+    StateArena arena;
+    std::unordered_set<std::string_view> seen;
+    std::vector<std::string_view> frontier{arena.store(expression)};
+    seen.insert(frontier.front());
+    
+    std::size_t reported = 1;
+    if (!sink(expression, 0) || reported == limits.max_forms) {
+        return reported;
+    }
+    
+    for (int depth = 0; depth < limits.max_depth && !frontier.empty(); ++depth) {
+        bool last_level = depth + 1 == limits.max_depth;
+        std::vector<std::string_view> next_frontier;
+        
+        for (std::size_t begin = 0; begin < frontier.size(); begin += ENUMERATION_BATCH) {
+            if (cancellation.isCancelled()) {
+                return reported;
+            }
+            std::size_t end = std::min(begin + ENUMERATION_BATCH, frontier.size());
+            
+            // Workers only read the arena; new states are added by the merge below
+            std::vector<std::vector<Transformation>> successors(end - begin);
+            std::size_t slices = std::min(thread_count, end - begin);
+            auto expandSlice = [&](std::size_t slice) {
+                EquivalenceEngine engine = equivalence_engine;
+                for (std::size_t i = begin + slice; i < end && !cancellation.isCancelled(); i += slices) {
+                    successors[i - begin] = expandWith(engine, *arena.decode(frontier[i]));
+                }
+            };
+            if (slices == 1) {
+                expandSlice(0);
+            } else {
+                activeExecutor().parallelFor(slices, slices, expandSlice);
+            }
+            
+            for (auto& batch : successors) {
+                for (auto& successor : batch) {
+                    const ASTNode& form = *successor.result;
+                    if (limits.max_size != 0 && form.getSize() > limits.max_size) {
+                        continue;
+                    }
+                    if (seen.count(arena.encode(form))) {
+                        continue;
+                    }
+                    std::string_view state = arena.commit();
+                    seen.insert(state);
+                    if (!last_level) {
+                        next_frontier.push_back(state);
+                    }
+                    ++reported;
+                    if (!sink(form, depth + 1) || reported == limits.max_forms) {
+                        return reported;
+                    }
+                }
+            }
+        }
+        frontier = std::move(next_frontier);
+    }
+    
+    return reported;
+}
+
+std::future<Proof> ProofSearch::findProofAsync(const ASTNode& start_expression, const ASTNode& target_expression,
+                                               CancellationToken token) {
+    auto promise = std::make_shared<std::promise<Proof>>();
+    std::future<Proof> result = promise->get_future();
+    std::shared_ptr<ASTNode> start = start_expression.clone();
+    std::shared_ptr<ASTNode> target = target_expression.clone();
+    auto searcher = std::make_shared<ProofSearch>(detachedCopy(token));
+    activeExecutor().submit([searcher, start, target, promise, token] {
+        try {
+            promise->set_value(token.isCancelled() ? Proof() : searcher->findProof(*start, *target));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return result;
+}
+
+void ProofSearch::findProofAsync(const ASTNode& start_expression, const ASTNode& target_expression,
+                                 std::function<void(Proof)> on_complete, CancellationToken token) {
+    // std::function needs a copyable callable, hence shared_ptr over unique_ptr
+    std::shared_ptr<ASTNode> start = start_expression.clone();
+    std::shared_ptr<ASTNode> target = target_expression.clone();
+    auto searcher = std::make_shared<ProofSearch>(detachedCopy(token));
+    activeExecutor().submit([searcher, start, target, on_complete = std::move(on_complete), token] {
+        on_complete(token.isCancelled() ? Proof() : searcher->findProof(*start, *target));
+    });
+}
+
+std::future<std::vector<std::unique_ptr<ASTNode>>> ProofSearch::generateEquivalentFormsAsync(
+    const ASTNode& expression, int max_steps, CancellationToken token) {
+    using Forms = std::vector<std::unique_ptr<ASTNode>>;
+    auto promise = std::make_shared<std::promise<Forms>>();
+    std::future<Forms> result = promise->get_future();
+    std::shared_ptr<ASTNode> start = expression.clone();
+    auto searcher = std::make_shared<ProofSearch>(detachedCopy(token));
+    activeExecutor().submit([searcher, start, max_steps, promise, token] {
+        try {
+            promise->set_value(token.isCancelled() ? Forms() : searcher->generateEquivalentForms(*start, max_steps));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return result;
+}
+
 void ProofSearch::setMaxDepth(int depth) {
     max_depth = depth;
 }
@@ -95,174 +629,206 @@ void ProofSearch::setMaxTransformations(int transformations) {
     max_transformations = transformations;
 }
 
-bool ProofSearch::isVisited(const ASTNode& expression) {
-    std::string expr_str = expressionToString(expression);
-    return visited_expressions.find(expr_str) != visited_expressions.end();
+void ProofSearch::setSemanticPrecheck(bool enabled) {
+    semantic_precheck = enabled;
+}
+
+void ProofSearch::setCancellationToken(CancellationToken token) {
+    cancellation = std::move(token);
+}
+
+void ProofSearch::setGraceWindow(std::chrono::milliseconds window) {
+    grace_window = window;
+}
+
+void ProofSearch::setLawConfiguration(const LawConfiguration& configuration) {
+    law_configuration = configuration;
 }
 
-void ProofSearch::markVisited(const ASTNode& expression) {
-    std::string expr_str = expressionToString(expression);
-    visited_expressions.insert(expr_str);
+const LawConfiguration& ProofSearch::getLawConfiguration() const {
+    return law_configuration;
 }
 
-void ProofSearch::clearVisited() {
-    visited_expressions.clear();
+void ProofSearch::setAutomaticLawSelection(bool enabled) {
+    automatic_laws = enabled;
+}
+
+const LawConfiguration& ProofSearch::getEffectiveLawConfiguration() const {
+    return equivalence_engine.getLawConfiguration();
+}
+
+void ProofSearch::configureLaws(const ASTNode& start_expression, const ASTNode& target_expression) {
+    configureLaws(start_expression, std::vector<const ASTNode*>{&target_expression});
+}
+
+void ProofSearch::configureLaws(const ASTNode& start_expression,
+                                const std::vector<const ASTNode*>& target_expressions) {
+    LawConfiguration effective = law_configuration;
+    // Dropping laws that cannot fire never changes a result, and it would
+    // move a default engine off its compiled StandardLaws path
+    if (automatic_laws && !law_configuration.isDefault()) {
+        std::uint32_t relevant_mask = 0;
+        for (const ASTNode* target_expression : target_expressions) {
+            relevant_mask |= LawConfiguration::forProblem(start_expression, *target_expression).getMask();
+        }
+        for (std::size_t i = 0; i < LAW_COUNT; ++i) {
+            LogicLaw law = static_cast<LogicLaw>(i);
+            if (!(relevant_mask & (1u << i))) {
+                effective.disable(law);
+            }
+        }
+    }
+    equivalence_engine.setLawConfiguration(effective);
+}
+
+void ProofSearch::setRetainedGraphLimit(std::size_t bytes) {
+    retention = bytes == 0 ? nullptr : std::make_shared<SearchRetention>(bytes);
+}
+
+std::shared_ptr<SearchRetention> ProofSearch::getSearchRetention() const {
+    return retention;
+}
+
+void ProofSearch::setResultCache(std::shared_ptr<ProofCache> cache) {
+    result_cache = std::move(cache);
+}
+
+void ProofSearch::setLawProfile(std::shared_ptr<LawProfile> profile) {
+    law_profile = std::move(profile);
+}
+
+std::shared_ptr<LawProfile> ProofSearch::getLawProfile() const {
+    return law_profile;
+}
+
+std::shared_ptr<ProofCache> ProofSearch::getResultCache() const {
+    return result_cache;
+}
+
+void ProofSearch::setExecutor(std::shared_ptr<ThreadPool> pool) {
+    executor = std::move(pool);
+}
+
+std::shared_ptr<ThreadPool> ProofSearch::defaultExecutor() {
+    static std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>();
+    return pool;
+}
+
+std::string ProofSearch::getStrategyName(SearchStrategy strategy) {
+    switch (strategy) {
+        case SearchStrategy::BREADTH_FIRST: return "Breadth-First Search";
+        case SearchStrategy::BEST_FIRST: return "Best-First Search";
+        case SearchStrategy::NORMAL_FORM: return "Normal Form Rewriting";
+        case SearchStrategy::EQUALITY_SATURATION: return "Equality Saturation";
+        default: return "Unknown Strategy";
+    }
+}
+
+Proof ProofSearch::findNormalFormProof(const ASTNode& start_expression, const ASTNode& target_expression) {
+    for (NormalForm form : {NormalForm::CONJUNCTIVE, NormalForm::DISJUNCTIVE}) {
+        NormalFormRewriter rewriter(form);
+        rewriter.setCancellationToken(cancellation);
+        Proof normal_form_proof = rewriter.proveEquivalence(start_expression, target_expression);
+        if (normal_form_proof.found_target) {
+            ProofOptimizer optimizer;
+            return optimizer.optimize(start_expression, normal_form_proof);
+        }
+    }
+    return Proof();
+}
+
+Proof ProofSearch::runStrategy(SearchStrategy strategy, const ASTNode& start_expression,
+                               const ASTNode& target_expression) {
+    switch (strategy) {
+        case SearchStrategy::BREADTH_FIRST:
+            return findShortestProof(start_expression, target_expression);
+        case SearchStrategy::BEST_FIRST:
+            return findBestFirstProof(start_expression, target_expression);
+        case SearchStrategy::NORMAL_FORM:
+            return findNormalFormProof(start_expression, target_expression);
+        case SearchStrategy::EQUALITY_SATURATION: {
+            SaturationProver prover;
+            prover.setCancellationToken(cancellation);
+            return prover.findProof(start_expression, target_expression);
+        }
+    }
+    return Proof();
+}
+
+ProofSearch ProofSearch::detachedCopy(CancellationToken token) const {
+    ProofSearch copy(max_depth, max_transformations);
+    copy.semantic_precheck = semantic_precheck;
+    copy.grace_window = grace_window;
+    copy.result_cache = result_cache;
+    copy.law_configuration = law_configuration;
+    copy.automatic_laws = automatic_laws;
+    copy.law_profile = law_profile;
+    copy.cancellation = std::move(token);
+    return copy;
+}
+
+ThreadPool& ProofSearch::activeExecutor() {
+    if (!executor) {
+        executor = defaultExecutor();
+    }
+    return *executor;
 }
 
 std::string ProofSearch::expressionToString(const ASTNode& expression) {
-    return expression.toString();
+    return key_writer.clear().write(expression).str();
 }
 
-bool ProofSearch::shouldPrune(const ProofSearchNode& node) {
-    if (node.depth >= max_depth) {
+bool ProofSearch::shouldPrune(const ASTNode& expression, int depth) {
+    if (depth >= max_depth) {
         return true;
     }
     
-    std::string expr_str = expressionToString(*node.expression);
-    if (expr_str.length() > 200) {
+    if (expression.getSize() > MAX_EXPRESSION_SIZE) {
         return true;
     }
     
     return false;
 }
 
-std::vector<ProofSearchNode> ProofSearch::expandNode(const ProofSearchNode& node) {
-    std::vector<ProofSearchNode> expanded_nodes;
-    
-    // Try transformations on the entire expression
-    auto transformations = equivalence_engine.generateAllTransformations(*node.expression);
-    
-    for (auto& transformation : transformations) {
-        std::vector<ProofStep> new_path;
-        for (auto& step : node.path) {
-            new_path.emplace_back(step.expression->clone(), step.law_applied, step.description, step.step_number);
-        }
-        new_path.emplace_back(
-            transformation.result->clone(),
-            transformation.law,
-            transformation.description,
-            node.depth + 1
-        );
-        
-        expanded_nodes.emplace_back(
-            std::move(transformation.result),
-            node.depth + 1,
-            std::move(new_path)
-        );
-    }
-    
-    // Try transformations on subexpressions
-    if (node.expression->getType() == NodeType::IMPLIES || 
-        node.expression->getType() == NodeType::BICONDITIONAL ||
-        node.expression->getType() == NodeType::AND ||
-        node.expression->getType() == NodeType::OR) {
-        const auto& binary = static_cast<const BinaryOpNode&>(*node.expression);
-        
-        // Try transforming left subexpression
-        auto left_transformations = equivalence_engine.generateAllTransformations(binary.getLeft());
-        for (auto& transformation : left_transformations) {
-            std::vector<ProofStep> new_path;
-            for (auto& step : node.path) {
-                new_path.emplace_back(step.expression->clone(), step.law_applied, step.description, step.step_number);
-            }
-            
-            auto new_expr = std::make_unique<BinaryOpNode>(
-                node.expression->getType(),
-                std::move(transformation.result),
-                binary.getRight().clone()
-            );
-            
-            new_path.emplace_back(
-                new_expr->clone(),
-                transformation.law,
-                transformation.description,
-                node.depth + 1
-            );
-            
-            expanded_nodes.emplace_back(
-                std::move(new_expr),
-                node.depth + 1,
-                std::move(new_path)
-            );
-        }
-        
-        // Try transforming right subexpression
-        auto right_transformations = equivalence_engine.generateAllTransformations(binary.getRight());
-        for (auto& transformation : right_transformations) {
-            std::vector<ProofStep> new_path;
-            for (auto& step : node.path) {
-                new_path.emplace_back(step.expression->clone(), step.law_applied, step.description, step.step_number);
-            }
-            
-            auto new_expr = std::make_unique<BinaryOpNode>(
-                node.expression->getType(),
-                binary.getLeft().clone(),
-                std::move(transformation.result)
-            );
-            
-            new_path.emplace_back(
-                new_expr->clone(),
-                transformation.law,
-                transformation.description,
-                node.depth + 1
-            );
-            
-            expanded_nodes.emplace_back(
-                std::move(new_expr),
-                node.depth + 1,
-                std::move(new_path)
-            );
-        }
-    } else if (node.expression->getType() == NodeType::NOT) {
-        const auto& unary = static_cast<const UnaryOpNode&>(*node.expression);
-        
-        // Try transforming the operand
-        auto operand_transformations = equivalence_engine.generateAllTransformations(unary.getOperand());
-        for (auto& transformation : operand_transformations) {
-            std::vector<ProofStep> new_path;
-            for (auto& step : node.path) {
-                new_path.emplace_back(step.expression->clone(), step.law_applied, step.description, step.step_number);
-            }
-            
-            auto new_expr = std::make_unique<UnaryOpNode>(
-                NodeType::NOT,
-                std::move(transformation.result)
-            );
-            
-            new_path.emplace_back(
-                new_expr->clone(),
-                transformation.law,
-                transformation.description,
-                node.depth + 1
-            );
-            
-            expanded_nodes.emplace_back(
-                std::move(new_expr),
-                node.depth + 1,
-                std::move(new_path)
-            );
-        }
+std::vector<Transformation> ProofSearch::expandExpression(const ASTNode& expression, int depth) {
+    auto successors = expandWith(equivalence_engine, expression);
+    // Best-first buckets are FIFO, so this order also breaks its priority ties
+    if (law_profile) {
+        law_profile->order(expression.getType(), depth, successors);
     }
-    
-    return expanded_nodes;
+    return successors;
 }
 
-Proof ProofSearch::reconstructProof(const std::vector<ProofStep>& path, bool found_target) {
-    Proof proof;
-    proof.found_target = found_target;
-    proof.total_steps = path.size();
-    
-    for (auto& step : path) {
-        proof.steps.emplace_back(step.expression->clone(), step.law_applied, step.description, step.step_number);
+Proof ProofSearch::reconstructProof(const SearchGraph& graph, std::size_t index) {
+    std::vector<std::size_t> chain;
+    for (std::size_t at = index; at != 0; at = graph.getRecord(at).parent) {
+        chain.push_back(at);
     }
     
-    for (size_t i = 0; i < proof.steps.size(); ++i) {
-        proof.steps[i].step_number = i + 1;
+    Proof proof;
+    proof.found_target = true;
+    proof.total_steps = chain.size();
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        proof.steps.emplace_back(graph.expression(*it), graph.getRecord(*it).law, graph.getDescription(*it),
+                                 static_cast<int>(proof.steps.size()) + 1);
     }
     
     return proof;
 }
 
+bool ProofSearch::refuteEquivalence(const ASTNode& start_expression, const ASTNode& target_expression, Proof& refutation) {
+    if (!semantic_precheck) {
+        return false;
+    }
+    
+    // No sequence of laws can connect inequivalent expressions, so a
+    // counterexample settles the query without spending the search budget
+    auto verdict = SatEquivalenceChecker::check(start_expression, target_expression,
+                                                refutation.counterexample, PRECHECK_CONFLICT_LIMIT);
+    refutation.refuted = verdict == EquivalenceVerdict::NOT_EQUIVALENT;
+    return refutation.refuted;
+}
+
 int ProofSearch::estimateDistance(const ASTNode& current, const ASTNode& target) {
     std::string current_str = expressionToString(current);
     std::string target_str = expressionToString(target);
@@ -285,26 +851,52 @@ int ProofSearch::estimateDistance(const ASTNode& current, const ASTNode& target)
     return (differences + 4) / 5;
 }
 
-std::string logixpr::ProofFormatter::formatProof(const Proof& proof) {
-    std::ostringstream oss;
+namespace {
+
+void writeProofStep(ExpressionWriter& writer, const ProofStep& step) {
+    writer.append("Step ").append(static_cast<long long>(step.step_number)).append(": ");
+    writer.write(*step.expression).append('\n');
+    if (!step.description.empty()) {
+        writer.append("  Using: ").append(LogicLaws::getLawName(step.law_applied)).append('\n');
+        writer.append("  ").append(step.description).append('\n');
+    }
+    writer.append('\n');
+}
+
+}
+
+std::string logixpr::ProofFormatter::formatProof(const Proof& proof, OutputStyle style) {
+    ExpressionWriter writer(style);
     
     if (!proof.found_target) {
-        oss << "No proof found within the search limits.\n";
-        return oss.str();
+        if (proof.refuted) {
+            writer.append("Expressions are not equivalent.");
+            if (!proof.counterexample.empty()) {
+                writer.append(" Counterexample:");
+            }
+            for (const auto& [name, value] : proof.counterexample) {
+                writer.append(' ').append(name).append(" = ").append(value ? 'T' : 'F');
+            }
+            writer.append('\n');
+            return writer.release();
+        }
+        writer.append("No proof found within the search limits.\n");
+        return writer.release();
     }
 
-    oss << "Proof found in " << proof.total_steps << " steps:\n\n";
+    writer.append("Proof found in ").append(static_cast<long long>(proof.total_steps)).append(" steps:\n\n");
     
     for (const auto& step : proof.steps) {
-        oss << "Step " << step.step_number << ": " << step.expression->toString() << "\n";
-        if (!step.description.empty()) {
-            oss << "  Using: " << LogicLaws::getLawName(step.law_applied) << "\n";
-            oss << "  " << step.description << "\n";
-        }
-        oss << "\n";
+        writeProofStep(writer, step);
     }
     
-    return oss.str();
+    return writer.release();
+}
+
+std::string logixpr::ProofFormatter::formatProofStep(const ProofStep& step, OutputStyle style) {
+    ExpressionWriter writer(style);
+    writeProofStep(writer, step);
+    return writer.release();
 }
 
 void logixpr::ProofFormatter::printProof(const Proof& proof) {
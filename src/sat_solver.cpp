@@ -0,0 +1,622 @@
+#include "sat_solver.h"
+#include <algorithm>
+#include <cmath>
+
+namespace logixpr {
+
+namespace {
+
+constexpr std::int8_t VALUE_FALSE = 0;
+constexpr std::int8_t VALUE_TRUE = 1;
+constexpr std::int8_t VALUE_UNDEF = 2;
+
+constexpr double VARIABLE_DECAY = 0.95;
+constexpr double CLAUSE_DECAY = 0.999;
+constexpr double RESTART_BASE = 100;
+
+int variableOf(int literal) {
+    return literal >> 1;
+}
+
+bool isNegated(int literal) {
+    return (literal & 1) != 0;
+}
+
+}
+
+SatSolver::SatSolver()
+    : propagation_head(0), learnt_count(0), max_learnts(0), variable_increment(1.0),
+      clause_increment(1.0), conflicts(0), inconsistent(false) {}
+
+int SatSolver::makeLiteral(int variable, bool negated) {
+    return 2 * variable + (negated ? 1 : 0);
+}
+
+int SatSolver::negate(int literal) {
+    return literal ^ 1;
+}
+
+int SatSolver::newVariable() {
+    int variable = static_cast<int>(assigns.size());
+    assigns.push_back(VALUE_UNDEF);
+    levels.push_back(0);
+    reasons.push_back(-1);
+    saved_phase.push_back(true);
+    activity.push_back(0.0);
+    heap_index.push_back(-1);
+    seen.push_back(0);
+    watches.emplace_back();
+    watches.emplace_back();
+    heapInsert(variable);
+    return variable;
+}
+
+int SatSolver::variableCount() const {
+    return static_cast<int>(assigns.size());
+}
+
+bool SatSolver::addClause(std::vector<int> literals) {
+    if (inconsistent) {
+        return false;
+    }
+
+    std::sort(literals.begin(), literals.end());
+    std::vector<int> kept;
+    for (std::size_t i = 0; i < literals.size(); ++i) {
+        int literal = literals[i];
+        if (i > 0 && literal == literals[i - 1]) {
+            continue;
+        }
+        if (i > 0 && literal == negate(literals[i - 1])) {
+            return true;
+        }
+        std::int8_t value = valueOf(literal);
+        if (value == VALUE_TRUE) {
+            return true;
+        }
+        if (value == VALUE_UNDEF) {
+            kept.push_back(literal);
+        }
+    }
+
+    if (kept.empty()) {
+        inconsistent = true;
+        return false;
+    }
+
+    if (kept.size() == 1) {
+        enqueue(kept[0], -1);
+        if (propagate() != -1) {
+            inconsistent = true;
+        }
+        return !inconsistent;
+    }
+
+    attachClause(std::move(kept), false);
+    return true;
+}
+
+SatResult SatSolver::solve(std::int64_t conflict_limit) {
+    model.clear();
+    if (inconsistent) {
+        return SatResult::UNSATISFIABLE;
+    }
+    if (propagate() != -1) {
+        inconsistent = true;
+        return SatResult::UNSATISFIABLE;
+    }
+
+    max_learnts = std::max(1000.0, clauses.size() / 3.0);
+    std::int64_t remaining = conflict_limit;
+
+    for (int restart = 0;; ++restart) {
+        auto budget = static_cast<std::uint64_t>(luby(2, restart) * RESTART_BASE);
+        SatResult result = search(budget, remaining);
+        if (result != SatResult::UNKNOWN) {
+            return result;
+        }
+        if (conflict_limit >= 0 && remaining <= 0) {
+            return SatResult::UNKNOWN;
+        }
+    }
+}
+
+bool SatSolver::getModelValue(int variable) const {
+    return variable < static_cast<int>(model.size()) && model[variable];
+}
+
+std::uint64_t SatSolver::getConflicts() const {
+    return conflicts;
+}
+
+std::int8_t SatSolver::valueOf(int literal) const {
+    std::int8_t value = assigns[variableOf(literal)];
+    if (value == VALUE_UNDEF) {
+        return VALUE_UNDEF;
+    }
+    return static_cast<std::int8_t>(value ^ (literal & 1));
+}
+
+int SatSolver::decisionLevel() const {
+    return static_cast<int>(trail_limits.size());
+}
+
+void SatSolver::enqueue(int literal, int reason) {
+    int variable = variableOf(literal);
+    assigns[variable] = isNegated(literal) ? VALUE_FALSE : VALUE_TRUE;
+    levels[variable] = decisionLevel();
+    reasons[variable] = reason;
+    trail.push_back(literal);
+}
+
+int SatSolver::propagate() {
+    while (propagation_head < trail.size()) {
+        int true_literal = trail[propagation_head++];
+        int false_literal = negate(true_literal);
+        auto& watch_list = watches[true_literal];
+
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < watch_list.size()) {
+            int clause_index = watch_list[i++];
+            Clause& clause = clauses[clause_index];
+            if (clause.deleted) {
+                continue;
+            }
+
+            auto& lits = clause.literals;
+            if (lits[0] == false_literal) {
+                std::swap(lits[0], lits[1]);
+            }
+
+            if (valueOf(lits[0]) == VALUE_TRUE) {
+                watch_list[j++] = clause_index;
+                continue;
+            }
+
+            // Look for a replacement watch among the unwatched literals
+            bool moved = false;
+            for (std::size_t k = 2; k < lits.size(); ++k) {
+                if (valueOf(lits[k]) != VALUE_FALSE) {
+                    std::swap(lits[1], lits[k]);
+                    watches[negate(lits[1])].push_back(clause_index);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+
+            watch_list[j++] = clause_index;
+            if (valueOf(lits[0]) == VALUE_FALSE) {
+                while (i < watch_list.size()) {
+                    watch_list[j++] = watch_list[i++];
+                }
+                watch_list.resize(j);
+                propagation_head = trail.size();
+                return clause_index;
+            }
+            enqueue(lits[0], clause_index);
+        }
+        watch_list.resize(j);
+    }
+    return -1;
+}
+
+void SatSolver::analyze(int conflict, std::vector<int>& learnt, int& backtrack_level) {
+    learnt.clear();
+    learnt.push_back(-1);
+
+    int pending = 0;
+    int literal = -1;
+    std::size_t index = trail.size();
+
+    do {
+        Clause& clause = clauses[conflict];
+        if (clause.learnt) {
+            bumpClause(clause);
+        }
+
+        // A reason clause keeps its implied literal at position 0
+        for (std::size_t k = (literal == -1 ? 0 : 1); k < clause.literals.size(); ++k) {
+            int q = clause.literals[k];
+            int variable = variableOf(q);
+            if (!seen[variable] && levels[variable] > 0) {
+                bumpVariable(variable);
+                seen[variable] = 1;
+                if (levels[variable] >= decisionLevel()) {
+                    ++pending;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+        }
+
+        while (!seen[variableOf(trail[--index])]) {}
+        literal = trail[index];
+        conflict = reasons[variableOf(literal)];
+        seen[variableOf(literal)] = 0;
+        --pending;
+    } while (pending > 0);
+
+    learnt[0] = negate(literal);
+
+    std::vector<int> analyzed(learnt.begin() + 1, learnt.end());
+    std::size_t kept = 1;
+    for (std::size_t i = 1; i < learnt.size(); ++i) {
+        if (!isRedundant(learnt[i])) {
+            learnt[kept++] = learnt[i];
+        }
+    }
+    learnt.resize(kept);
+    for (int q : analyzed) {
+        seen[variableOf(q)] = 0;
+    }
+
+    backtrack_level = 0;
+    if (learnt.size() > 1) {
+        std::size_t max_index = 1;
+        for (std::size_t i = 2; i < learnt.size(); ++i) {
+            if (levels[variableOf(learnt[i])] > levels[variableOf(learnt[max_index])]) {
+                max_index = i;
+            }
+        }
+        std::swap(learnt[1], learnt[max_index]);
+        backtrack_level = levels[variableOf(learnt[1])];
+    }
+}
+
+bool SatSolver::isRedundant(int literal) const {
+    int reason = reasons[variableOf(literal)];
+    if (reason == -1) {
+        return false;
+    }
+    const auto& lits = clauses[reason].literals;
+    for (std::size_t k = 1; k < lits.size(); ++k) {
+        int variable = variableOf(lits[k]);
+        if (!seen[variable] && levels[variable] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SatSolver::cancelUntil(int level) {
+    if (decisionLevel() <= level) {
+        return;
+    }
+    for (std::size_t i = trail.size(); i > trail_limits[level]; --i) {
+        int literal = trail[i - 1];
+        int variable = variableOf(literal);
+        assigns[variable] = VALUE_UNDEF;
+        reasons[variable] = -1;
+        saved_phase[variable] = isNegated(literal);
+        if (heap_index[variable] == -1) {
+            heapInsert(variable);
+        }
+    }
+    trail.resize(trail_limits[level]);
+    trail_limits.resize(level);
+    propagation_head = trail.size();
+}
+
+int SatSolver::pickBranchLiteral() {
+    while (!heap.empty()) {
+        int variable = heapPop();
+        if (assigns[variable] == VALUE_UNDEF) {
+            return makeLiteral(variable, saved_phase[variable]);
+        }
+    }
+    return -1;
+}
+
+SatResult SatSolver::search(std::uint64_t conflict_budget, std::int64_t& remaining) {
+    std::uint64_t local_conflicts = 0;
+    std::vector<int> learnt;
+
+    while (true) {
+        int conflict = propagate();
+        if (conflict != -1) {
+            ++conflicts;
+            ++local_conflicts;
+            if (remaining > 0) {
+                --remaining;
+            }
+            if (decisionLevel() == 0) {
+                inconsistent = true;
+                return SatResult::UNSATISFIABLE;
+            }
+
+            int backtrack_level = 0;
+            analyze(conflict, learnt, backtrack_level);
+            cancelUntil(backtrack_level);
+            if (learnt.size() == 1) {
+                enqueue(learnt[0], -1);
+            } else {
+                int clause_index = attachClause(learnt, true);
+                enqueue(learnt[0], clause_index);
+            }
+
+            variable_increment /= VARIABLE_DECAY;
+            clause_increment /= CLAUSE_DECAY;
+            continue;
+        }
+
+        if (local_conflicts >= conflict_budget || remaining == 0) {
+            cancelUntil(0);
+            return SatResult::UNKNOWN;
+        }
+
+        if (static_cast<double>(learnt_count) >= max_learnts + trail.size()) {
+            reduceLearnts();
+        }
+
+        int decision = pickBranchLiteral();
+        if (decision == -1) {
+            model.assign(assigns.size(), false);
+            for (std::size_t v = 0; v < assigns.size(); ++v) {
+                model[v] = assigns[v] == VALUE_TRUE;
+            }
+            cancelUntil(0);
+            return SatResult::SATISFIABLE;
+        }
+
+        trail_limits.push_back(trail.size());
+        enqueue(decision, -1);
+    }
+}
+
+int SatSolver::attachClause(std::vector<int> literals, bool learnt) {
+    int clause_index = static_cast<int>(clauses.size());
+    watches[negate(literals[0])].push_back(clause_index);
+    watches[negate(literals[1])].push_back(clause_index);
+    clauses.push_back({std::move(literals), learnt, false, 0.0});
+    if (learnt) {
+        ++learnt_count;
+        bumpClause(clauses.back());
+    }
+    return clause_index;
+}
+
+void SatSolver::reduceLearnts() {
+    std::vector<int> candidates;
+    for (std::size_t i = 0; i < clauses.size(); ++i) {
+        const Clause& clause = clauses[i];
+        if (!clause.learnt || clause.deleted || clause.literals.size() <= 2) {
+            continue;
+        }
+        // Clauses that are currently the reason for an assignment stay
+        int implied = variableOf(clause.literals[0]);
+        if (reasons[implied] == static_cast<int>(i) && valueOf(clause.literals[0]) == VALUE_TRUE) {
+            continue;
+        }
+        candidates.push_back(static_cast<int>(i));
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+        return clauses[a].activity < clauses[b].activity;
+    });
+
+    // Deleted clauses are dropped lazily from the watch lists during propagation
+    for (std::size_t i = 0; i < candidates.size() / 2; ++i) {
+        Clause& clause = clauses[candidates[i]];
+        clause.deleted = true;
+        clause.literals.clear();
+        clause.literals.shrink_to_fit();
+        --learnt_count;
+    }
+
+    max_learnts *= 1.1;
+}
+
+void SatSolver::bumpVariable(int variable) {
+    activity[variable] += variable_increment;
+    if (activity[variable] > 1e100) {
+        for (auto& value : activity) {
+            value *= 1e-100;
+        }
+        variable_increment *= 1e-100;
+    }
+    if (heap_index[variable] != -1) {
+        heapSiftUp(static_cast<std::size_t>(heap_index[variable]));
+    }
+}
+
+void SatSolver::bumpClause(Clause& clause) {
+    clause.activity += clause_increment;
+    if (clause.activity > 1e20) {
+        for (auto& other : clauses) {
+            if (other.learnt) {
+                other.activity *= 1e-20;
+            }
+        }
+        clause_increment *= 1e-20;
+    }
+}
+
+void SatSolver::heapInsert(int variable) {
+    heap_index[variable] = static_cast<int>(heap.size());
+    heap.push_back(variable);
+    heapSiftUp(heap.size() - 1);
+}
+
+int SatSolver::heapPop() {
+    int top = heap.front();
+    heap_index[top] = -1;
+    heap.front() = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap_index[heap.front()] = 0;
+        heapSiftDown(0);
+    }
+    return top;
+}
+
+void SatSolver::heapSiftUp(std::size_t position) {
+    int variable = heap[position];
+    while (position > 0) {
+        std::size_t parent = (position - 1) / 2;
+        if (activity[heap[parent]] >= activity[variable]) {
+            break;
+        }
+        heap[position] = heap[parent];
+        heap_index[heap[position]] = static_cast<int>(position);
+        position = parent;
+    }
+    heap[position] = variable;
+    heap_index[variable] = static_cast<int>(position);
+}
+
+void SatSolver::heapSiftDown(std::size_t position) {
+    int variable = heap[position];
+    while (true) {
+        std::size_t child = 2 * position + 1;
+        if (child >= heap.size()) {
+            break;
+        }
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) {
+            ++child;
+        }
+        if (activity[heap[child]] <= activity[variable]) {
+            break;
+        }
+        heap[position] = heap[child];
+        heap_index[heap[position]] = static_cast<int>(position);
+        position = child;
+    }
+    heap[position] = variable;
+    heap_index[variable] = static_cast<int>(position);
+}
+
+double SatSolver::luby(double base, int index) {
+    int size = 1;
+    int sequence = 0;
+    while (size < index + 1) {
+        ++sequence;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) >> 1;
+        --sequence;
+        index = index % size;
+    }
+    return std::pow(base, sequence);
+}
+
+TseitinEncoder::TseitinEncoder(SatSolver& solver) : solver(solver), true_literal(-1) {}
+
+int TseitinEncoder::encode(const ASTNode& expression) {
+    FlatExpression flat = FlatExpression::fromAST(expression, variables);
+    while (solver_variables.size() < variables.size()) {
+        solver_variables.push_back(solver.newVariable());
+    }
+
+    std::vector<int> stack;
+    for (const auto& node : flat.getNodes()) {
+        switch (node.type) {
+            case NodeType::VARIABLE:
+                stack.push_back(SatSolver::makeLiteral(solver_variables[node.value], false));
+                break;
+            case NodeType::CONSTANT:
+                stack.push_back(constantLiteral(node.value != 0));
+                break;
+            case NodeType::NOT:
+                stack.back() = SatSolver::negate(stack.back());
+                break;
+            default: {
+                int right = stack.back();
+                stack.pop_back();
+                int left = stack.back();
+                switch (node.type) {
+                    case NodeType::AND:
+                        stack.back() = defineAnd(left, right);
+                        break;
+                    case NodeType::OR:
+                        stack.back() = defineOr(left, right);
+                        break;
+                    case NodeType::IMPLIES:
+                        stack.back() = defineOr(SatSolver::negate(left), right);
+                        break;
+                    default:
+                        stack.back() = defineBiconditional(left, right);
+                        break;
+                }
+                break;
+            }
+        }
+    }
+
+    return stack.back();
+}
+
+const VariableTable& TseitinEncoder::getVariables() const {
+    return variables;
+}
+
+int TseitinEncoder::solverVariable(std::uint32_t id) const {
+    return solver_variables[id];
+}
+
+int TseitinEncoder::constantLiteral(bool value) {
+    if (true_literal == -1) {
+        true_literal = SatSolver::makeLiteral(solver.newVariable(), false);
+        solver.addClause({true_literal});
+    }
+    return value ? true_literal : SatSolver::negate(true_literal);
+}
+
+int TseitinEncoder::defineAnd(int a, int b) {
+    int x = SatSolver::makeLiteral(solver.newVariable(), false);
+    solver.addClause({SatSolver::negate(x), a});
+    solver.addClause({SatSolver::negate(x), b});
+    solver.addClause({x, SatSolver::negate(a), SatSolver::negate(b)});
+    return x;
+}
+
+int TseitinEncoder::defineOr(int a, int b) {
+    int x = SatSolver::makeLiteral(solver.newVariable(), false);
+    solver.addClause({x, SatSolver::negate(a)});
+    solver.addClause({x, SatSolver::negate(b)});
+    solver.addClause({SatSolver::negate(x), a, b});
+    return x;
+}
+
+int TseitinEncoder::defineBiconditional(int a, int b) {
+    int x = SatSolver::makeLiteral(solver.newVariable(), false);
+    solver.addClause({SatSolver::negate(x), SatSolver::negate(a), b});
+    solver.addClause({SatSolver::negate(x), a, SatSolver::negate(b)});
+    solver.addClause({x, a, b});
+    solver.addClause({x, SatSolver::negate(a), SatSolver::negate(b)});
+    return x;
+}
+
+EquivalenceVerdict SatEquivalenceChecker::check(const ASTNode& expr1, const ASTNode& expr2,
+                                                std::vector<std::pair<std::string, bool>>& counterexample,
+                                                std::int64_t conflict_limit) {
+    SatSolver solver;
+    TseitinEncoder encoder(solver);
+
+    // Miter: the two sides must disagree
+    int left = encoder.encode(expr1);
+    int right = encoder.encode(expr2);
+    solver.addClause({left, right});
+    solver.addClause({SatSolver::negate(left), SatSolver::negate(right)});
+
+    switch (solver.solve(conflict_limit)) {
+        case SatResult::UNSATISFIABLE:
+            return EquivalenceVerdict::EQUIVALENT;
+        case SatResult::SATISFIABLE: {
+            counterexample.clear();
+            const auto& variables = encoder.getVariables();
+            for (std::uint32_t id = 0; id < variables.size(); ++id) {
+                counterexample.emplace_back(variables.getName(id), solver.getModelValue(encoder.solverVariable(id)));
+            }
+            return EquivalenceVerdict::NOT_EQUIVALENT;
+        }
+        default:
+            return EquivalenceVerdict::UNKNOWN;
+    }
+}
+
+}
\ No newline at end of file
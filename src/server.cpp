@@ -0,0 +1,399 @@
+#include "server.h"
+#include "expression_writer.h"
+#include "parser.h"
+#include "proof_search.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace logixpr {
+
+namespace {
+
+class RequestError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+std::vector<std::string> splitFields(const std::string& request) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    while (true) {
+        std::size_t tab = request.find('\t', start);
+        fields.push_back(request.substr(start, tab - start));
+        if (tab == std::string::npos) {
+            return fields;
+        }
+        start = tab + 1;
+    }
+}
+
+// Parses the trailing key=value fields, clipping each to its ceiling
+void readOptions(const std::vector<std::string>& fields, std::size_t first,
+                 const std::vector<std::pair<std::string, int*>>& options,
+                 const std::vector<int>& ceilings) {
+    for (std::size_t i = first; i < fields.size(); ++i) {
+        std::size_t equals = fields[i].find('=');
+        std::string key = fields[i].substr(0, equals);
+        std::size_t option = 0;
+        while (option < options.size() && options[option].first != key) {
+            ++option;
+        }
+        if (equals == std::string::npos || option == options.size()) {
+            throw RequestError("unknown option: " + fields[i]);
+        }
+
+        std::string text = fields[i].substr(equals + 1);
+        int value = 0;
+        bool valid = !text.empty() && text.size() <= 9 &&
+                     std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+        if (valid) {
+            value = std::stoi(text);
+        }
+        if (!valid || value <= 0) {
+            throw RequestError("invalid value for " + key + ": " + text);
+        }
+        *options[option].second = std::min(value, ceilings[option]);
+    }
+}
+
+void expectFields(const std::vector<std::string>& fields, std::size_t required, const char* usage) {
+    if (fields.size() < required) {
+        throw RequestError(std::string("usage: ") + usage);
+    }
+}
+
+}
+
+RequestHandler::RequestHandler(ServerLimits limits)
+    : limits(limits), proof_cache(std::make_shared<ProofCache>()) {}
+
+void RequestHandler::handle(const std::string& request, const Emitter& emit) const {
+    std::vector<std::string> fields = splitFields(request);
+    const std::string& command = fields[0];
+    ExpressionWriter writer;
+
+    try {
+        if (command == "prove") {
+            expectFields(fields, 3, "prove<TAB>expr1<TAB>expr2");
+            int depth = limits.max_depth;
+            int transformations = limits.max_transformations;
+            readOptions(fields, 3, {{"depth", &depth}, {"transformations", &transformations}},
+                        {limits.max_depth, limits.max_transformations});
+
+            auto start = ExpressionParser::parse(fields[1]);
+            auto target = ExpressionParser::parse(fields[2]);
+            ProofSearch searcher(depth, transformations);
+            searcher.setResultCache(proof_cache);
+            Proof proof = searcher.findProof(*start, *target);
+
+            for (const auto& step : proof.steps) {
+                writer.clear().append("step\t").append(static_cast<long long>(step.step_number)).append('\t');
+                writer.append(LogicLaws::getLawName(step.law_applied)).append('\t').write(*step.expression);
+                emit(writer.str());
+            }
+            if (proof.found_target) {
+                emit("ok\tproved\t" + std::to_string(proof.total_steps));
+            } else if (proof.refuted) {
+                writer.clear().append("ok\tnot-equivalent\t");
+                for (std::size_t i = 0; i < proof.counterexample.size(); ++i) {
+                    const auto& [name, value] = proof.counterexample[i];
+                    writer.append(i == 0 ? "" : " ").append(name).append('=').append(value ? 'T' : 'F');
+                }
+                emit(writer.str());
+            } else {
+                emit("ok\tunknown");
+            }
+        } else if (command == "generate") {
+            expectFields(fields, 2, "generate<TAB>expr");
+            int steps = limits.max_generate_steps;
+            int limit = limits.max_generate_forms;
+            readOptions(fields, 2, {{"steps", &steps}, {"limit", &limit}},
+                        {limits.max_generate_steps, limits.max_generate_forms});
+
+            auto expression = ExpressionParser::parse(fields[1]);
+            ProofSearch searcher;
+            EnumerationLimits enumeration;
+            enumeration.max_depth = steps;
+            enumeration.max_forms = static_cast<std::size_t>(limit);
+            std::size_t count = 0;
+            if (limit > 0) {
+                count = searcher.enumerateEquivalentForms(*expression, enumeration, [&](const ASTNode& form, int) {
+                    emit(writer.clear().append("form\t").write(form).str());
+                    return true;
+                });
+            }
+            emit("ok\t" + std::to_string(count));
+        } else if (command == "parse") {
+            expectFields(fields, 2, "parse<TAB>expr");
+            readOptions(fields, 2, {}, {});
+            auto expression = ExpressionParser::parse(fields[1]);
+            emit(writer.clear().append("ok\t").write(*expression).str());
+        } else {
+            emit("error\tunknown command: " + command);
+        }
+    } catch (const ParseError& e) {
+        emit("error\tparse error at position " + std::to_string(e.getPosition()) + ": " + e.what());
+    } catch (const std::exception& e) {
+        emit(std::string("error\t") + e.what());
+    }
+}
+
+const ServerLimits& RequestHandler::getLimits() const {
+    return limits;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace {
+
+const std::size_t READ_CHUNK = 64 * 1024;
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Writes the whole buffer; false once the peer has gone away
+bool sendAll(int fd, const char* data, std::size_t length) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    while (length > 0) {
+        ssize_t sent = ::send(fd, data, length, flags);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        length -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+}
+
+struct UnixSocketServer::Connection {
+    int fd;
+    std::string buffer;
+    bool busy = false;
+    bool at_eof = false;
+    std::atomic<bool> broken{false};
+
+    explicit Connection(int fd) : fd(fd) {}
+
+    void send(std::string line) {
+        line += '\n';
+        if (!broken && !sendAll(fd, line.data(), line.size())) {
+            broken = true;
+        }
+    }
+};
+
+UnixSocketServer::UnixSocketServer(const std::string& socket_path, std::size_t threads, ServerLimits limits)
+    : socket_path(socket_path), handler(limits), pool(threads), listen_fd(-1), wake_pipe{-1, -1},
+      stopping(false) {
+    sockaddr_un address{};
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + socket_path);
+    }
+
+    // Replace a stale socket left by a previous run, but never anything else
+    struct stat info;
+    if (::lstat(socket_path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error("Refusing to replace non-socket file: " + socket_path);
+        }
+        ::unlink(socket_path.c_str());
+    }
+
+    if (::pipe(wake_pipe) != 0) {
+        throwSystemError("pipe");
+    }
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throwSystemError("socket");
+    }
+    for (int fd : {listen_fd, wake_pipe[0], wake_pipe[1]}) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    // Waking must never block a worker, and draining must never block the loop
+    for (int fd : {wake_pipe[0], wake_pipe[1]}) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throwSystemError("bind " + socket_path);
+    }
+    if (::listen(listen_fd, SOMAXCONN) != 0) {
+        throwSystemError("listen");
+    }
+}
+
+UnixSocketServer::~UnixSocketServer() {
+    pool.wait();
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+    for (int fd : {listen_fd, wake_pipe[0], wake_pipe[1]}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (listen_fd >= 0) {
+        ::unlink(socket_path.c_str());
+    }
+}
+
+void UnixSocketServer::run() {
+    std::vector<pollfd> polled;
+    std::vector<std::shared_ptr<Connection>> polled_connections;
+
+    while (!stopping) {
+        {
+            std::lock_guard<std::mutex> lock(finished_mutex);
+            for (int fd : finished) {
+                connections[fd]->busy = false;
+            }
+            finished.clear();
+        }
+
+        polled.clear();
+        polled_connections.clear();
+        polled.push_back({wake_pipe[0], POLLIN, 0});
+        polled.push_back({listen_fd, POLLIN, 0});
+        for (auto it = connections.begin(); it != connections.end();) {
+            auto connection = it->second;
+            if (!connection->busy) {
+                dispatch(connection);
+            }
+            if (connection->busy) {
+                ++it;
+                continue;
+            }
+            if (connection->at_eof || connection->broken) {
+                ::close(connection->fd);
+                it = connections.erase(it);
+                continue;
+            }
+            polled.push_back({connection->fd, POLLIN, 0});
+            polled_connections.push_back(connection);
+            ++it;
+        }
+
+        if (::poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwSystemError("poll");
+        }
+
+        if (polled[0].revents) {
+            char drain[64];
+            while (::read(wake_pipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        if (polled[1].revents & POLLIN) {
+            acceptConnections();
+        }
+        for (std::size_t i = 0; i < polled_connections.size(); ++i) {
+            if (polled[i + 2].revents) {
+                readFrom(*polled_connections[i]);
+            }
+        }
+    }
+}
+
+void UnixSocketServer::stop() {
+    stopping = true;
+    wake();
+}
+
+void UnixSocketServer::acceptConnections() {
+    int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    connections[fd] = std::make_shared<Connection>(fd);
+}
+
+void UnixSocketServer::readFrom(Connection& connection) {
+    char chunk[READ_CHUNK];
+    ssize_t received = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+    if (received < 0 && errno == EINTR) {
+        return;
+    }
+    if (received <= 0) {
+        connection.at_eof = true;
+        return;
+    }
+    connection.buffer.append(chunk, static_cast<std::size_t>(received));
+
+    if (connection.buffer.size() > handler.getLimits().max_request_bytes &&
+        connection.buffer.find('\n') == std::string::npos) {
+        connection.send("error\trequest too large");
+        connection.at_eof = true;
+    }
+}
+
+void UnixSocketServer::dispatch(const std::shared_ptr<Connection>& connection) {
+    while (true) {
+        std::size_t newline = connection->buffer.find('\n');
+        if (newline == std::string::npos) {
+            return;
+        }
+        std::string request = connection->buffer.substr(0, newline);
+        connection->buffer.erase(0, newline + 1);
+        if (!request.empty() && request.back() == '\r') {
+            request.pop_back();
+        }
+        if (request.empty()) {
+            continue;
+        }
+
+        connection->busy = true;
+        bool queued = pool.trySubmit([this, connection, request] {
+            handler.handle(request, [&connection](const std::string& line) { connection->send(line); });
+            {
+                std::lock_guard<std::mutex> lock(finished_mutex);
+                finished.push_back(connection->fd);
+            }
+            wake();
+        });
+        if (queued) {
+            return;
+        }
+        connection->busy = false;
+        connection->send("error\tserver busy");
+    }
+}
+
+void UnixSocketServer::wake() {
+    char byte = 0;
+    ssize_t ignored = ::write(wake_pipe[1], &byte, 1);
+    (void)ignored;
+}
+
+#endif
+
+}
\ No newline at end of file
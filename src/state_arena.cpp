@@ -0,0 +1,166 @@
+#include "state_arena.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace logixpr {
+
+namespace {
+
+const unsigned TYPE_MASK = 0x07;
+const unsigned CONSTANT_TRUE = 0x08;
+const unsigned INLINE_ID_LIMIT = 31;
+
+}
+
+StateArena::StateArena(std::size_t block_size)
+    : block_size(std::max<std::size_t>(block_size, 64)), block_used(0), bytes_reserved(0) {}
+
+std::string_view StateArena::encode(const ASTNode& expression) {
+    scratch.clear();
+    auto emit = [this](NodeType type) {
+        scratch.push_back(static_cast<char>(type));
+        return true;
+    };
+    foldTree<bool>(
+        expression,
+        [&](const ASTNode& node) {
+            if (node.getType() == NodeType::CONSTANT) {
+                unsigned value = static_cast<const ConstantNode&>(node).getValue() ? CONSTANT_TRUE : 0;
+                scratch.push_back(static_cast<char>(static_cast<unsigned>(NodeType::CONSTANT) | value));
+                return true;
+            }
+            std::uint32_t id = variables.intern(static_cast<const VariableNode&>(node).getName());
+            std::uint32_t inline_id = std::min<std::uint32_t>(id, INLINE_ID_LIMIT);
+            scratch.push_back(static_cast<char>(static_cast<unsigned>(NodeType::VARIABLE) | (inline_id << 3)));
+            if (inline_id == INLINE_ID_LIMIT) {
+                for (std::uint32_t rest = id - INLINE_ID_LIMIT;; rest >>= 7) {
+                    if (rest < 0x80) {
+                        scratch.push_back(static_cast<char>(rest));
+                        break;
+                    }
+                    scratch.push_back(static_cast<char>((rest & 0x7F) | 0x80));
+                }
+            }
+            return true;
+        },
+        [&](const UnaryOpNode& node, bool) { return emit(node.getType()); },
+        [&](const BinaryOpNode& node, bool, bool) { return emit(node.getType()); });
+    return scratch;
+}
+
+std::string_view StateArena::commit() {
+    std::size_t length = scratch.size();
+    if (blocks.empty() || block_used + length > block_size) {
+        // Oversized states get a block of their own
+        std::size_t size = std::max(block_size, length);
+        blocks.push_back(std::make_unique<char[]>(size));
+        bytes_reserved += size;
+        block_used = 0;
+    }
+    char* destination = blocks.back().get() + block_used;
+    std::memcpy(destination, scratch.data(), length);
+    block_used += length;
+    return std::string_view(destination, length);
+}
+
+std::string_view StateArena::store(const ASTNode& expression) {
+    encode(expression);
+    return commit();
+}
+
+std::unique_ptr<ASTNode> StateArena::decode(std::string_view state) const {
+    std::vector<std::unique_ptr<ASTNode>> operands;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        unsigned tag = static_cast<unsigned char>(state[i]);
+        NodeType type = static_cast<NodeType>(tag & TYPE_MASK);
+        switch (type) {
+            case NodeType::VARIABLE: {
+                std::uint32_t id = tag >> 3;
+                if (id == INLINE_ID_LIMIT) {
+                    std::uint32_t rest = 0;
+                    for (unsigned shift = 0;; shift += 7) {
+                        unsigned byte = static_cast<unsigned char>(state.at(++i));
+                        rest |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+                        if (!(byte & 0x80)) {
+                            break;
+                        }
+                    }
+                    id += rest;
+                }
+                operands.push_back(std::make_unique<VariableNode>(variables.getName(id)));
+                break;
+            }
+            case NodeType::CONSTANT:
+                operands.push_back(std::make_unique<ConstantNode>((tag & CONSTANT_TRUE) != 0));
+                break;
+            case NodeType::NOT:
+                operands.back() = std::make_unique<UnaryOpNode>(NodeType::NOT, std::move(operands.back()));
+                break;
+            default: {
+                auto right = std::move(operands.back());
+                operands.pop_back();
+                operands.back() = std::make_unique<BinaryOpNode>(type, std::move(operands.back()), std::move(right));
+                break;
+            }
+        }
+    }
+    if (operands.size() != 1) {
+        throw std::runtime_error("Malformed state encoding");
+    }
+    return std::move(operands.back());
+}
+
+std::size_t StateArena::bytesReserved() const {
+    return bytes_reserved + scratch.capacity();
+}
+
+SearchGraph::SearchGraph(const ASTNode& root) {
+    records.push_back({arena.store(root), NO_PARENT, 0, LogicLaw::DOUBLE_NEGATION, 0});
+    visited.insert(records.back().state);
+    descriptions.emplace_back();
+    description_ids.emplace("", 0);
+}
+
+bool SearchGraph::add(const ASTNode& expression, std::uint32_t parent, LogicLaw law, const std::string& description) {
+    if (visited.count(arena.encode(expression))) {
+        return false;
+    }
+    auto it = description_ids.find(description);
+    if (it == description_ids.end()) {
+        it = description_ids.emplace(description, static_cast<std::uint16_t>(descriptions.size())).first;
+        descriptions.push_back(description);
+    }
+    records.push_back({arena.commit(), parent, records[parent].depth + 1, law, it->second});
+    visited.insert(records.back().state);
+    return true;
+}
+
+bool SearchGraph::contains(const ASTNode& expression) {
+    return visited.count(arena.encode(expression)) != 0;
+}
+
+std::size_t SearchGraph::size() const {
+    return records.size();
+}
+
+const StateRecord& SearchGraph::getRecord(std::size_t index) const {
+    return records[index];
+}
+
+const std::string& SearchGraph::getDescription(std::size_t index) const {
+    return descriptions[records[index].description];
+}
+
+std::unique_ptr<ASTNode> SearchGraph::expression(std::size_t index) const {
+    return arena.decode(records[index].state);
+}
+
+std::size_t SearchGraph::bytesUsed() const {
+    // An unordered_set entry costs a node (next pointer, cached hash, value) plus a bucket pointer
+    std::size_t visited_bytes = visited.size() * (sizeof(void*) * 3 + sizeof(std::string_view)) +
+                                visited.bucket_count() * sizeof(void*);
+    return arena.bytesReserved() + records.capacity() * sizeof(StateRecord) + visited_bytes;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace logixpr {
+
+ThreadPool::ThreadPool(std::size_t thread_count, std::size_t max_queue)
+    : max_queue(std::max<std::size_t>(max_queue, 1)), active(0), stopping(false) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(thread_count);
+    try {
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    } catch (...) {
+        // Destroying a joinable thread terminates, so stop the started ones first
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        task_available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+    space_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        space_available.wait(lock, [this] { return tasks.size() < max_queue || stopping; });
+        tasks.push_back(std::move(task));
+    }
+    task_available.notify_one();
+}
+
+bool ThreadPool::trySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.size() >= max_queue || stopping) {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+    }
+    task_available.notify_one();
+    return true;
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return tasks.empty() && active == 0; });
+}
+
+void ThreadPool::parallelFor(std::size_t task_count, std::size_t parallelism,
+                             const std::function<void(std::size_t)>& work) {
+    struct Shared {
+        std::atomic<std::size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t running = 0;
+        bool closed = false;
+        std::exception_ptr error;
+    };
+    auto shared = std::make_shared<Shared>();
+    std::size_t count = task_count;
+
+    auto drain = [shared, count, &work] {
+        for (std::size_t i = shared->next++; i < count; i = shared->next++) {
+            try {
+                work(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                if (!shared->error) {
+                    shared->error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::size_t helpers = std::min(parallelism, task_count);
+    for (std::size_t i = 1; i < helpers; ++i) {
+        // A helper that starts after the caller is done must not touch work
+        bool submitted = trySubmit([shared, drain] {
+            {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                if (shared->closed) {
+                    return;
+                }
+                ++shared->running;
+            }
+            drain();
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (--shared->running == 0) {
+                shared->finished.notify_all();
+            }
+        });
+        if (!submitted) {
+            break;
+        }
+    }
+
+    drain();
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->closed = true;
+    shared->finished.wait(lock, [&] { return shared->running == 0; });
+    if (shared->error) {
+        std::rethrow_exception(shared->error);
+    }
+}
+
+std::size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+std::size_t ThreadPool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_available.wait(lock, [this] { return !tasks.empty() || stopping; });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++active;
+        }
+        space_available.notify_one();
+
+        // A throwing task must not take the worker down with it
+        try {
+            task();
+        } catch (...) {
+        }
+
+        bool now_idle;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --active;
+            now_idle = tasks.empty() && active == 0;
+        }
+        if (now_idle) {
+            idle.notify_all();
+        }
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "bdd.h"
+#include "parser.h"
+#include <unordered_map>
+
+namespace logixpr {
+namespace test {
+
+class BddTest : public ::testing::Test {
+protected:
+    BddManager manager;
+
+    Bdd build(const std::string& expr) {
+        return manager.build(*ExpressionParser::parse(expr));
+    }
+};
+
+TEST_F(BddTest, EquivalentFormulasShareRoot) {
+    EXPECT_EQ(build("!(p & q)"), build("!p | !q"));
+    EXPECT_EQ(build("p -> q"), build("!q -> !p"));
+    EXPECT_EQ(build("p <-> q"), build("(p -> q) & (q -> p)"));
+    EXPECT_EQ(build("p & (q | r)"), build("(p & q) | (p & r)"));
+    EXPECT_NE(build("p & q"), build("p | q"));
+}
+
+TEST_F(BddTest, TautologiesAndContradictions) {
+    EXPECT_TRUE(build("p | !p").isTrue());
+    EXPECT_TRUE(build("(p -> q) | (q -> p)").isTrue());
+    EXPECT_TRUE(build("p & !p").isFalse());
+    EXPECT_TRUE(build("T & F").isFalse());
+}
+
+TEST_F(BddTest, Evaluate) {
+    auto f = build("(a -> b) & !c");
+    std::vector<bool> assignment(manager.getVariableOrder().size());
+    assignment[manager.levelOf("a")] = true;
+    assignment[manager.levelOf("b")] = true;
+    EXPECT_TRUE(manager.evaluate(f, assignment));
+    assignment[manager.levelOf("c")] = true;
+    EXPECT_FALSE(manager.evaluate(f, assignment));
+}
+
+TEST_F(BddTest, GarbageCollectionKeepsLiveNodes) {
+    auto kept = build("(a & b) | (c & d)");
+    manager.collectGarbage();
+    std::size_t live = manager.nodeCount();
+    {
+        auto temporary = build("(e <-> f) <-> (g <-> h)");
+        EXPECT_GT(manager.nodeCount(), live);
+    }
+    EXPECT_GT(manager.collectGarbage(), 0);
+    EXPECT_EQ(manager.nodeCount(), live);
+    EXPECT_EQ(kept, build("(c & d) | (b & a)"));
+}
+
+TEST_F(BddTest, BucketsFormulasByMeaning) {
+    std::vector<std::string> corpus = {"p & q", "q & p", "!(!p | !q)", "p | q", "!(!p & !q)"};
+    std::unordered_map<Bdd, std::vector<std::size_t>, BddHasher> buckets;
+    for (std::size_t i = 0; i < corpus.size(); ++i) {
+        buckets[build(corpus[i])].push_back(i);
+    }
+    EXPECT_EQ(buckets.size(), 2);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "binary_format.h"
+#include "parser.h"
+#include <sstream>
+
+namespace logixpr {
+namespace test {
+
+class BinaryFormatTest : public ::testing::Test {
+protected:
+    static Proof sampleProof() {
+        Proof proof;
+        proof.steps.emplace_back(ExpressionParser::parse("!A | B"), LogicLaw::IMPLICATION_ELIMINATION,
+                                 LogicLaws::getLawName(LogicLaw::IMPLICATION_ELIMINATION), 1);
+        proof.steps.emplace_back(ExpressionParser::parse("B | !A"), LogicLaw::COMMUTATIVE_OR,
+                                 LogicLaws::getLawName(LogicLaw::COMMUTATIVE_OR) + " (reversed)", 2);
+        proof.steps.emplace_back(ExpressionParser::parse("B | !Longer_name"), LogicLaw::IDENTITY_OR,
+                                 "custom note", 3);
+        proof.found_target = true;
+        proof.total_steps = 3;
+        return proof;
+    }
+
+    static const std::uint8_t* bytes(const std::string& data) {
+        return reinterpret_cast<const std::uint8_t*>(data.data());
+    }
+};
+
+TEST_F(BinaryFormatTest, ExpressionsRoundTripFromMemoryAndStream) {
+    std::vector<std::string> inputs = {"A", "T", "!(A & B) -> (C <-> F)", "A | B | !!C", "B & A"};
+
+    std::ostringstream out;
+    BinaryWriter writer(out);
+    for (const auto& input : inputs) {
+        writer.writeExpression(*ExpressionParser::parse(input));
+    }
+    std::string data = out.str();
+
+    BinaryReader memory(bytes(data), data.size());
+    std::istringstream in(data);
+    BinaryReader stream(in);
+    for (const auto& input : inputs) {
+        std::string expected = ExpressionParser::parse(input)->toString();
+        ASSERT_EQ(memory.next(), RecordType::EXPRESSION);
+        EXPECT_EQ(memory.readExpression()->toString(), expected);
+        EXPECT_EQ(stream.readExpression()->toString(), expected);
+    }
+    EXPECT_EQ(memory.next(), RecordType::END);
+    EXPECT_EQ(stream.next(), RecordType::END);
+    EXPECT_EQ(memory.getVariables().size(), 3u);
+}
+
+TEST_F(BinaryFormatTest, FlatExpressionsUseFileVariableIds) {
+    VariableTable table;
+    table.intern("Z");
+    auto flat = FlatExpression::fromAST(*ExpressionParser::parse("(X & Y) | !X"), table);
+
+    std::ostringstream out;
+    BinaryWriter writer(out);
+    writer.writeExpression(flat, table);
+    std::string data = out.str();
+
+    BinaryReader reader(bytes(data), data.size());
+    FlatExpression decoded = reader.readFlatExpression();
+    EXPECT_EQ(decoded.size(), flat.size());
+    EXPECT_EQ(reader.getVariables().getName(0), "X");
+    EXPECT_EQ(decoded.toAST(reader.getVariables())->toString(), "((X & Y) | !X)");
+}
+
+TEST_F(BinaryFormatTest, ProofsRoundTrip) {
+    Proof proof = sampleProof();
+    proof.refuted = true;
+    proof.counterexample = {{"A", true}, {"Q", false}};
+
+    std::ostringstream out;
+    BinaryWriter writer(out);
+    writer.writeProof(proof);
+    writer.writeExpression(*ExpressionParser::parse("Q -> A"));
+    std::string data = out.str();
+
+    BinaryReader reader(bytes(data), data.size());
+    ASSERT_EQ(reader.next(), RecordType::PROOF);
+    Proof decoded = reader.readProof();
+    EXPECT_EQ(ProofFormatter::formatProof(decoded), ProofFormatter::formatProof(proof));
+    EXPECT_EQ(decoded.steps[1].description, proof.steps[1].description);
+    EXPECT_EQ(decoded.steps[2].description, "custom note");
+    EXPECT_TRUE(decoded.refuted);
+    EXPECT_EQ(decoded.counterexample, proof.counterexample);
+    EXPECT_EQ(reader.readExpression()->toString(), "(Q -> A)");
+}
+
+TEST_F(BinaryFormatTest, MuchSmallerThanText) {
+    Proof proof = sampleProof();
+    std::ostringstream out;
+    BinaryWriter writer(out);
+    writer.writeProof(proof);
+    EXPECT_LT(out.str().size() * 3, ProofFormatter::formatProof(proof).size());
+}
+
+TEST_F(BinaryFormatTest, RejectsCorruptInput) {
+    std::ostringstream out;
+    BinaryWriter writer(out);
+    writer.writeExpression(*ExpressionParser::parse("A & B"));
+    std::string data = out.str();
+
+    EXPECT_THROW(BinaryReader(bytes("nope!"), 5), FormatError);
+
+    std::string future = data;
+    future[4] = static_cast<char>(BinaryWriter::VERSION + 1);
+    EXPECT_THROW(BinaryReader(bytes(future), future.size()), FormatError);
+
+    for (std::size_t cut = 5; cut < data.size(); ++cut) {
+        BinaryReader reader(bytes(data), cut);
+        EXPECT_THROW(reader.readExpression(), FormatError) << cut;
+    }
+
+    // Corrupt the left-child distance of the AND node (the final byte)
+    std::string tampered = data;
+    tampered.back() = 5;
+    BinaryReader reader(bytes(tampered), tampered.size());
+    EXPECT_THROW(reader.readExpression(), FormatError);
+
+    BinaryReader wrong_kind(bytes(data), data.size());
+    EXPECT_THROW(wrong_kind.readProof(), FormatError);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
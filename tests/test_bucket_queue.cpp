@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "bucket_queue.h"
+#include <string>
+
+namespace logixpr {
+namespace test {
+
+TEST(BucketQueueTest, PopsSmallestKeyFirst) {
+    BucketQueue<std::string> queue;
+    queue.push(3, "c");
+    queue.push(1, "a");
+    queue.push(2, "b");
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.topKey(), 1u);
+    EXPECT_EQ(queue.pop(), "a");
+    EXPECT_EQ(queue.pop(), "b");
+    EXPECT_EQ(queue.pop(), "c");
+    EXPECT_TRUE(queue.empty());
+    EXPECT_THROW(queue.pop(), std::out_of_range);
+}
+
+TEST(BucketQueueTest, EqualKeysAreFifo) {
+    BucketQueue<int> queue;
+    for (int i = 0; i < 5; ++i) {
+        queue.push(2, i);
+    }
+    queue.push(4, 99);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(queue.pop(), i);
+    }
+    EXPECT_EQ(queue.top(), 99);
+}
+
+TEST(BucketQueueTest, KeyBelowMinimumMovesCursorBack) {
+    BucketQueue<int> queue;
+    queue.push(5, 1);
+    queue.push(7, 2);
+    EXPECT_EQ(queue.pop(), 1);
+    queue.push(0, 3);
+    EXPECT_EQ(queue.topKey(), 0u);
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_EQ(queue.pop(), 2);
+
+    // Drained buckets are reused
+    queue.push(7, 4);
+    EXPECT_EQ(queue.pop(), 4);
+    EXPECT_TRUE(queue.empty());
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "canonical.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+TEST(CanonicalTest, RenamedPairsShareKey) {
+    auto a = canonicalizePair(*ExpressionParser::parse("(a & b) -> a"), *ExpressionParser::parse("!a | b"));
+    auto b = canonicalizePair(*ExpressionParser::parse("(x & y) -> x"), *ExpressionParser::parse("!x | y"));
+    EXPECT_EQ(a.key, b.key);
+    EXPECT_EQ(a.start->toString(), "((v0 & v1) -> v0)");
+    EXPECT_EQ(a.target->toString(), "(!v0 | v1)");
+
+    // Labels are assigned jointly, so swapping the roles of the variables on one side is a different problem
+    auto c = canonicalizePair(*ExpressionParser::parse("(x & y) -> x"), *ExpressionParser::parse("!y | x"));
+    EXPECT_NE(a.key, c.key);
+}
+
+TEST(CanonicalTest, TargetOnlyVariablesAreLabelled) {
+    auto pair = canonicalizePair(*ExpressionParser::parse("p & T"), *ExpressionParser::parse("q | p"));
+    EXPECT_EQ(pair.key, "(v0 & T)\t(v1 | v0)");
+    EXPECT_EQ(pair.renaming.size(), 2u);
+    EXPECT_EQ(pair.renaming.toOriginal(*pair.target)->toString(), "(q | p)");
+}
+
+TEST(CanonicalTest, ProofsMapBackToOriginalNames) {
+    auto start = ExpressionParser::parse("alpha -> beta");
+    auto target = ExpressionParser::parse("!alpha | beta");
+
+    ProofSearch searcher;
+    Proof first = searcher.findProof(*start, *target);
+    ASSERT_TRUE(first.found_target);
+    EXPECT_EQ(first.steps.back().expression->toString(), "(!alpha | beta)");
+    EXPECT_EQ(searcher.getResultCache()->getMisses(), 1u);
+
+    Proof renamed = searcher.findProof(*ExpressionParser::parse("x -> y"), *ExpressionParser::parse("!x | y"));
+    ASSERT_TRUE(renamed.found_target);
+    EXPECT_EQ(renamed.steps.back().expression->toString(), "(!x | y)");
+    EXPECT_EQ(searcher.getResultCache()->getHits(), 1u);
+
+    Proof refuted = searcher.findProof(*ExpressionParser::parse("m & n"), *ExpressionParser::parse("m | n"));
+    ASSERT_FALSE(refuted.counterexample.empty());
+    for (const auto& [name, value] : refuted.counterexample) {
+        EXPECT_TRUE(name == "m" || name == "n") << name;
+    }
+}
+
+TEST(CanonicalTest, CacheEvictsOldestEntry) {
+    ProofCache cache(2);
+    cache.store("a", std::make_shared<Proof>());
+    cache.store("b", std::make_shared<Proof>());
+    cache.store("c", std::make_shared<Proof>());
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_FALSE(cache.lookup("a"));
+    EXPECT_TRUE(cache.lookup("c"));
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
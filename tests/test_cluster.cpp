@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "cluster.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+class ClusterTest : public ::testing::Test {
+protected:
+    std::vector<std::unique_ptr<ASTNode>> formulas;
+
+    std::vector<const ASTNode*> parseAll(std::initializer_list<const char*> texts) {
+        std::vector<const ASTNode*> pointers;
+        for (const char* text : texts) {
+            formulas.push_back(ExpressionParser::parse(text));
+            pointers.push_back(formulas.back().get());
+        }
+        return pointers;
+    }
+};
+
+TEST_F(ClusterTest, GroupsByEquivalence) {
+    auto corpus = parseAll({"a -> b", "!(a & b)", "!a | b", "a | !a", "!a | !b", "T", "b | !a", "a & (b | !b)", "a"});
+    EquivalenceClusterer clusterer;
+    auto classes = clusterer.cluster(corpus);
+
+    ASSERT_EQ(classes.size(), 4u);
+    EXPECT_EQ(classes[0].members, (std::vector<std::size_t>{0, 2, 6}));
+    EXPECT_EQ(classes[1].members, (std::vector<std::size_t>{1, 4}));
+    EXPECT_EQ(classes[2].members, (std::vector<std::size_t>{3, 5}));
+    EXPECT_EQ(classes[3].members, (std::vector<std::size_t>{7, 8}));
+    // Smallest member, earliest on ties
+    EXPECT_EQ(classes[0].representative, 0u);
+    EXPECT_EQ(classes[2].representative, 5u);
+    EXPECT_EQ(classes[3].representative, 8u);
+    EXPECT_TRUE(classes[0].proofs.empty());
+
+    // More workers than formulas or executor threads are simply not used
+    clusterer.setThreads(100000);
+    auto parallel = clusterer.cluster(corpus);
+    ASSERT_EQ(parallel.size(), classes.size());
+    for (std::size_t i = 0; i < classes.size(); ++i) {
+        EXPECT_EQ(parallel[i].members, classes[i].members);
+    }
+}
+
+TEST_F(ClusterTest, SeparatesCollidingSignatures) {
+    // One signature word over many variables: the conjunction is true on
+    // none of the 64 assignments, exactly like F, and only the BDDs split them
+    auto corpus = parseAll({"a & b & c & d & e & f & g & h & i & j & k & l", "F", "a & !a"});
+    EquivalenceClusterer clusterer;
+    clusterer.setSignatureWords(1);
+    EXPECT_EQ(clusterer.signature(*corpus[0]), clusterer.signature(*corpus[1]));
+
+    auto classes = clusterer.cluster(corpus);
+    ASSERT_EQ(classes.size(), 2u);
+    EXPECT_EQ(classes[0].members, (std::vector<std::size_t>{0}));
+    EXPECT_EQ(classes[1].members, (std::vector<std::size_t>{1, 2}));
+}
+
+TEST_F(ClusterTest, ProofsLeadToRepresentative) {
+    auto corpus = parseAll({"!(p | q)", "!p & !q", "p -> q", "!p | q", "!!(!p & !q)"});
+    EquivalenceClusterer clusterer;
+    clusterer.setProofs(true);
+    clusterer.setThreads(3);
+    clusterer.setExecutor(std::make_shared<ThreadPool>(2));
+    auto classes = clusterer.cluster(corpus);
+
+    ASSERT_EQ(classes.size(), 2u);
+    for (const auto& equivalence_class : classes) {
+        ASSERT_EQ(equivalence_class.proofs.size(), equivalence_class.members.size());
+        for (std::size_t i = 0; i < equivalence_class.members.size(); ++i) {
+            const Proof& proof = equivalence_class.proofs[i];
+            ASSERT_TRUE(proof.found_target);
+            if (equivalence_class.members[i] == equivalence_class.representative) {
+                EXPECT_TRUE(proof.steps.empty());
+            } else {
+                ASSERT_FALSE(proof.steps.empty());
+                EXPECT_TRUE(proof.steps.back().expression->equals(*corpus[equivalence_class.representative]));
+            }
+        }
+    }
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "parser.h"
+#include "equivalence_engine.h"
+
+namespace logixpr {
+namespace test {
+
+const int DEPTH = 200000;
+
+TEST(DeepExpressionTest, LongNegationPrefix) {
+    std::string input(DEPTH, '!');
+    input += "p";
+
+    auto expr = ExpressionParser::parse(input);
+    EXPECT_EQ(expr->toString(), input);
+
+    auto copy = expr->clone();
+    EXPECT_TRUE(copy->equals(*expr));
+}
+
+TEST(DeepExpressionTest, RightNestedImplications) {
+    std::string input;
+    for (int i = 0; i < DEPTH; ++i) {
+        input += "p -> ";
+    }
+    input += "q";
+
+    auto expr = ExpressionParser::parse(input);
+    ASSERT_EQ(expr->getType(), NodeType::IMPLIES);
+    EXPECT_EQ(static_cast<const BinaryOpNode&>(*expr).getLeft().toString(), "p");
+
+    std::string text = expr->toString();
+    EXPECT_EQ(text.size(), static_cast<size_t>(DEPTH) * 7 + 1);
+    EXPECT_TRUE(ExpressionParser::parse(text)->equals(*expr));
+}
+
+TEST(DeepExpressionTest, DeeplyParenthesized) {
+    std::string input = std::string(DEPTH, '(') + "p & q" + std::string(DEPTH, ')');
+    auto expr = ExpressionParser::parse(input);
+    EXPECT_EQ(expr->toString(), "(p & q)");
+}
+
+TEST(DeepExpressionTest, CommutativeEqualityAtDepth) {
+    // Build (x0 & (x1 & (...))) and the same chain with every AND swapped
+    std::unique_ptr<ASTNode> ordered = std::make_unique<VariableNode>("end");
+    std::unique_ptr<ASTNode> swapped = std::make_unique<VariableNode>("end");
+    for (int i = 0; i < DEPTH; ++i) {
+        std::string name = "x" + std::to_string(i % 7);
+        ordered = std::make_unique<BinaryOpNode>(NodeType::AND, std::make_unique<VariableNode>(name), std::move(ordered));
+        swapped = std::make_unique<BinaryOpNode>(NodeType::AND, std::move(swapped), std::make_unique<VariableNode>(name));
+    }
+    EXPECT_TRUE(ordered->equals(*swapped));
+
+    swapped = std::make_unique<BinaryOpNode>(NodeType::AND, std::move(swapped), std::make_unique<VariableNode>("extra"));
+    ordered = std::make_unique<BinaryOpNode>(NodeType::AND, std::make_unique<VariableNode>("other"), std::move(ordered));
+    EXPECT_FALSE(ordered->equals(*swapped));
+}
+
+TEST(DeepExpressionTest, LawApplicationOnDeepTree) {
+    std::string input(DEPTH, '!');
+    input += "(p & q)";
+    auto expr = ExpressionParser::parse(input);
+
+    EquivalenceEngine engine;
+    auto transformations = engine.applyLawRecursively(*expr, LogicLaw::DE_MORGAN_AND);
+    ASSERT_EQ(transformations.size(), 1u);
+    EXPECT_EQ(transformations[0].result->toString(), std::string(DEPTH - 1, '!') + "(!p | !q)");
+
+    // The rebuilt path carries metadata consistent with a fresh parse
+    const ASTNode& result = *transformations[0].result;
+    auto reparsed = ExpressionParser::parse(result.toString());
+    EXPECT_EQ(result.getSize(), reparsed->getSize());
+    EXPECT_EQ(result.getHeight(), reparsed->getHeight());
+    EXPECT_EQ(result.getHash(), reparsed->getHash());
+}
+
+TEST(DeepExpressionTest, CachedMetadata) {
+    std::string input(DEPTH, '!');
+    input += "(p & q)";
+    auto expr = ExpressionParser::parse(input);
+    EXPECT_EQ(expr->getSize(), static_cast<size_t>(DEPTH) + 3);
+    EXPECT_EQ(expr->getHeight(), static_cast<size_t>(DEPTH) + 1);
+    EXPECT_EQ(expr->getVariableMask(), ExpressionParser::parse("q | p")->getVariableMask());
+    EXPECT_FALSE(expr->getTypeMask() & (1u << static_cast<unsigned>(NodeType::OR)));
+
+    EXPECT_EQ(ExpressionParser::parse("(a | b) & c")->getHash(), ExpressionParser::parse("c & (b | a)")->getHash());
+    EXPECT_NE(ExpressionParser::parse("a -> b")->getHash(), ExpressionParser::parse("b -> a")->getHash());
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
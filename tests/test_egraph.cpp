@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "egraph.h"
+#include "equivalence_engine.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+class EGraphTest : public ::testing::Test {
+protected:
+    SaturationProver prover;
+
+    Proof prove(const std::string& start, const std::string& target) {
+        return prover.findProof(*ExpressionParser::parse(start), *ExpressionParser::parse(target));
+    }
+
+    // Every step must be one application of its law, forwards or backwards
+    void expectValidProof(const std::string& start, const std::string& target, const Proof& proof) {
+        EquivalenceEngine engine;
+        std::unique_ptr<ASTNode> previous = ExpressionParser::parse(start);
+        for (const auto& step : proof.steps) {
+            bool reversed = step.description.find("(reversed)") != std::string::npos;
+            const ASTNode& from = reversed ? *step.expression : *previous;
+            const ASTNode& to = reversed ? *previous : *step.expression;
+
+            bool justified = false;
+            for (const auto& transformation : engine.applyLawRecursively(from, step.law_applied)) {
+                if (transformation.result->toString() == to.toString()) {
+                    justified = true;
+                    break;
+                }
+            }
+            EXPECT_TRUE(justified) << previous->toString() << " => " << step.expression->toString()
+                                   << " by " << step.description;
+            previous = step.expression->clone();
+        }
+        EXPECT_EQ(previous->toString(), ExpressionParser::parse(target)->toString());
+    }
+};
+
+TEST_F(EGraphTest, CongruenceMergesParents) {
+    EGraph graph;
+    std::uint32_t p = graph.addVariable("p");
+    std::uint32_t q = graph.addVariable("q");
+    std::uint32_t not_p = graph.add({NodeType::NOT, 0, {p, 0}});
+    std::uint32_t not_q = graph.add({NodeType::NOT, 0, {q, 0}});
+    EXPECT_NE(graph.find(not_p), graph.find(not_q));
+
+    graph.merge(p, q, LogicLaw::COMMUTATIVE_AND);
+    graph.rebuild();
+    EXPECT_EQ(graph.find(not_p), graph.find(not_q));
+    EXPECT_EQ(graph.classCount(), 2u);
+}
+
+TEST_F(EGraphTest, HashconsReusesNodes) {
+    EGraph graph;
+    std::uint32_t first = graph.addTerm(*ExpressionParser::parse("(p & q) | (p & q)"));
+    std::size_t nodes = graph.nodeCount();
+    std::uint32_t second = graph.addTerm(*ExpressionParser::parse("(p & q) | (p & q)"));
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(graph.nodeCount(), nodes);
+    EXPECT_EQ(graph.extractTerm(first)->toString(), "((p & q) | (p & q))");
+}
+
+TEST_F(EGraphTest, ProvesSimpleLaws) {
+    Proof proof = prove("!(p & q)", "!p | !q");
+    ASSERT_TRUE(proof.found_target);
+    EXPECT_EQ(proof.total_steps, 1);
+    expectValidProof("!(p & q)", "!p | !q", proof);
+}
+
+TEST_F(EGraphTest, ProvesAssociativityAndCommutativity) {
+    std::string start = "((a & b) & c) & d";
+    std::string target = "d & (c & (b & a))";
+    Proof proof = prove(start, target);
+    ASSERT_TRUE(proof.found_target);
+    expectValidProof(start, target, proof);
+}
+
+TEST_F(EGraphTest, ProvesDistributiveChains) {
+    std::string start = "(p | q) & (p | r)";
+    std::string target = "p | (q & r)";
+    Proof proof = prove(start, target);
+    ASSERT_TRUE(proof.found_target);
+    expectValidProof(start, target, proof);
+}
+
+TEST_F(EGraphTest, ProvesBeyondBreadthFirstDepth) {
+    std::string start = "(a & b) | (c & d)";
+    std::string target = "((a | c) & (a | d)) & ((b | c) & (b | d))";
+    Proof proof = prove(start, target);
+    ASSERT_TRUE(proof.found_target);
+    EXPECT_GT(proof.total_steps, 3);
+    expectValidProof(start, target, proof);
+}
+
+TEST_F(EGraphTest, ProvesThroughImplications) {
+    std::string start = "p -> q";
+    std::string target = "!q -> !p";
+    Proof proof = prove(start, target);
+    ASSERT_TRUE(proof.found_target);
+    expectValidProof(start, target, proof);
+}
+
+TEST_F(EGraphTest, IdenticalExpressionsNeedNoSteps) {
+    Proof proof = prove("p & q", "p & q");
+    EXPECT_TRUE(proof.found_target);
+    EXPECT_EQ(proof.total_steps, 0);
+}
+
+TEST_F(EGraphTest, RespectsNodeLimit) {
+    prover.setNodeLimit(10);
+    Proof proof = prove("((a & b) & c) & (d | e)", "p");
+    EXPECT_FALSE(proof.found_target);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
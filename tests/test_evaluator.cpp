@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "evaluator.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+TEST(EvaluatorTest, EvaluatesSingleAssignments) {
+    auto expr = ExpressionParser::parse("(p -> q) <-> !r");
+    auto compiled = CompiledExpression::compile(*expr);
+    ASSERT_EQ(compiled.getVariables(), (std::vector<std::string>{"p", "q", "r"}));
+
+    // Bit i of the assignment is the value of variable i
+    EXPECT_TRUE(compiled.evaluate(0b000));
+    EXPECT_FALSE(compiled.evaluate(0b100));
+    EXPECT_FALSE(compiled.evaluate(0b001));
+    EXPECT_TRUE(compiled.evaluate(0b101));
+}
+
+TEST(EvaluatorTest, CountsModels) {
+    EXPECT_EQ(CompiledExpression::compile(*ExpressionParser::parse("p & q")).countModels(), 1);
+    EXPECT_EQ(CompiledExpression::compile(*ExpressionParser::parse("p | !p")).countModels(), 2);
+    EXPECT_EQ(CompiledExpression::compile(*ExpressionParser::parse("T")).countModels(), 1);
+    EXPECT_EQ(CompiledExpression::compile(*ExpressionParser::parse("a | b | c | d | e | f | g | h")).countModels(), 255);
+}
+
+TEST(EvaluatorTest, ShardedEnumerationMatchesSerial) {
+    auto expr = ExpressionParser::parse(
+        "((a <-> b) | (c & !d)) -> ((e | f) & (g <-> h) | (i & j & !k) | (l -> m) & (n | o) & p & q & r)");
+    auto compiled = CompiledExpression::compile(*expr);
+    EXPECT_EQ(compiled.countModels(1), compiled.countModels(4));
+}
+
+TEST(EvaluatorTest, EquivalenceAndCounterexamples) {
+    auto a = ExpressionParser::parse("!(p & q)");
+    auto b = ExpressionParser::parse("!p | !q");
+    auto c = ExpressionParser::parse("!p & !q");
+    EXPECT_TRUE(TruthTable::areEquivalent(*a, *b));
+
+    std::vector<std::pair<std::string, bool>> counterexample;
+    ASSERT_TRUE(TruthTable::findCounterexample(*a, *c, counterexample));
+    ASSERT_EQ(counterexample.size(), 2);
+    EXPECT_EQ(counterexample[0], std::make_pair(std::string("p"), true));
+    EXPECT_EQ(counterexample[1], std::make_pair(std::string("q"), false));
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
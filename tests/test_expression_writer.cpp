@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "expression_writer.h"
+#include "parser.h"
+#include "proof_search.h"
+
+namespace logixpr {
+namespace test {
+
+class ExpressionWriterTest : public ::testing::Test {
+protected:
+    static std::string write(const std::string& input, OutputStyle style) {
+        auto expr = ExpressionParser::parse(input);
+        return ExpressionWriter::toString(*expr, style);
+    }
+};
+
+TEST_F(ExpressionWriterTest, AsciiMatchesToString) {
+    for (const char* input : {"A", "T", "!A", "A & B", "!(A | B) -> (C <-> F)", "A -> B -> C"}) {
+        auto expr = ExpressionParser::parse(input);
+        EXPECT_EQ(ExpressionWriter::toString(*expr), expr->toString());
+    }
+    EXPECT_EQ(write("!(A | B) -> C", OutputStyle::ASCII), "(!(A | B) -> C)");
+}
+
+TEST_F(ExpressionWriterTest, UnicodeStyle) {
+    EXPECT_EQ(write("!(A | B) -> (C <-> D & T)", OutputStyle::UNICODE), "(¬(A ∨ B) → (C ↔ (D ∧ T)))");
+}
+
+TEST_F(ExpressionWriterTest, FullyParenthesizedStyle) {
+    EXPECT_EQ(write("!!A & B", OutputStyle::FULLY_PARENTHESIZED), "((!(!A)) & B)");
+}
+
+TEST_F(ExpressionWriterTest, EveryStyleParsesBack) {
+    auto expr = ExpressionParser::parse("!(A | !B) -> (C <-> (D & F)) | !T");
+    for (OutputStyle style : {OutputStyle::ASCII, OutputStyle::UNICODE, OutputStyle::FULLY_PARENTHESIZED}) {
+        auto reparsed = ExpressionParser::parse(ExpressionWriter::toString(*expr, style));
+        EXPECT_EQ(reparsed->toString(), expr->toString());
+    }
+}
+
+TEST_F(ExpressionWriterTest, AppendsIntoOneBuffer) {
+    auto a = ExpressionParser::parse("A & B");
+    auto b = ExpressionParser::parse("!C");
+
+    ExpressionWriter writer;
+    writer.write(*a).append(", ").write(*b).append(' ').append(42LL);
+    EXPECT_EQ(writer.str(), "(A & B), !C 42");
+
+    writer.clear().write(*b);
+    EXPECT_EQ(writer.str(), "!C");
+    EXPECT_EQ(writer.release(), "!C");
+    EXPECT_EQ(writer.size(), 0u);
+}
+
+TEST_F(ExpressionWriterTest, FormatsProofInRequestedStyle) {
+    Proof proof;
+    proof.steps.emplace_back(ExpressionParser::parse("!A | B"), LogicLaw::IMPLICATION_ELIMINATION,
+                             LogicLaws::getLawName(LogicLaw::IMPLICATION_ELIMINATION), 1);
+    proof.found_target = true;
+    proof.total_steps = 1;
+
+    std::string ascii = ProofFormatter::formatProof(proof);
+    EXPECT_NE(ascii.find("Step 1: (!A | B)\n"), std::string::npos);
+    EXPECT_NE(ascii.find("Proof found in 1 steps"), std::string::npos);
+
+    std::string unicode = ProofFormatter::formatProof(proof, OutputStyle::UNICODE);
+    EXPECT_NE(unicode.find("Step 1: (¬A ∨ B)\n"), std::string::npos);
+    EXPECT_EQ(ProofFormatter::formatProofStep(proof.steps[0]),
+              "Step 1: (!A | B)\n  Using: " + LogicLaws::getLawName(LogicLaw::IMPLICATION_ELIMINATION) + "\n  " +
+                  proof.steps[0].description + "\n\n");
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
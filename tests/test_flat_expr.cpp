@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "flat_expr.h"
+#include "parser.h"
+#include <stdexcept>
+
+namespace logixpr {
+namespace test {
+
+class FlatExpressionTest : public ::testing::Test {
+protected:
+    VariableTable variables;
+
+    FlatExpression flatten(const std::string& expr) {
+        return FlatExpression::fromAST(*ExpressionParser::parse(expr), variables);
+    }
+};
+
+TEST_F(FlatExpressionTest, RoundTripPreservesStructure) {
+    auto original = ExpressionParser::parse("!(p & q) -> (r <-> !!p) | F");
+    auto flat = FlatExpression::fromAST(*original, variables);
+    auto restored = flat.toAST(variables);
+    EXPECT_EQ(restored->toString(), original->toString());
+    EXPECT_EQ(variables.size(), 3);
+}
+
+TEST_F(FlatExpressionTest, PostorderLayout) {
+    auto flat = flatten("p & !q");
+    ASSERT_EQ(flat.size(), 4);
+    EXPECT_EQ(flat.getNode(flat.root()).type, NodeType::AND);
+    EXPECT_EQ(flat.leftChild(flat.root()), 0);
+    EXPECT_EQ(flat.rightChild(flat.root()), 2);
+    EXPECT_EQ(flat.subtreeStart(2), 1);
+}
+
+TEST_F(FlatExpressionTest, HashAndEquality) {
+    auto a = flatten("(p | q) & r");
+    auto b = flatten("(p | q) & r");
+    auto c = flatten("r & (p | q)");
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_FALSE(a == c);
+}
+
+TEST_F(FlatExpressionTest, Evaluate) {
+    auto flat = flatten("p -> q");
+    std::uint32_t p = 0, q = 0;
+    ASSERT_TRUE(variables.lookup("p", p));
+    ASSERT_TRUE(variables.lookup("q", q));
+
+    std::vector<bool> assignment(variables.size());
+    assignment[p] = true;
+    assignment[q] = false;
+    EXPECT_FALSE(flat.evaluate(assignment));
+    assignment[q] = true;
+    EXPECT_TRUE(flat.evaluate(assignment));
+
+    EXPECT_THROW(FlatExpression().evaluate(assignment), std::logic_error);
+}
+
+TEST_F(FlatExpressionTest, ReplaceSubtreeRelinksAncestors) {
+    auto flat = flatten("(p & q) | r");
+    std::size_t left = flat.leftChild(flat.root());
+    auto replacement = flatten("!(s -> t)");
+    auto rewritten = flat.replaceSubtree(left, replacement);
+    EXPECT_EQ(rewritten.toAST(variables)->toString(), "(!(s -> t) | r)");
+
+    auto right_rewritten = flat.replaceSubtree(flat.rightChild(flat.root()), replacement);
+    EXPECT_EQ(right_rewritten.toAST(variables)->toString(), "((p & q) | !(s -> t))");
+    EXPECT_TRUE(right_rewritten.subtree(right_rewritten.leftChild(right_rewritten.root())) == flatten("p & q"));
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "law_config.h"
+#include "equivalence_engine.h"
+#include "proof_search.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+TEST(LawConfigTest, DefaultEnablesEverything) {
+    LawConfiguration config;
+    EXPECT_TRUE(config.isDefault());
+    EXPECT_EQ(config.activeLaws().size(), LAW_COUNT);
+    config.setWeight(LogicLaw::DE_MORGAN_AND, 3);
+    EXPECT_FALSE(config.isDefault());
+    EXPECT_EQ(config.activeLaws().front(), LogicLaw::DE_MORGAN_AND);
+}
+
+TEST(LawConfigTest, ForProblemDropsUnreachableConnectives) {
+    auto start = ExpressionParser::parse("!(a & b)");
+    auto target = ExpressionParser::parse("!a | !b");
+    auto config = LawConfiguration::forProblem(*start, *target);
+    EXPECT_TRUE(config.isEnabled(LogicLaw::DE_MORGAN_AND));
+    EXPECT_FALSE(config.isEnabled(LogicLaw::IMPLICATION_ELIMINATION));
+    EXPECT_FALSE(config.isEnabled(LogicLaw::BICONDITIONAL_ELIMINATION));
+
+    // -> can be eliminated into | and !, so laws over those stay reachable
+    auto implication = LawConfiguration::forProblem(*ExpressionParser::parse("a -> b"), *ExpressionParser::parse("b"));
+    EXPECT_TRUE(implication.isEnabled(LogicLaw::IMPLICATION_ELIMINATION));
+    EXPECT_TRUE(implication.isEnabled(LogicLaw::DE_MORGAN_OR));
+}
+
+TEST(LawConfigTest, OnlyRestrictsGeneratedTransformations) {
+    EquivalenceEngine engine;
+    engine.setLawConfiguration(LawConfiguration::only({LogicLaw::COMMUTATIVE_AND}));
+    auto expression = ExpressionParser::parse("!(a & b)");
+    auto transformations = engine.generateAllTransformations(*expression);
+    ASSERT_FALSE(transformations.empty());
+    for (const auto& transformation : transformations) {
+        EXPECT_EQ(transformation.law, LogicLaw::COMMUTATIVE_AND);
+    }
+}
+
+TEST(LawConfigTest, SearchRespectsDisabledLaws) {
+    auto start = ExpressionParser::parse("a -> b");
+    auto target = ExpressionParser::parse("!a | b");
+
+    ProofSearch search;
+    auto proof = search.findProof(*start, *target);
+    EXPECT_TRUE(proof.found_target);
+
+    LawConfiguration config;
+    config.disable(LogicLaw::IMPLICATION_ELIMINATION);
+    search.setLawConfiguration(config);
+    search.setMaxDepth(4);
+    EXPECT_FALSE(search.findProof(*start, *target).found_target);
+}
+
+TEST(LawConfigTest, DefaultSearchKeepsStandardLaws) {
+    auto start = ExpressionParser::parse("!(a & b)");
+    auto target = ExpressionParser::parse("!a | !b");
+
+    // No <-> anywhere, yet the default configuration stays whole
+    ProofSearch search;
+    EXPECT_TRUE(search.findShortestProof(*start, *target).found_target);
+    EXPECT_TRUE(search.getEffectiveLawConfiguration().isDefault());
+
+    // A custom configuration is still narrowed to the laws that can fire
+    LawConfiguration config;
+    config.setWeight(LogicLaw::DE_MORGAN_AND, 2);
+    search.setLawConfiguration(config);
+    EXPECT_TRUE(search.findShortestProof(*start, *target).found_target);
+    EXPECT_FALSE(search.getEffectiveLawConfiguration().isEnabled(LogicLaw::BICONDITIONAL_ELIMINATION));
+    EXPECT_TRUE(search.getEffectiveLawConfiguration().isEnabled(LogicLaw::DE_MORGAN_AND));
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "law_profile.h"
+#include "proof_search.h"
+#include "parser.h"
+#include <sstream>
+
+namespace logixpr {
+namespace test {
+
+TEST(LawProfileTest, RecordsStepsByRootAndDepth) {
+    auto start = ExpressionParser::parse("!(a & b) -> c");
+    ProofSearch searcher;
+    auto profile = std::make_shared<LawProfile>();
+    searcher.setLawProfile(profile);
+    auto proof = searcher.findProof(*start, *ExpressionParser::parse("(a & b) | c"));
+    ASSERT_TRUE(proof.found_target);
+    ASSERT_EQ(proof.steps.size(), 2u);
+
+    EXPECT_EQ(profile->getProofCount(), 1u);
+    EXPECT_EQ(profile->getCount(NodeType::IMPLIES, 0, LogicLaw::IMPLICATION_ELIMINATION), 1u);
+    EXPECT_EQ(profile->getCount(NodeType::OR, 1, LogicLaw::DOUBLE_NEGATION), 1u);
+    EXPECT_EQ(profile->getCount(NodeType::OR, 0, LogicLaw::DOUBLE_NEGATION), 0u);
+}
+
+TEST(LawProfileTest, OrdersSuccessorsMostUsedFirst) {
+    LawProfile profile;
+    std::vector<Transformation> successors;
+    successors.emplace_back(LogicLaw::COMMUTATIVE_AND, "", ExpressionParser::parse("b & a"));
+    successors.emplace_back(LogicLaw::IDEMPOTENT_AND, "", ExpressionParser::parse("a"));
+    successors.emplace_back(LogicLaw::ABSORPTION_AND, "", ExpressionParser::parse("a"));
+
+    // An empty profile keeps the engine's order
+    profile.order(NodeType::AND, 0, successors);
+    EXPECT_EQ(successors[0].law, LogicLaw::COMMUTATIVE_AND);
+
+    profile.recordStep(NodeType::AND, 5, LogicLaw::IDEMPOTENT_AND);
+    profile.recordStep(NodeType::AND, 0, LogicLaw::ABSORPTION_AND);
+    profile.order(NodeType::AND, 0, successors);
+    EXPECT_EQ(successors[0].law, LogicLaw::ABSORPTION_AND);
+    EXPECT_EQ(successors[1].law, LogicLaw::IDEMPOTENT_AND);
+    EXPECT_EQ(successors[2].law, LogicLaw::COMMUTATIVE_AND);
+
+    // Depths past the last bucket share it
+    EXPECT_EQ(profile.getCount(NodeType::AND, 50, LogicLaw::IDEMPOTENT_AND), 0u);
+    profile.recordStep(NodeType::AND, 50, LogicLaw::IDEMPOTENT_AND);
+    EXPECT_EQ(profile.getCount(NodeType::AND, 9, LogicLaw::IDEMPOTENT_AND), 1u);
+}
+
+TEST(LawProfileTest, SaveAndLoadRoundTrip) {
+    LawProfile profile;
+    profile.recordStep(NodeType::NOT, 0, LogicLaw::DE_MORGAN_AND);
+    profile.recordStep(NodeType::NOT, 0, LogicLaw::DE_MORGAN_AND);
+    profile.recordStep(NodeType::BICONDITIONAL, 3, LogicLaw::BICONDITIONAL_ELIMINATION);
+
+    std::stringstream stream;
+    profile.save(stream);
+    LawProfile loaded;
+    loaded.load(stream);
+    EXPECT_EQ(loaded.getCount(NodeType::NOT, 0, LogicLaw::DE_MORGAN_AND), 2u);
+    EXPECT_EQ(loaded.getCount(NodeType::BICONDITIONAL, 3, LogicLaw::BICONDITIONAL_ELIMINATION), 1u);
+
+    std::stringstream malformed("logixpr-law-profile 1\nproofs 0\n0 0 99 1\n");
+    EXPECT_THROW(loaded.load(malformed), std::runtime_error);
+    EXPECT_EQ(loaded.getCount(NodeType::NOT, 0, LogicLaw::DE_MORGAN_AND), 2u);
+    EXPECT_FALSE(loaded.loadFile("/nonexistent/law.profile"));
+}
+
+TEST(LawProfileTest, LearnedOrderReachesProofWithinSmallerBudget) {
+    auto start = ExpressionParser::parse("(a -> b) & (b -> a)");
+    auto target = ExpressionParser::parse("(!a | b) & (!b | a)");
+
+    // A problem of the same shape over other variables
+    auto profile = std::make_shared<LawProfile>();
+    ProofSearch trainer;
+    trainer.setLawProfile(profile);
+    ASSERT_TRUE(trainer.findProof(*ExpressionParser::parse("(p -> q) & (q -> p)"),
+                                  *ExpressionParser::parse("(!p | q) & (!q | p)")).found_target);
+
+    ProofSearch searcher(10, 20);
+    searcher.setSemanticPrecheck(false);
+    Proof unguided = searcher.findShortestProof(*start, *target);
+    searcher.setLawProfile(profile);
+    Proof guided = searcher.findShortestProof(*start, *target);
+    EXPECT_FALSE(unguided.found_target);
+    ASSERT_TRUE(guided.found_target);
+    EXPECT_EQ(guided.steps.size(), 1u);
+}
+
+TEST(LawProfileTest, RepeatedQueriesHitTheCache) {
+    auto start = ExpressionParser::parse("(a -> b) & (b -> a)");
+    auto target = ExpressionParser::parse("(!a | b) & (!b | a)");
+    ProofSearch searcher;
+    auto profile = std::make_shared<LawProfile>();
+    searcher.setLawProfile(profile);
+    searcher.setRetainedGraphLimit(64 << 20);
+
+    Proof first = searcher.findProof(*start, *target);
+    ASSERT_TRUE(first.found_target);
+    for (int i = 0; i < 4; ++i) {
+        Proof repeated = searcher.findProof(*start, *target);
+        ASSERT_TRUE(repeated.found_target);
+        EXPECT_EQ(repeated.steps.size(), first.steps.size());
+    }
+    auto cache = searcher.getResultCache();
+    EXPECT_EQ(cache->getMisses(), 1u);
+    EXPECT_EQ(cache->getHits(), 4u);
+    EXPECT_EQ(cache->size(), 1u);
+    EXPECT_EQ(profile->getProofCount(), 5u);
+
+    // The counts settled on one order, so the retained search is reused
+    searcher.setResultCache(nullptr);
+    searcher.findProof(*start, *target);
+    std::size_t retained = searcher.getSearchRetention()->size();
+    searcher.findProof(*start, *target);
+    EXPECT_EQ(searcher.getSearchRetention()->size(), retained);
+}
+
+TEST(LawProfileTest, VersionChangesWithTheOrder) {
+    LawProfile profile;
+    std::uint64_t version = profile.getVersion();
+    profile.recordStep(NodeType::AND, 0, LogicLaw::COMMUTATIVE_AND);
+    EXPECT_NE(profile.getVersion(), version);
+
+    // More of the same keeps every comparison between laws
+    version = profile.getVersion();
+    profile.recordStep(NodeType::AND, 0, LogicLaw::COMMUTATIVE_AND);
+    EXPECT_EQ(profile.getVersion(), version);
+
+    profile.recordStep(NodeType::AND, 3, LogicLaw::IDEMPOTENT_AND);
+    EXPECT_NE(profile.getVersion(), version);
+    EXPECT_NE(LawProfile().getVersion(), LawProfile().getVersion());
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include "equivalence_engine.h"
 #include "logic_laws.h"
 #include "parser.h"
 
@@ -200,5 +201,35 @@ TEST_F(LogicLawsTest, IdempotentOr) {
     assertNoTransformation("p | q", LogicLaw::IDEMPOTENT_OR);
 }
 
+TEST_F(LogicLawsTest, CompileTimeLawSets) {
+    static_assert(StandardLaws::SIZE == 21, "every law is in the standard set");
+    static_assert(StandardLaws::contains(LogicLaw::DISTRIBUTIVE_OR_OVER_AND), "");
+    static_assert(!NonDistributiveLaws::contains(LogicLaw::DISTRIBUTIVE_OR_OVER_AND), "");
+    static_assert(LawSet<LogicLaw::IMPLICATION_ELIMINATION>::ROOT_MASK == nodeTypeBit(NodeType::IMPLIES), "");
+
+    auto expr = parse("p & (q | r)");
+    EXPECT_TRUE(StandardLaws::apply(*expr, LogicLaw::DISTRIBUTIVE_AND_OVER_OR));
+    EXPECT_FALSE(NonDistributiveLaws::apply(*expr, LogicLaw::DISTRIBUTIVE_AND_OVER_OR));
+    EXPECT_TRUE(NonDistributiveLaws::apply(*expr, LogicLaw::COMMUTATIVE_AND));
+}
+
+TEST_F(LogicLawsTest, SpecializedEngineOmitsExcludedLaws) {
+    auto expr = parse("!(p & (q | r))");
+    EquivalenceEngine full;
+    SpecializedEquivalenceEngine<NonDistributiveLaws> restricted;
+
+    auto all = full.generateAllTransformations(*expr);
+    auto subset = restricted.generateAllTransformations(*expr);
+    std::size_t distributive = 0;
+    for (const auto& transformation : all) {
+        distributive += NonDistributiveLaws::contains(transformation.law) ? 0 : 1;
+    }
+    EXPECT_GT(distributive, 0u);
+    EXPECT_EQ(subset.size(), all.size() - distributive);
+    for (const auto& transformation : restricted.generateSingleStepTransformations(*expr)) {
+        EXPECT_TRUE(NonDistributiveLaws::contains(transformation.law));
+    }
+}
+
 } // namespace test
 } // namespace logixpr
\ No newline at end of file
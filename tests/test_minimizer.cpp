@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "minimizer.h"
+#include "evaluator.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+std::string simplified(const std::string& input, NormalForm form = NormalForm::DISJUNCTIVE,
+                       MinimizationMode mode = MinimizationMode::AUTOMATIC) {
+    auto expression = ExpressionParser::parse(input);
+    auto result = LogicMinimizer(form, mode).simplify(*expression);
+    EXPECT_TRUE(TruthTable::areEquivalent(*expression, *result)) << input << " vs " << result->toString();
+    return result->toString();
+}
+
+TEST(MinimizerTest, ExactSumOfProducts) {
+    EXPECT_EQ(simplified("(a & b) | (a & !b) | (!a & b)"), "(a | b)");
+    // The consensus term b & c is redundant
+    EXPECT_EQ(simplified("(a & b) | (!a & c) | (b & c)"), "((a & b) | (!a & c))");
+    EXPECT_EQ(simplified("a -> (b -> a)"), "T");
+    EXPECT_EQ(simplified("a & !a"), "F");
+}
+
+TEST(MinimizerTest, ProductOfSums) {
+    EXPECT_EQ(simplified("(a | b) & (a | !b)", NormalForm::CONJUNCTIVE), "a");
+    EXPECT_EQ(simplified("(a & b) | c", NormalForm::CONJUNCTIVE), "((a | c) & (b | c))");
+    EXPECT_EQ(simplified("a <-> a", NormalForm::CONJUNCTIVE), "T");
+    EXPECT_THROW(LogicMinimizer(NormalForm::NEGATION), std::invalid_argument);
+}
+
+TEST(MinimizerTest, HeuristicMatchesExactOnSmallFunctions) {
+    for (const char* input : {"(a <-> b) | (c & !d)", "(a -> b) & (b -> c) & (c -> a)",
+                              "!(a & (b | c)) | (d <-> (a & c))"}) {
+        auto expression = ExpressionParser::parse(input);
+        auto variables = TruthTable::collectVariables(*expression);
+        auto exact = LogicMinimizer(NormalForm::DISJUNCTIVE, MinimizationMode::EXACT).minimizeCover(*expression, variables);
+        auto heuristic = LogicMinimizer(NormalForm::DISJUNCTIVE, MinimizationMode::HEURISTIC).minimizeCover(*expression, variables);
+        EXPECT_GE(heuristic.size(), exact.size()) << input;
+        EXPECT_LE(heuristic.size(), exact.size() + 1) << input;
+        simplified(input, NormalForm::DISJUNCTIVE, MinimizationMode::HEURISTIC);
+    }
+}
+
+TEST(MinimizerTest, HeuristicScalesPastTruthTables) {
+    // 40 variables: twenty pairwise products, each also present in an absorbed redundant form
+    std::string input;
+    for (int i = 0; i < 20; ++i) {
+        std::string x = "x" + std::to_string(i);
+        std::string y = "y" + std::to_string(i);
+        input += (i ? " | " : "") + std::string("(") + x + " & " + y + ") | (" + x + " & " + y + " & !x" +
+                 std::to_string((i + 1) % 20) + ")";
+    }
+    auto expression = ExpressionParser::parse(input);
+    auto variables = TruthTable::collectVariables(*expression);
+    ASSERT_EQ(variables.size(), 40u);
+
+    auto cover = LogicMinimizer().minimizeCover(*expression, variables);
+    EXPECT_EQ(cover.size(), 20u);
+    for (const Cube& cube : cover) {
+        EXPECT_EQ(cube.literalCount(), 2u);
+    }
+    EXPECT_THROW(LogicMinimizer(NormalForm::DISJUNCTIVE, MinimizationMode::EXACT).minimizeCover(*expression, variables),
+                 std::invalid_argument);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "normal_form.h"
+#include "evaluator.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+class NormalFormTest : public ::testing::Test {
+protected:
+    std::unique_ptr<ASTNode> normalize(const std::string& expr, NormalForm form, std::vector<ProofStep>& steps) {
+        NormalFormRewriter rewriter(form);
+        return rewriter.normalize(*ExpressionParser::parse(expr), steps);
+    }
+
+    // Replays a proof, checking that every step is one application of its law
+    void expectValidProof(const std::string& start, const std::string& target, const Proof& proof) {
+        EquivalenceEngine engine;
+        std::unique_ptr<ASTNode> previous = ExpressionParser::parse(start);
+        for (const auto& step : proof.steps) {
+            bool reversed = step.description.find("(reversed)") != std::string::npos;
+            const ASTNode& from = reversed ? *step.expression : *previous;
+            const ASTNode& to = reversed ? *previous : *step.expression;
+
+            bool justified = false;
+            for (const auto& transformation : engine.applyLawRecursively(from, step.law_applied)) {
+                if (transformation.result->toString() == to.toString()) {
+                    justified = true;
+                    break;
+                }
+            }
+            EXPECT_TRUE(justified) << previous->toString() << " => " << step.expression->toString();
+            previous = step.expression->clone();
+        }
+        EXPECT_EQ(previous->toString(), ExpressionParser::parse(target)->toString());
+    }
+};
+
+TEST_F(NormalFormTest, NegationNormalForm) {
+    std::vector<ProofStep> steps;
+    auto result = normalize("!(p -> (q | !r))", NormalForm::NEGATION, steps);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->toString(), "(p & (!q & r))");
+    EXPECT_FALSE(steps.empty());
+    EXPECT_EQ(steps.back().expression->toString(), result->toString());
+}
+
+TEST_F(NormalFormTest, ConjunctiveNormalForm) {
+    std::vector<ProofStep> steps;
+    auto result = normalize("(p & q) | r", NormalForm::CONJUNCTIVE, steps);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->toString(), "((p | r) & (q | r))");
+    EXPECT_TRUE(TruthTable::areEquivalent(*result, *ExpressionParser::parse("(p & q) | r")));
+}
+
+TEST_F(NormalFormTest, DisjunctiveNormalForm) {
+    std::vector<ProofStep> steps;
+    auto result = normalize("(p | q) & !p", NormalForm::DISJUNCTIVE, steps);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->toString(), "(!p & q)");
+}
+
+TEST_F(NormalFormTest, CollapsesTautologiesAndDuplicates) {
+    std::vector<ProofStep> steps;
+    EXPECT_EQ(normalize("(p | !p) & (q | q)", NormalForm::CONJUNCTIVE, steps)->toString(), "q");
+    EXPECT_EQ(normalize("p & !p", NormalForm::DISJUNCTIVE, steps)->toString(), "F");
+}
+
+TEST_F(NormalFormTest, ProvesByMeetingNormalForms) {
+    std::string start = "(a -> b) & (c -> d)";
+    std::string target = "(d | !c) & (!a | b)";
+    NormalFormRewriter rewriter;
+    Proof proof = rewriter.proveEquivalence(*ExpressionParser::parse(start), *ExpressionParser::parse(target));
+    ASSERT_TRUE(proof.found_target);
+    EXPECT_EQ(proof.total_steps, static_cast<int>(proof.steps.size()));
+    expectValidProof(start, target, proof);
+}
+
+TEST_F(NormalFormTest, DifferentNormalFormsGiveNoProof) {
+    NormalFormRewriter rewriter;
+    Proof proof = rewriter.proveEquivalence(*ExpressionParser::parse("p & q"), *ExpressionParser::parse("p | q"));
+    EXPECT_FALSE(proof.found_target);
+}
+
+TEST_F(NormalFormTest, StepLimit) {
+    NormalFormRewriter rewriter(NormalForm::CONJUNCTIVE, 5);
+    std::vector<ProofStep> steps;
+    EXPECT_FALSE(rewriter.normalize(*ExpressionParser::parse("(a & b) | (c & d) | (e & f)"), steps));
+}
+
+TEST_F(NormalFormTest, ProofSearchFallsBackBeyondDepth) {
+    ProofSearch search(2, 2000);
+    std::string start = "(a <-> b) & c";
+    std::string target = "(c & (!a | b)) & (!b | a)";
+    Proof proof = search.findProof(*ExpressionParser::parse(start), *ExpressionParser::parse(target));
+    ASSERT_TRUE(proof.found_target);
+    expectValidProof(start, target, proof);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "proof_optimizer.h"
+#include "normal_form.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+class ProofOptimizerTest : public ::testing::Test {
+protected:
+    ProofOptimizer optimizer;
+
+    static Proof makeProof(const std::vector<std::pair<std::string, LogicLaw>>& chain) {
+        Proof proof;
+        for (const auto& [expr, law] : chain) {
+            proof.steps.emplace_back(ExpressionParser::parse(expr), law, LogicLaws::getLawName(law),
+                                     static_cast<int>(proof.steps.size()) + 1);
+        }
+        proof.found_target = true;
+        proof.total_steps = static_cast<int>(proof.steps.size());
+        return proof;
+    }
+
+    static void expectChained(const std::string& start, const Proof& proof) {
+        EquivalenceEngine engine;
+        auto previous = ExpressionParser::parse(start);
+        for (const auto& step : proof.steps) {
+            bool justified = false;
+            for (const auto& transformation : engine.generateSingleStepTransformations(*previous)) {
+                justified = justified || transformation.result->toString() == step.expression->toString();
+            }
+            bool reversed = false;
+            for (const auto& transformation : engine.generateSingleStepTransformations(*step.expression)) {
+                reversed = reversed || transformation.result->toString() == previous->toString();
+            }
+            EXPECT_TRUE(justified || reversed) << previous->toString() << " => " << step.expression->toString();
+            previous = step.expression->clone();
+        }
+    }
+};
+
+TEST_F(ProofOptimizerTest, RemovesDetour) {
+    auto start = ExpressionParser::parse("p & q");
+    Proof proof = makeProof({
+        {"q & p", LogicLaw::COMMUTATIVE_AND},
+        {"!!(q & p)", LogicLaw::DOUBLE_NEGATION},
+        {"q & p", LogicLaw::DOUBLE_NEGATION},
+        {"p & q", LogicLaw::COMMUTATIVE_AND},
+        {"!!p & q", LogicLaw::DOUBLE_NEGATION}
+    });
+
+    Proof optimized = optimizer.optimize(*start, proof);
+    ASSERT_TRUE(optimized.found_target);
+    ASSERT_EQ(optimized.total_steps, 1);
+    EXPECT_EQ(optimized.steps[0].expression->toString(), "(!!p & q)");
+    EXPECT_EQ(optimized.steps[0].step_number, 1);
+}
+
+TEST_F(ProofOptimizerTest, KeepsOptimalProof) {
+    auto start = ExpressionParser::parse("!(p & q)");
+    Proof proof = makeProof({{"!p | !q", LogicLaw::DE_MORGAN_AND}});
+    Proof optimized = optimizer.optimize(*start, proof);
+    EXPECT_EQ(optimized.total_steps, 1);
+    EXPECT_EQ(optimized.steps[0].law_applied, LogicLaw::DE_MORGAN_AND);
+}
+
+TEST_F(ProofOptimizerTest, ShortensNormalFormProof) {
+    std::string start = "(a -> b) & (c -> d)";
+    std::string target = "(d | !c) & (!a | b)";
+    NormalFormRewriter rewriter;
+    Proof proof = rewriter.proveEquivalence(*ExpressionParser::parse(start), *ExpressionParser::parse(target));
+    ASSERT_TRUE(proof.found_target);
+
+    optimizer.setTimeLimit(std::chrono::milliseconds(5000));
+    Proof optimized = optimizer.optimize(*ExpressionParser::parse(start), proof);
+    ASSERT_TRUE(optimized.found_target);
+    EXPECT_LE(optimized.total_steps, proof.total_steps);
+    EXPECT_EQ(optimized.steps.back().expression->toString(), ExpressionParser::parse(target)->toString());
+    expectChained(start, optimized);
+}
+
+TEST_F(ProofOptimizerTest, ZeroBudgetLeavesProofUnchanged) {
+    auto start = ExpressionParser::parse("p");
+    Proof proof = makeProof({{"!!p", LogicLaw::DOUBLE_NEGATION}, {"p", LogicLaw::DOUBLE_NEGATION}});
+    optimizer.setTimeLimit(std::chrono::milliseconds(0));
+    Proof optimized = optimizer.optimize(*start, proof);
+    EXPECT_EQ(optimized.total_steps, 2);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "proof_search.h"
 #include "parser.h"
 #include "equivalence_engine.h"
+#include <set>
 
 namespace logixpr {
 namespace test {
@@ -74,6 +75,19 @@ TEST_F(ProofSearchTest, NoProofExists) {
     auto expr2 = ExpressionParser::parse("p | q");
     auto proof = proofSearch.findProof(*expr1, *expr2);
     ASSERT_FALSE(proof.found_target);
+    EXPECT_TRUE(proof.refuted);
+}
+
+TEST_F(ProofSearchTest, ConstantsAreRefutedWithoutAssignment) {
+    auto proof = proofSearch.findProof(*ExpressionParser::parse("T"), *ExpressionParser::parse("F"));
+    EXPECT_FALSE(proof.found_target);
+    EXPECT_TRUE(proof.refuted);
+    EXPECT_TRUE(proof.counterexample.empty());
+    EXPECT_EQ(ProofFormatter::formatProof(proof), "Expressions are not equivalent.\n");
+
+    auto result = proofSearch.findProofPortfolio(*ExpressionParser::parse("T"), *ExpressionParser::parse("F"));
+    EXPECT_TRUE(result.proof.refuted);
+    EXPECT_EQ(result.winner, SearchStrategy::BREADTH_FIRST);
 }
 
 TEST_F(ProofSearchTest, ShortestProof) {
@@ -84,5 +98,236 @@ TEST_F(ProofSearchTest, ShortestProof) {
     EXPECT_EQ(proof.steps.size(), 1);
 }
 
+TEST_F(ProofSearchTest, AsyncProofsShareExecutor) {
+    proofSearch.setExecutor(std::make_shared<ThreadPool>(2, 4));
+    auto expr1 = ExpressionParser::parse("p -> q");
+    auto expr2 = ExpressionParser::parse("!p | q");
+
+    std::vector<std::future<Proof>> futures;
+    for (int i = 0; i < 16; ++i) {
+        futures.push_back(proofSearch.findProofAsync(*expr1, *expr2));
+    }
+    for (auto& future : futures) {
+        Proof proof = future.get();
+        ASSERT_TRUE(proof.found_target);
+        EXPECT_EQ(proof.steps.size(), 1);
+    }
+
+    std::promise<int> steps;
+    proofSearch.findProofAsync(*expr1, *expr2, [&steps](Proof proof) { steps.set_value(proof.total_steps); });
+    EXPECT_EQ(steps.get_future().get(), 1);
+
+    auto forms = proofSearch.generateEquivalentFormsAsync(*expr1, 2).get();
+    EXPECT_FALSE(forms.empty());
+}
+
+TEST_F(ProofSearchTest, CancelledSearchStopsEarly) {
+    auto expr1 = ExpressionParser::parse("p -> q");
+    auto expr2 = ExpressionParser::parse("!p | q");
+    CancellationToken token;
+    token.cancel();
+
+    EXPECT_FALSE(proofSearch.findProofAsync(*expr1, *expr2, token).get().found_target);
+    EXPECT_TRUE(proofSearch.generateEquivalentFormsAsync(*expr1, 3, token).get().empty());
+
+    proofSearch.setCancellationToken(token);
+    EXPECT_FALSE(proofSearch.findProof(*expr1, *expr2).found_target);
+}
+
+TEST_F(ProofSearchTest, BestFirstFindsProof) {
+    auto expr1 = ExpressionParser::parse("!(p & q) -> r");
+    auto expr2 = ExpressionParser::parse("(p & q) | r");
+    auto proof = proofSearch.findBestFirstProof(*expr1, *expr2);
+    ASSERT_TRUE(proof.found_target);
+    EXPECT_EQ(proof.total_steps, static_cast<int>(proof.steps.size()));
+}
+
+TEST_F(ProofSearchTest, PortfolioReportsWinner) {
+    auto expr1 = ExpressionParser::parse("p -> q");
+    auto expr2 = ExpressionParser::parse("!p | q");
+    
+    auto result = proofSearch.findProofPortfolio(*expr1, *expr2);
+    ASSERT_TRUE(result.proof.found_target);
+    EXPECT_EQ(result.proof.steps.size(), 1);
+    
+    auto single = proofSearch.findProofPortfolio(*expr1, *expr2, {SearchStrategy::EQUALITY_SATURATION});
+    ASSERT_TRUE(single.proof.found_target);
+    EXPECT_EQ(single.winner, SearchStrategy::EQUALITY_SATURATION);
+    EXPECT_EQ(ProofSearch::getStrategyName(single.winner), "Equality Saturation");
+}
+
+TEST_F(ProofSearchTest, PortfolioStopsOnCounterexample) {
+    auto expr1 = ExpressionParser::parse("p & q");
+    auto expr2 = ExpressionParser::parse("p | q");
+    auto result = proofSearch.findProofPortfolio(*expr1, *expr2);
+    EXPECT_FALSE(result.proof.found_target);
+    EXPECT_TRUE(result.proof.refuted);
+    EXPECT_FALSE(result.proof.counterexample.empty());
+    EXPECT_EQ(result.winner, SearchStrategy::BREADTH_FIRST);
+}
+
+TEST_F(ProofSearchTest, PortfolioPrefersShorterProofWithinGraceWindow) {
+    auto expr1 = ExpressionParser::parse("(a -> b) & !!(c -> d)");
+    auto expr2 = ExpressionParser::parse("(!c | d) & (!a | b)");
+    auto shortest = proofSearch.findShortestProof(*expr1, *expr2);
+    ASSERT_TRUE(shortest.found_target);
+    
+    proofSearch.setGraceWindow(std::chrono::milliseconds(5000));
+    auto result = proofSearch.findProofPortfolio(*expr1, *expr2);
+    ASSERT_TRUE(result.proof.found_target);
+    EXPECT_EQ(result.proof.steps.size(), shortest.steps.size());
+}
+
+TEST_F(ProofSearchTest, EnumerationStreamsDistinctForms) {
+    auto expr = ExpressionParser::parse("(p -> q) & (r | !s)");
+    EnumerationLimits limits;
+    limits.max_depth = 3;
+
+    std::vector<std::string> sequential;
+    std::size_t count = proofSearch.enumerateEquivalentForms(*expr, limits, [&](const ASTNode& form, int depth) {
+        EXPECT_LE(depth, 3);
+        sequential.push_back(form.toString());
+        return true;
+    });
+    ASSERT_EQ(count, sequential.size());
+    EXPECT_GT(count, 50u);
+    EXPECT_EQ(sequential.front(), expr->toString());
+    EXPECT_EQ(std::set<std::string>(sequential.begin(), sequential.end()).size(), sequential.size());
+
+    // The vector API is the same stream, truncated
+    auto forms = proofSearch.generateEquivalentForms(*expr, 3);
+    ASSERT_EQ(forms.size(), 50u);
+    for (std::size_t i = 0; i < forms.size(); ++i) {
+        EXPECT_EQ(forms[i]->toString(), sequential[i]);
+    }
+
+    // Parallel expansion merges in order, so the stream does not change;
+    // more workers than states or executor threads are simply not used
+    limits.threads = 100000;
+    std::vector<std::string> parallel;
+    proofSearch.enumerateEquivalentForms(*expr, limits, [&](const ASTNode& form, int) {
+        parallel.push_back(form.toString());
+        return true;
+    });
+    EXPECT_EQ(parallel, sequential);
+}
+
+TEST_F(ProofSearchTest, EnumerationRespectsLimits) {
+    auto expr = ExpressionParser::parse("(p -> q) & (r | !s)");
+    EnumerationLimits limits;
+    limits.max_forms = 7;
+    EXPECT_EQ(proofSearch.enumerateEquivalentForms(*expr, limits, [](const ASTNode&, int) { return true; }), 7u);
+
+    limits.max_forms = 0;
+    limits.max_size = expr->getSize();
+    proofSearch.enumerateEquivalentForms(*expr, limits, [&](const ASTNode& form, int) {
+        EXPECT_LE(form.getSize(), expr->getSize());
+        return true;
+    });
+
+    limits.max_size = 0;
+    int seen = 0;
+    EXPECT_EQ(proofSearch.enumerateEquivalentForms(*expr, limits, [&](const ASTNode&, int) { return ++seen < 3; }), 3u);
+}
+
+TEST_F(ProofSearchTest, MultiTargetSearchMatchesSingleSearches) {
+    auto start = ExpressionParser::parse("!(p & q) -> r");
+    std::vector<std::unique_ptr<ASTNode>> targets;
+    for (const char* text : {"(p & q) | r", "!!(p & q) | r", "(p & q) | r", "(p | r) & (q | r)", "p | r"}) {
+        targets.push_back(ExpressionParser::parse(text));
+    }
+    std::vector<const ASTNode*> target_pointers;
+    for (const auto& target : targets) {
+        target_pointers.push_back(target.get());
+    }
+    
+    auto proofs = proofSearch.findProofs(*start, target_pointers);
+    ASSERT_EQ(proofs.size(), targets.size());
+    for (std::size_t i = 0; i + 1 < targets.size(); ++i) {
+        ASSERT_TRUE(proofs[i].found_target) << targets[i]->toString();
+        EXPECT_TRUE(proofs[i].steps.back().expression->equals(*targets[i]));
+        Proof single = proofSearch.findShortestProof(*start, *targets[i]);
+        EXPECT_EQ(proofs[i].steps.size(), single.steps.size()) << targets[i]->toString();
+    }
+    
+    // Inequivalent targets are refuted up front and do not hold the search open
+    EXPECT_FALSE(proofs.back().found_target);
+    EXPECT_FALSE(proofs.back().counterexample.empty());
+}
+
+TEST_F(ProofSearchTest, RetainedGraphResumesFromSameStart) {
+    auto start = ExpressionParser::parse("!(p & q) -> (r <-> p)");
+    std::vector<std::unique_ptr<ASTNode>> targets;
+    for (const char* text : {"(p & q) | ((r -> p) & (p -> r))", "!!(p & q) | (r <-> p)",
+                             "(p & q) | ((!r | p) & (p -> r))", "!(p & q) -> (r <-> p)"}) {
+        targets.push_back(ExpressionParser::parse(text));
+    }
+    
+    ProofSearch fresh;
+    fresh.setResultCache(nullptr);
+    proofSearch.setResultCache(nullptr);
+    proofSearch.setRetainedGraphLimit(64 << 20);
+    auto retention = proofSearch.getSearchRetention();
+    
+    std::size_t retained_states = 0;
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        Proof expected = fresh.findShortestProof(*start, *targets[i]);
+        Proof proof = proofSearch.findShortestProof(*start, *targets[i]);
+        ASSERT_TRUE(expected.found_target) << targets[i]->toString();
+        ASSERT_EQ(proof.found_target, expected.found_target) << targets[i]->toString();
+        ASSERT_EQ(proof.steps.size(), expected.steps.size()) << targets[i]->toString();
+        for (std::size_t step = 0; step < proof.steps.size(); ++step) {
+            EXPECT_TRUE(proof.steps[step].expression->equals(*expected.steps[step].expression));
+        }
+        
+        // The second target lies in layers the first query already dequeued
+        if (i == 1) {
+            EXPECT_EQ(retention->statesRetained(), retained_states);
+        }
+        retained_states = retention->statesRetained();
+    }
+    EXPECT_EQ(retention->size(), 1u);
+    EXPECT_GT(retention->bytesUsed(), 0u);
+    
+    // A limit too small for any search retains nothing
+    proofSearch.setRetainedGraphLimit(1);
+    EXPECT_TRUE(proofSearch.findShortestProof(*start, *targets[0]).found_target);
+    EXPECT_EQ(proofSearch.getSearchRetention()->size(), 0u);
+}
+
+TEST_F(ProofSearchTest, RetainedGraphFollowsChangedSettings) {
+    auto start = ExpressionParser::parse("!(p & q) -> (r <-> p)");
+    auto warm_up = ExpressionParser::parse("(p & q) | ((!r | p) & (!p | r))");
+    auto target = ExpressionParser::parse("(p & q) | ((!r | p) & (p -> r))");
+    
+    ProofSearch fresh;
+    proofSearch.setRetainedGraphLimit(64 << 20);
+    proofSearch.findShortestProof(*start, *warm_up);
+    
+    // A smaller budget must not reach what the warm-up query explored
+    for (int budget : {30, 10000}) {
+        fresh.setMaxTransformations(budget);
+        proofSearch.setMaxTransformations(budget);
+        Proof expected = fresh.findShortestProof(*start, *target);
+        Proof proof = proofSearch.findShortestProof(*start, *target);
+        EXPECT_EQ(proof.found_target, expected.found_target) << budget;
+        EXPECT_EQ(proof.steps.size(), expected.steps.size()) << budget;
+    }
+    
+    // A profile reorders successors, so it gets searches of its own
+    auto profile = std::make_shared<LawProfile>();
+    profile->recordStep(NodeType::OR, 1, LogicLaw::IMPLICATION_ELIMINATION);
+    fresh.setLawProfile(profile);
+    proofSearch.setLawProfile(profile);
+    std::size_t entries = proofSearch.getSearchRetention()->size();
+    Proof expected = fresh.findShortestProof(*start, *target);
+    Proof proof = proofSearch.findShortestProof(*start, *target);
+    EXPECT_EQ(proofSearch.getSearchRetention()->size(), entries + 1);
+    ASSERT_EQ(proof.steps.size(), expected.steps.size());
+    for (std::size_t step = 0; step < proof.steps.size(); ++step) {
+        EXPECT_TRUE(proof.steps[step].expression->equals(*expected.steps[step].expression));
+    }
+}
+
 } // namespace test
 } // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "sat_solver.h"
+#include "evaluator.h"
+#include "parser.h"
+#include "proof_search.h"
+
+namespace logixpr {
+namespace test {
+
+TEST(SatSolverTest, SatisfiableFormula) {
+    SatSolver solver;
+    int a = solver.newVariable();
+    int b = solver.newVariable();
+    solver.addClause({SatSolver::makeLiteral(a, false), SatSolver::makeLiteral(b, false)});
+    solver.addClause({SatSolver::makeLiteral(a, true)});
+    ASSERT_EQ(solver.solve(), SatResult::SATISFIABLE);
+    EXPECT_FALSE(solver.getModelValue(a));
+    EXPECT_TRUE(solver.getModelValue(b));
+}
+
+TEST(SatSolverTest, PigeonholeIsUnsatisfiable) {
+    // Five pigeons do not fit into four holes
+    const int pigeons = 5;
+    const int holes = 4;
+    SatSolver solver;
+    std::vector<std::vector<int>> in(pigeons, std::vector<int>(holes));
+    for (auto& row : in) {
+        for (auto& variable : row) {
+            variable = solver.newVariable();
+        }
+    }
+    for (int p = 0; p < pigeons; ++p) {
+        std::vector<int> clause;
+        for (int h = 0; h < holes; ++h) {
+            clause.push_back(SatSolver::makeLiteral(in[p][h], false));
+        }
+        solver.addClause(clause);
+    }
+    for (int h = 0; h < holes; ++h) {
+        for (int p = 0; p < pigeons; ++p) {
+            for (int q = p + 1; q < pigeons; ++q) {
+                solver.addClause({SatSolver::makeLiteral(in[p][h], true), SatSolver::makeLiteral(in[q][h], true)});
+            }
+        }
+    }
+    EXPECT_EQ(solver.solve(), SatResult::UNSATISFIABLE);
+}
+
+TEST(SatSolverTest, WideEquivalence) {
+    std::string conjunction = "x0";
+    std::string disjunction = "!x0";
+    for (int i = 1; i < 64; ++i) {
+        conjunction += " & x" + std::to_string(i);
+        disjunction += " | !x" + std::to_string(i);
+    }
+    auto expr1 = ExpressionParser::parse("!(" + conjunction + ")");
+    auto expr2 = ExpressionParser::parse(disjunction);
+
+    std::vector<std::pair<std::string, bool>> counterexample;
+    EXPECT_EQ(SatEquivalenceChecker::check(*expr1, *expr2, counterexample), EquivalenceVerdict::EQUIVALENT);
+}
+
+TEST(SatSolverTest, CounterexampleDistinguishesExpressions) {
+    auto expr1 = ExpressionParser::parse("(a -> b) & (b -> c)");
+    auto expr2 = ExpressionParser::parse("a -> c");
+
+    std::vector<std::pair<std::string, bool>> counterexample;
+    ASSERT_EQ(SatEquivalenceChecker::check(*expr1, *expr2, counterexample), EquivalenceVerdict::NOT_EQUIVALENT);
+
+    std::vector<std::string> order;
+    std::uint64_t assignment = 0;
+    for (std::size_t i = 0; i < counterexample.size(); ++i) {
+        order.push_back(counterexample[i].first);
+        if (counterexample[i].second) {
+            assignment |= std::uint64_t(1) << i;
+        }
+    }
+    EXPECT_NE(CompiledExpression::compile(*expr1, order).evaluate(assignment),
+              CompiledExpression::compile(*expr2, order).evaluate(assignment));
+}
+
+TEST(SatSolverTest, ProofSearchReportsCounterexample) {
+    ProofSearch search;
+    auto expr1 = ExpressionParser::parse("p & q");
+    auto expr2 = ExpressionParser::parse("p | q");
+    auto proof = search.findProof(*expr1, *expr2);
+    EXPECT_FALSE(proof.found_target);
+    EXPECT_EQ(proof.counterexample.size(), 2);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "server.h"
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace logixpr {
+namespace test {
+
+class RequestHandlerTest : public ::testing::Test {
+protected:
+    static std::vector<std::string> run(const std::string& request, ServerLimits limits = ServerLimits()) {
+        RequestHandler handler(limits);
+        std::vector<std::string> lines;
+        handler.handle(request, [&lines](const std::string& line) { lines.push_back(line); });
+        return lines;
+    }
+};
+
+TEST_F(RequestHandlerTest, ProveStreamsStepsThenStatus) {
+    auto lines = run("prove\tA -> B\t!A | B");
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].rfind("step\t1\t", 0), 0u);
+    EXPECT_NE(lines[0].find("\t(!A | B)"), std::string::npos);
+    EXPECT_EQ(lines[1], "ok\tproved\t1");
+}
+
+TEST_F(RequestHandlerTest, ProveReportsCounterexample) {
+    auto lines = run("prove\tA\tB");
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0].rfind("ok\tnot-equivalent\t", 0), 0u);
+
+    lines = run("prove\tT\tF");
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "ok\tnot-equivalent\t");
+}
+
+TEST_F(RequestHandlerTest, GenerateHonoursLimit) {
+    auto lines = run("generate\t!(A & B)\tlimit=2");
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0].rfind("form\t", 0), 0u);
+    EXPECT_EQ(lines[2], "ok\t2");
+}
+
+TEST_F(RequestHandlerTest, OptionsAreClippedToServerLimits) {
+    ServerLimits limits;
+    limits.max_generate_forms = 1;
+    auto lines = run("generate\t!(A & B)\tlimit=50", limits);
+    EXPECT_EQ(lines.back(), "ok\t1");
+}
+
+TEST_F(RequestHandlerTest, ParseAndErrors) {
+    EXPECT_EQ(run("parse\tA&B|C"), std::vector<std::string>{"ok\t((A & B) | C)"});
+    EXPECT_EQ(run("parse\tA &")[0].rfind("error\tparse error at position", 0), 0u);
+    EXPECT_EQ(run("frobnicate"), std::vector<std::string>{"error\tunknown command: frobnicate"});
+    EXPECT_EQ(run("prove\tA")[0].rfind("error\tusage:", 0), 0u);
+    EXPECT_EQ(run("prove\tA\tA\tdepth=0")[0], "error\tinvalid value for depth: 0");
+    EXPECT_EQ(run("prove\tA\tA\tcolour=red")[0], "error\tunknown option: colour=red");
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+TEST(UnixSocketServerTest, ServesPipelinedRequests) {
+    std::string path = "/tmp/logixpr_test_" + std::to_string(::getpid()) + ".sock";
+    UnixSocketServer server(path, 2);
+    std::thread loop([&server] { server.run(); });
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+    std::string requests = "parse\tA & B\nprove\tA -> B\t!A | B\nbogus\n";
+    ASSERT_EQ(::write(fd, requests.data(), requests.size()), static_cast<ssize_t>(requests.size()));
+    ::shutdown(fd, SHUT_WR);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        response.append(buffer, static_cast<std::size_t>(received));
+    }
+    ::close(fd);
+    server.stop();
+    loop.join();
+
+    EXPECT_EQ(response.rfind("ok\t(A & B)\nstep\t1\t", 0), 0u) << response;
+    EXPECT_NE(response.find("ok\tproved\t1\nerror\tunknown command: bogus\n"), std::string::npos) << response;
+}
+
+#endif
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
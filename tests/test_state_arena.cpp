@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "state_arena.h"
+#include "parser.h"
+
+namespace logixpr {
+namespace test {
+
+TEST(StateArenaTest, RoundTripsExpressions) {
+    StateArena arena;
+    for (const char* input : {"p", "T", "!F", "(a & b) -> !(c | T)", "a <-> (b -> !a)"}) {
+        auto expression = ExpressionParser::parse(input);
+        auto state = arena.store(*expression);
+        EXPECT_EQ(state.size(), expression->getSize());
+        EXPECT_EQ(arena.decode(state)->toString(), expression->toString());
+    }
+}
+
+TEST(StateArenaTest, ManyVariablesUseVarints) {
+    std::string input = "x0";
+    for (int i = 1; i < 300; ++i) {
+        input += " | x" + std::to_string(i);
+    }
+    auto expression = ExpressionParser::parse(input);
+
+    StateArena arena(64);
+    auto state = arena.store(*expression);
+    EXPECT_GT(state.size(), expression->getSize());
+    EXPECT_EQ(arena.decode(state)->toString(), expression->toString());
+}
+
+TEST(StateArenaTest, GraphDeduplicatesAndLinksParents) {
+    auto root = ExpressionParser::parse("!(a & b)");
+    SearchGraph graph(*root);
+    EXPECT_FALSE(graph.add(*root, 0, LogicLaw::DE_MORGAN_AND, "again"));
+
+    auto child = ExpressionParser::parse("!a | !b");
+    EXPECT_TRUE(graph.add(*child, 0, LogicLaw::DE_MORGAN_AND, "De Morgan"));
+    EXPECT_FALSE(graph.add(*ExpressionParser::parse("!a | !b"), 0, LogicLaw::DE_MORGAN_AND, "De Morgan"));
+    EXPECT_TRUE(graph.contains(*child));
+    // Visited keys are structural, not commutativity-aware, like the string keys they replace
+    EXPECT_FALSE(graph.contains(*ExpressionParser::parse("!b | !a")));
+
+    ASSERT_EQ(graph.size(), 2u);
+    EXPECT_EQ(graph.getRecord(1).parent, 0u);
+    EXPECT_EQ(graph.getRecord(1).depth, 1u);
+    EXPECT_EQ(graph.getDescription(1), "De Morgan");
+    EXPECT_EQ(graph.expression(1)->toString(), "(!a | !b)");
+}
+
+TEST(StateArenaTest, StatesStayCompact) {
+    auto root = ExpressionParser::parse("x");
+    SearchGraph graph(*root);
+    std::unique_ptr<ASTNode> expression = ExpressionParser::parse("(a & b) | (c -> !d)");
+    for (int i = 0; i < 10000; ++i) {
+        auto next = std::make_unique<BinaryOpNode>(NodeType::AND, expression->clone(),
+                                                   std::make_unique<VariableNode>("v" + std::to_string(i)));
+        EXPECT_TRUE(graph.add(*next, 0, LogicLaw::COMMUTATIVE_AND, "Commutative"));
+    }
+    // Each state is a 12-node tree, which as ASTNodes takes about a kilobyte
+    EXPECT_LT(graph.bytesUsed() / graph.size(), 160u);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "thread_pool.h"
+#include <atomic>
+#include <future>
+#include <vector>
+
+namespace logixpr {
+namespace test {
+
+TEST(ThreadPoolTest, RunsEveryTask) {
+    std::atomic<int> counter{0};
+    ThreadPool pool(4, 8);
+    for (int i = 0; i < 1000; ++i) {
+        pool.submit([&counter] { ++counter; });
+    }
+    pool.wait();
+    EXPECT_EQ(counter, 1000);
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_EQ(pool.pending(), 0u);
+}
+
+TEST(ThreadPoolTest, TrySubmitRefusesWhenQueueIsFull) {
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<bool> started{false};
+
+    ThreadPool pool(1, 1);
+    pool.submit([&] {
+        started = true;
+        std::lock_guard<std::mutex> wait_for_gate(gate);
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_TRUE(pool.trySubmit([] {}));
+    EXPECT_FALSE(pool.trySubmit([] {}));
+    hold.unlock();
+    pool.wait();
+    EXPECT_TRUE(pool.trySubmit([] {}));
+}
+
+TEST(ThreadPoolTest, SurvivesThrowingTasks) {
+    std::atomic<int> counter{0};
+    ThreadPool pool(1);
+    pool.submit([] { throw std::runtime_error("boom"); });
+    pool.submit([&counter] { ++counter; });
+    pool.wait();
+    EXPECT_EQ(counter, 1);
+}
+
+TEST(ThreadPoolTest, ParallelForRunsEachTaskOnce) {
+    ThreadPool pool(2);
+    std::vector<std::atomic<int>> calls(100);
+    pool.parallelFor(calls.size(), 1000, [&](std::size_t i) { ++calls[i]; });
+    for (const auto& count : calls) {
+        EXPECT_EQ(count, 1);
+    }
+
+    EXPECT_THROW(pool.parallelFor(10, 4, [](std::size_t i) {
+        if (i == 7) {
+            throw std::runtime_error("boom");
+        }
+    }), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock) {
+    // Every worker is busy in an outer task, so inner helpers never start
+    ThreadPool pool(2);
+    std::atomic<int> total{0};
+    std::vector<std::future<void>> outer;
+    for (int task = 0; task < 2; ++task) {
+        auto done = std::make_shared<std::promise<void>>();
+        outer.push_back(done->get_future());
+        pool.submit([&pool, &total, done] {
+            pool.parallelFor(50, 4, [&](std::size_t) { ++total; });
+            done->set_value();
+        });
+    }
+    for (auto& result : outer) {
+        result.get();
+    }
+    EXPECT_EQ(total, 100);
+}
+
+} // namespace test
+} // namespace logixpr
\ No newline at end of file